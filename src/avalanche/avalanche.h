@@ -43,6 +43,12 @@ static constexpr size_t AVALANCHE_DEFAULT_PEER_REPLACEMENT_COOLDOWN = 60 * 60;
  */
 static constexpr bool AVALANCHE_DEFAULT_PROOF_REPLACEMENT_ENABLED = false;
 
+/**
+ * Is the avalanche pre-consensus on the mempool transactions enabled by
+ * default.
+ */
+static constexpr bool AVALANCHE_DEFAULT_PRECONSENSUS = false;
+
 /**
  * Avalanche default cooldown in milliseconds.
  */
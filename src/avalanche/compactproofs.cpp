@@ -12,10 +12,15 @@ namespace avalanche {
 CompactProofs::CompactProofs(
     const RadixTree<const Proof, ProofRadixTreeAdapter> &proofs)
     : CompactProofs() {
+    // The tree holds the proofs, so the ids remain valid while hashing them.
+    std::vector<const uint256 *> proofids;
     proofs.forEachLeaf([&](auto pLeaf) {
-        shortproofids.push_back(getShortID(pLeaf->getId()));
+        proofids.push_back(&pLeaf->getId());
         return true;
     });
+
+    shortproofids.resize(proofids.size());
+    getShortIDs(proofids.data(), shortproofids.data(), proofids.size());
 }
 
 uint64_t CompactProofs::getShortID(const ProofId &proofid) const {
@@ -25,4 +30,13 @@ uint64_t CompactProofs::getShortID(const ProofId &proofid) const {
            0xffffffffffffL;
 }
 
+void CompactProofs::getShortIDs(const uint256 *const *proofids,
+                                uint64_t *shortids, size_t count) const {
+    SipHashUint256Batch(shortproofidk0, shortproofidk1, proofids, shortids,
+                        count);
+    for (size_t i = 0; i < count; i++) {
+        shortids[i] &= 0xffffffffffffL;
+    }
+}
+
 } // namespace avalanche
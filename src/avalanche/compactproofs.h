@@ -66,6 +66,9 @@ public:
     CompactProofs(const RadixTree<const Proof, ProofRadixTreeAdapter> &proofs);
 
     uint64_t getShortID(const ProofId &proofid) const;
+    /** Compute the short ids of count proofs at once. */
+    void getShortIDs(const uint256 *const *proofids, uint64_t *shortids,
+                     size_t count) const;
 
     size_t size() const {
         return shortproofids.size() + prefilledProofs.size();
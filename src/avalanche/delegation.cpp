@@ -6,13 +6,93 @@
 
 #include <avalanche/proof.h>
 #include <avalanche/validation.h>
+#include <crypto/sha256.h>
+#include <cuckoocache.h>
 #include <hash.h>
+#include <random.h>
+#include <script/sigcache.h>
 #include <streams.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
 
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <atomic>
+
 namespace avalanche {
 
+namespace {
+
+/**
+ * Cache of the delegation levels known to be valid, so the signatures of a
+ * delegation are not verified again when it is presented by several nodes,
+ * or when a longer delegation shares its first levels.
+ */
+class DelegationCache {
+private:
+    //! Entries are SHA256(nonce || delegation id up to the level || signature).
+    //! The id commits to the proof master and all the keys up to this level,
+    //! so to both the signer and the signed message.
+    CSHA256 m_salted_hasher;
+    CuckooCache::cache<CuckooCache::KeyOnly<uint256>, SignatureCacheHasher>
+        setValid;
+    boost::shared_mutex cs_delegationcache;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+public:
+    DelegationCache() {
+        uint256 nonce = GetRandHash();
+        // Write the nonce twice so the hasher processes a full 64 bytes chunk,
+        // see CSignatureCache.
+        m_salted_hasher.Write(nonce.begin(), 32);
+        m_salted_hasher.Write(nonce.begin(), 32);
+        setValid.setup_bytes(DELEGATION_CACHE_SIZE);
+    }
+
+    template <typename F>
+    bool verifyLevel(const uint256 &levelHash, const SchnorrSig &sig,
+                     const F &fun) {
+        uint256 entry;
+        CSHA256 hasher = m_salted_hasher;
+        hasher.Write(levelHash.begin(), 32)
+            .Write(sig.data(), sig.size())
+            .Finalize(entry.begin());
+
+        {
+            boost::shared_lock<boost::shared_mutex> lock(cs_delegationcache);
+            if (setValid.contains(entry, false)) {
+                ++hits;
+                return true;
+            }
+        }
+
+        ++misses;
+        if (!fun()) {
+            return false;
+        }
+
+        boost::unique_lock<boost::shared_mutex> lock(cs_delegationcache);
+        setValid.insert(entry);
+        return true;
+    }
+
+    DelegationCacheStats getStats() const { return {hits, misses}; }
+};
+
+DelegationCache &GetDelegationCache() {
+    static DelegationCache cache;
+    return cache;
+}
+
+} // namespace
+
+DelegationCacheStats GetDelegationCacheStats() {
+    return GetDelegationCache().getStats();
+}
+
 bool Delegation::FromHex(Delegation &dg, const std::string &dgHex,
                          bilingual_str &errorOut) {
     if (!IsHex(dgHex)) {
@@ -79,8 +159,11 @@ bool Delegation::verify(DelegationState &state, CPubKey &auth) const {
                              "too-many-levels");
     }
 
+    DelegationCache &cache = GetDelegationCache();
     bool ret = reduceLevels(hash, levels, [&](const Level &l) {
-        if (!pauth->VerifySchnorr(hash, l.sig)) {
+        if (!cache.verifyLevel(hash, l.sig, [&] {
+                return pauth->VerifySchnorr(hash, l.sig);
+            })) {
             return state.Invalid(DelegationResult::INVALID_SIGNATURE,
                                  "invalid-signature");
         }
@@ -11,6 +11,8 @@
 #include <pubkey.h>
 #include <serialize.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 struct bilingual_str;
@@ -25,9 +27,28 @@ namespace avalanche {
  */
 constexpr size_t MAX_DELEGATION_LEVELS{20};
 
+/**
+ * Size in bytes of the cache of the verified delegation levels. A 32 bytes
+ * entry is stored per level, so this is enough for about 32k levels.
+ */
+constexpr size_t DELEGATION_CACHE_SIZE{1 << 20};
+
 class DelegationState;
 class Proof;
 
+struct DelegationCacheStats {
+    /** Number of delegation levels found in the cache. */
+    uint64_t hits;
+    /** Number of delegation levels which signature had to be verified. */
+    uint64_t misses;
+};
+
+/**
+ * Get the statistics of the cache of the verified delegation levels, shared
+ * by all the delegations.
+ */
+DelegationCacheStats GetDelegationCacheStats();
+
 class Delegation {
     LimitedProofId limitedProofid;
     CPubKey proofMaster;
@@ -24,6 +24,15 @@ struct Node {
     TimePoint nextRequestTime;
     bool avaproofsSent;
 
+    /**
+     * Moving average of the time it took the node to respond to our polls. A
+     * poll that timed out is accounted for as a response received at the
+     * timeout. This is zero until the first response or timeout.
+     */
+    std::chrono::microseconds avgResponseTime{0};
+    uint32_t responseCount{0};
+    uint32_t timeoutCount{0};
+
     Node(NodeId nodeid_, PeerId peerid_)
         : nodeid(nodeid_), peerid(peerid_),
           nextRequestTime(std::chrono::steady_clock::now()),
@@ -9,10 +9,13 @@
 #include <avalanche/validation.h>
 #include <random.h>
 #include <scheduler.h>
+#include <streams.h>
+#include <util/system.h>
 #include <validation.h> // For ChainstateManager
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 namespace avalanche {
 bool PeerManager::addNode(NodeId nodeid, const ProofId &proofid) {
@@ -69,13 +72,10 @@ bool PeerManager::addNodeToPeer(const PeerSet::iterator &it) {
         }
 
         // We need to allocate this peer.
-        p.index = uint32_t(slots.size());
         const uint32_t score = p.getScore();
-        const uint64_t start = slotCount;
-        slots.emplace_back(start, score, it->peerid);
-        slotCount = start + score;
+        peerSampler.add(it->peerid, score);
 
-        // Add to our allocated score when we allocate a new peer in the slots
+        // Add to our allocated score when we allocate a new peer in the sampler
         connectedPeersScore += score;
     });
 }
@@ -127,19 +127,10 @@ bool PeerManager::removeNodeFromPeer(const PeerSet::iterator &it,
     }
 
     // There are no more nodes left, we need to clean up. Subtract allocated
-    // score and remove from slots.
-    const size_t i = it->index;
-    assert(i < slots.size());
-    assert(connectedPeersScore >= slots[i].getScore());
-    connectedPeersScore -= slots[i].getScore();
-
-    if (i + 1 == slots.size()) {
-        slots.pop_back();
-        slotCount = slots.empty() ? 0 : slots.back().getStop();
-    } else {
-        fragmentation += slots[i].getScore();
-        slots[i] = slots[i].withPeerId(NO_PEER);
-    }
+    // score and remove from the sampler.
+    assert(connectedPeersScore >= it->getScore());
+    connectedPeersScore -= it->getScore();
+    peerSampler.remove(it->peerid);
 
     return true;
 }
@@ -153,6 +144,31 @@ bool PeerManager::updateNextRequestTime(NodeId nodeid, TimePoint timeout) {
     return nodes.modify(it, [&](Node &n) { n.nextRequestTime = timeout; });
 }
 
+bool PeerManager::updateResponseTime(NodeId nodeid,
+                                     std::chrono::microseconds responseTime,
+                                     bool timedOut) {
+    auto it = nodes.find(nodeid);
+    if (it == nodes.end()) {
+        return false;
+    }
+
+    return nodes.modify(it, [&](Node &n) {
+        // The first sample is used as is, so a new node doesn't need several
+        // polls before its average is meaningful.
+        n.avgResponseTime =
+            (n.responseCount + n.timeoutCount) == 0
+                ? responseTime
+                : (RESPONSE_TIME_AVERAGE_WINDOW - 1) * n.avgResponseTime /
+                          RESPONSE_TIME_AVERAGE_WINDOW +
+                      responseTime / RESPONSE_TIME_AVERAGE_WINDOW;
+        if (timedOut) {
+            n.timeoutCount++;
+        } else {
+            n.responseCount++;
+        }
+    });
+}
+
 bool PeerManager::latchAvaproofsSent(NodeId nodeid) {
     auto it = nodes.find(nodeid);
     if (it == nodes.end()) {
@@ -450,19 +466,31 @@ NodeId PeerManager::selectNode() {
     for (int retry = 0; retry < SELECT_NODE_MAX_RETRY; retry++) {
         const PeerId p = selectPeer();
 
-        // If we cannot find a peer, it may be due to the fact that it is
-        // unlikely due to high fragmentation, so compact and retry.
+        // If we cannot find a peer, there is no peer with a node.
         if (p == NO_PEER) {
-            compact();
-            continue;
+            break;
         }
 
-        // See if that peer has an available node.
+        // See if that peer has an available node, and pick the one that
+        // responds the fastest. The nodes that never responded yet have no
+        // response time, so they get selected and measured first. The nodes
+        // with a similar response time are selected in turn.
+        const TimePoint now = std::chrono::steady_clock::now();
         auto &nview = nodes.get<next_request_time>();
         auto it = nview.lower_bound(boost::make_tuple(p, TimePoint()));
-        if (it != nview.end() && it->peerid == p &&
-            it->nextRequestTime <= std::chrono::steady_clock::now()) {
-            return it->nodeid;
+        auto best = nview.end();
+        for (; it != nview.end() && it->peerid == p &&
+               it->nextRequestTime <= now;
+             ++it) {
+            if (best == nview.end() ||
+                it->avgResponseTime / RESPONSE_TIME_RESOLUTION <
+                    best->avgResponseTime / RESPONSE_TIME_RESOLUTION) {
+                best = it;
+            }
+        }
+
+        if (best != nview.end()) {
+            return best->nodeid;
         }
     }
 
@@ -472,20 +500,103 @@ NodeId PeerManager::selectNode() {
     return NO_NODE;
 }
 
+void PeerManager::addStaleProof(const COutPoint &outpoint) {
+    for (const ProofPool *pool : {&validProofPool, &orphanProofPool}) {
+        const ProofRef proof = pool->getProof(outpoint);
+        if (proof) {
+            staleProofIds.insert(proof->getId());
+        }
+    }
+}
+
+void PeerManager::blockConnected(const CBlock &block) {
+    hasBlockChanges = true;
+
+    // The proofs staking a spent outpoint are no longer valid. The outpoints
+    // created by the block can't be staked by any of the proofs, which would
+    // have been rejected for missing their utxos.
+    for (const CTransactionRef &tx : block.vtx) {
+        if (tx->IsCoinBase()) {
+            continue;
+        }
+
+        for (const CTxIn &in : tx->vin) {
+            addStaleProof(in.prevout);
+        }
+    }
+}
+
+void PeerManager::blockDisconnected(const CBlock &block, int height) {
+    hasBlockChanges = true;
+
+    // The stakes maturity needs to be re-evaluated from the new tip height.
+    lastTipHeight = std::min<int64_t>(lastTipHeight, height - 1);
+
+    // The proofs staking an outpoint created by the block are no longer
+    // valid, as this outpoint is either gone or confirmed at another height.
+    for (const CTransactionRef &tx : block.vtx) {
+        for (uint32_t i = 0; i < tx->vout.size(); i++) {
+            addStaleProof(COutPoint(tx->GetId(), i));
+        }
+    }
+}
+
 std::unordered_set<ProofRef, SaltedProofHasher> PeerManager::updatedBlockTip() {
     std::vector<ProofId> invalidProofIds;
     std::vector<ProofRef> newOrphans;
 
+    // Without knowing which blocks changed, all the proofs are re-evaluated.
+    const bool fullRescan = lastTipHeight < 0 || !hasBlockChanges;
+
+    // A stake is mature if its height is at most the tip height minus the
+    // required confirmations plus one.
+    const int64_t stakeUtxoMinConfirmations =
+        gArgs.GetArg("-avaproofstakeutxoconfirmations",
+                     AVALANCHE_DEFAULT_STAKE_UTXO_CONFIRMATIONS);
+    auto getProofsWithStakeHeight = [](const ProofPool &pool,
+                                       int64_t minHeight, int64_t maxHeight) {
+        minHeight = std::max<int64_t>(minHeight, 0);
+        maxHeight = std::min<int64_t>(maxHeight,
+                                      std::numeric_limits<uint32_t>::max());
+        return maxHeight < minHeight
+                   ? std::unordered_set<ProofRef, SaltedProofHasher>()
+                   : pool.getProofsWithStakeHeight(minHeight, maxHeight);
+    };
+
+    const int64_t previousTipHeight = lastTipHeight;
     {
         LOCK(cs_main);
 
-        for (const auto &p : peers) {
+        lastTipHeight = chainman.ActiveHeight();
+
+        auto checkProof = [&](const ProofRef &proof) {
             ProofValidationState state;
-            if (!p.proof->verify(state, chainman)) {
+            if (!proof->verify(state, chainman)) {
                 if (isOrphanState(state)) {
-                    newOrphans.push_back(p.proof);
+                    newOrphans.push_back(proof);
+                }
+                invalidProofIds.push_back(proof->getId());
+            }
+        };
+
+        if (fullRescan) {
+            for (const auto &p : peers) {
+                checkProof(p.proof);
+            }
+        } else {
+            // The peers with a stake that is no longer mature after a reorg.
+            auto proofsToCheck = getProofsWithStakeHeight(
+                validProofPool, lastTipHeight - stakeUtxoMinConfirmations + 2,
+                std::numeric_limits<uint32_t>::max());
+
+            for (const ProofId &proofid : staleProofIds) {
+                if (const ProofRef proof = validProofPool.getProof(proofid)) {
+                    proofsToCheck.insert(proof);
                 }
-                invalidProofIds.push_back(p.getProofId());
+            }
+
+            for (const ProofRef &proof : proofsToCheck) {
+                checkProof(proof);
             }
         }
     }
@@ -497,7 +608,35 @@ std::unordered_set<ProofRef, SaltedProofHasher> PeerManager::updatedBlockTip() {
         rejectProof(invalidProofId, RejectionMode::INVALIDATE);
     }
 
-    auto registeredProofs = orphanProofPool.rescan(*this);
+    auto rescanOrphans = [&]() {
+        if (fullRescan) {
+            return orphanProofPool.rescan(*this);
+        }
+
+        // The orphans with a stake that matured since the last update, or
+        // affected by the blocks.
+        auto orphansToRescan = getProofsWithStakeHeight(
+            orphanProofPool,
+            previousTipHeight - stakeUtxoMinConfirmations + 2,
+            lastTipHeight - stakeUtxoMinConfirmations + 1);
+        for (const ProofId &proofid : staleProofIds) {
+            if (const ProofRef proof = orphanProofPool.getProof(proofid)) {
+                orphansToRescan.insert(proof);
+            }
+        }
+
+        for (const ProofRef &proof : orphansToRescan) {
+            orphanProofPool.removeProof(proof->getId());
+            registerProof(proof);
+        }
+
+        return orphansToRescan;
+    };
+
+    auto registeredProofs = rescanOrphans();
+
+    staleProofIds.clear();
+    hasBlockChanges = false;
 
     for (auto &p : newOrphans) {
         orphanProofPool.addProofIfPreferred(p);
@@ -506,6 +645,174 @@ std::unordered_set<ProofRef, SaltedProofHasher> PeerManager::updatedBlockTip() {
     return registeredProofs;
 }
 
+bool PeerManager::dumpPeersToFile(const fs::path &dumpPath) const {
+    int64_t start = GetTimeMillis();
+
+    const fs::path tmpPath = dumpPath + ".new";
+    try {
+        FILE *filestr = fsbridge::fopen(tmpPath, "wb");
+        if (!filestr) {
+            return false;
+        }
+
+        CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+        file << AVALANCHE_PEERS_DUMP_VERSION;
+        // The proof serialization depends on the format in use.
+        file << Proof::useLegacy();
+
+        file << uint64_t(peers.size());
+        for (const Peer &peer : peers) {
+            file << *peer.proof;
+            file << peer.hasFinalized;
+            file << int64_t(count_seconds(peer.nextPossibleConflictTime));
+        }
+
+        const auto dumpPool = [&](const ProofPool &pool) {
+            std::vector<ProofRef> proofs;
+            pool.forEachProof(
+                [&](const ProofRef &proof) { proofs.push_back(proof); });
+
+            file << uint64_t(proofs.size());
+            for (const ProofRef &proof : proofs) {
+                file << *proof;
+            }
+        };
+        dumpPool(conflictingProofPool);
+        dumpPool(orphanProofPool);
+
+        if (!FileCommit(file.Get())) {
+            throw std::runtime_error("FileCommit failed");
+        }
+        file.fclose();
+        if (!RenameOver(tmpPath, dumpPath)) {
+            throw std::runtime_error("Rename failed");
+        }
+    } catch (const std::exception &e) {
+        LogPrintf("Failed to dump the avalanche peers: %s.\n", e.what());
+        return false;
+    }
+
+    LogPrintf("Dumped %d avalanche peers to disk in %dms\n", peers.size(),
+              GetTimeMillis() - start);
+    return true;
+}
+
+bool PeerManager::loadPeersFromFile(
+    const fs::path &dumpPath,
+    std::unordered_set<ProofRef, SaltedProofHasher> &registeredProofs) {
+    int64_t start = GetTimeMillis();
+    registeredProofs.clear();
+
+    FILE *filestr = fsbridge::fopen(dumpPath, "rb");
+    CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        LogPrintf("Failed to open avalanche peers file from disk. Continuing "
+                  "anyway.\n");
+        return false;
+    }
+
+    struct PeerEntry {
+        ProofRef proof;
+        bool hasFinalized;
+        std::chrono::seconds nextPossibleConflictTime;
+    };
+    std::vector<PeerEntry> peerEntries;
+    std::vector<ProofRef> otherProofs;
+
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != AVALANCHE_PEERS_DUMP_VERSION) {
+            LogPrintf("Unsupported avalanche peers file version %d. "
+                      "Continuing anyway.\n",
+                      version);
+            return false;
+        }
+
+        bool legacy;
+        file >> legacy;
+        if (legacy != Proof::useLegacy()) {
+            LogPrintf("The avalanche peers file uses another proof format. "
+                      "Continuing anyway.\n");
+            return false;
+        }
+
+        const auto readProof = [&]() {
+            auto proof = RCUPtr<Proof>::make();
+            file >> *proof;
+            return ProofRef(proof);
+        };
+
+        uint64_t numPeers;
+        file >> numPeers;
+        while (numPeers--) {
+            ProofRef proof = readProof();
+            bool hasFinalized;
+            int64_t nextPossibleConflictTime;
+            file >> hasFinalized;
+            file >> nextPossibleConflictTime;
+            peerEntries.push_back(
+                {std::move(proof), hasFinalized,
+                 std::chrono::seconds{nextPossibleConflictTime}});
+        }
+
+        // Conflicting then orphan proofs.
+        for (int pool = 0; pool < 2; pool++) {
+            uint64_t numProofs;
+            file >> numProofs;
+            while (numProofs--) {
+                otherProofs.push_back(readProof());
+            }
+        }
+    } catch (const std::exception &e) {
+        LogPrintf("Failed to deserialize avalanche peers file: %s. Continuing "
+                  "anyway.\n",
+                  e.what());
+        return false;
+    }
+
+    // Verify the signatures of all the proofs at once, so registering them
+    // only needs to check them against the UTXO set.
+    std::vector<ProofRef> allProofs;
+    allProofs.reserve(peerEntries.size() + otherProofs.size());
+    for (const PeerEntry &entry : peerEntries) {
+        allProofs.push_back(entry.proof);
+    }
+    allProofs.insert(allProofs.end(), otherProofs.begin(), otherProofs.end());
+    VerifyProofSignatures(allProofs);
+
+    // Register the peers first, so the other proofs end up in the same pools
+    // as before if nothing changed.
+    for (const PeerEntry &entry : peerEntries) {
+        if (registerProof(entry.proof)) {
+            registeredProofs.insert(entry.proof);
+        }
+    }
+
+    for (const ProofRef &proof : otherProofs) {
+        if (registerProof(proof)) {
+            registeredProofs.insert(proof);
+        }
+    }
+
+    // Restore the peers state last, so the conflict cooldown doesn't prevent
+    // the conflicting proofs we already knew about from being registered.
+    for (const PeerEntry &entry : peerEntries) {
+        forPeer(entry.proof->getId(), [&](const Peer &peer) {
+            if (entry.hasFinalized) {
+                setFinalized(peer.peerid);
+            }
+            updateNextPossibleConflictTime(peer.peerid,
+                                           entry.nextPossibleConflictTime);
+            return true;
+        });
+    }
+
+    LogPrintf("Loaded %d avalanche peers out of %d proofs from disk in %dms\n",
+              peers.size(), allProofs.size(), GetTimeMillis() - start);
+    return true;
+}
+
 ProofRef PeerManager::getProof(const ProofId &proofid) const {
     ProofRef proof;
 
@@ -579,88 +886,23 @@ bool PeerManager::removePeer(const PeerId peerid) {
 }
 
 PeerId PeerManager::selectPeer() const {
-    if (slots.empty() || slotCount == 0) {
-        return NO_PEER;
-    }
-
-    const uint64_t max = slotCount;
-    for (int retry = 0; retry < SELECT_PEER_MAX_RETRY; retry++) {
-        size_t i = selectPeerImpl(slots, GetRand(max), max);
-        if (i != NO_PEER) {
-            return i;
-        }
-    }
-
-    return NO_PEER;
-}
-
-uint64_t PeerManager::compact() {
-    // There is nothing to compact.
-    if (fragmentation == 0) {
-        return 0;
-    }
-
-    std::vector<Slot> newslots;
-    newslots.reserve(peers.size());
-
-    uint64_t prevStop = 0;
-    uint32_t i = 0;
-    for (auto it = peers.begin(); it != peers.end(); it++) {
-        if (it->node_count == 0) {
-            continue;
-        }
-
-        newslots.emplace_back(prevStop, it->getScore(), it->peerid);
-        prevStop = slots[i].getStop();
-        if (!peers.modify(it, [&](Peer &p) { p.index = i++; })) {
-            return 0;
-        }
-    }
-
-    slots = std::move(newslots);
-
-    const uint64_t saved = slotCount - prevStop;
-    slotCount = prevStop;
-    fragmentation = 0;
-
-    return saved;
+    FastRandomContext rng;
+    return peerSampler.select(rng);
 }
 
 bool PeerManager::verify() const {
-    uint64_t prevStop = 0;
-    uint32_t scoreFromSlots = 0;
-    for (size_t i = 0; i < slots.size(); i++) {
-        const Slot &s = slots[i];
-
-        // Slots must be in correct order.
-        if (s.getStart() < prevStop) {
-            return false;
-        }
-
-        prevStop = s.getStop();
-
-        // If this is a dead slot, then nothing more needs to be checked.
-        if (s.getPeerId() == NO_PEER) {
-            continue;
-        }
-
-        // We have a live slot, verify index.
-        auto it = peers.find(s.getPeerId());
-        if (it == peers.end() || it->index != i) {
-            return false;
-        }
-
-        // Accumulate score across slots
-        scoreFromSlots += slots[i].getScore();
+    if (!peerSampler.verify()) {
+        return false;
     }
 
-    // Score across slots must be the same as our allocated score
-    if (scoreFromSlots != connectedPeersScore) {
+    // Score across the sampler must be the same as our allocated score
+    if (peerSampler.getTotalScore() != connectedPeersScore) {
         return false;
     }
 
     uint32_t scoreFromAllPeers = 0;
     uint32_t scoreFromPeersWithNodes = 0;
+    size_t peersWithNodes = 0;
 
     std::unordered_set<COutPoint, SaltedOutpointHasher> peersUtxos;
     for (const auto &p : peers) {
@@ -718,13 +960,9 @@ bool PeerManager::verify() const {
         }
 
         scoreFromPeersWithNodes += p.getScore();
-        // The index must point to a slot refering to this peer.
-        if (p.index >= slots.size() || slots[p.index].getPeerId() != p.peerid) {
-            return false;
-        }
-
-        // If the score do not match, same thing.
-        if (slots[p.index].getScore() != p.getScore()) {
+        peersWithNodes++;
+        // The peer must be selectable.
+        if (!peerSampler.contains(p.peerid)) {
             return false;
         }
 
@@ -742,6 +980,11 @@ bool PeerManager::verify() const {
         return false;
     }
 
+    // Only the peers with nodes can be selected.
+    if (peersWithNodes != peerSampler.size()) {
+        return false;
+    }
+
     // We checked the utxo consistency for all our peers utxos already, so if
     // the pool size differs from the expected one there are dangling utxos.
     if (validProofPool.size() != peersUtxos.size()) {
@@ -754,63 +997,6 @@ bool PeerManager::verify() const {
     });
 }
 
-PeerId selectPeerImpl(const std::vector<Slot> &slots, const uint64_t slot,
-                      const uint64_t max) {
-    assert(slot <= max);
-
-    size_t begin = 0, end = slots.size();
-    uint64_t bottom = 0, top = max;
-
-    // Try to find the slot using dichotomic search.
-    while ((end - begin) > 8) {
-        // The slot we picked in not allocated.
-        if (slot < bottom || slot >= top) {
-            return NO_PEER;
-        }
-
-        // Guesstimate the position of the slot.
-        size_t i = begin + ((slot - bottom) * (end - begin) / (top - bottom));
-        assert(begin <= i && i < end);
-
-        // We have a match.
-        if (slots[i].contains(slot)) {
-            return slots[i].getPeerId();
-        }
-
-        // We undershooted.
-        if (slots[i].precedes(slot)) {
-            begin = i + 1;
-            if (begin >= end) {
-                return NO_PEER;
-            }
-
-            bottom = slots[begin].getStart();
-            continue;
-        }
-
-        // We overshooted.
-        if (slots[i].follows(slot)) {
-            end = i;
-            top = slots[end].getStart();
-            continue;
-        }
-
-        // We have an unalocated slot.
-        return NO_PEER;
-    }
-
-    // Enough of that nonsense, let fallback to linear search.
-    for (size_t i = begin; i < end; i++) {
-        // We have a match.
-        if (slots[i].contains(slot)) {
-            return slots[i].getPeerId();
-        }
-    }
-
-    // We failed to find a slot, retry.
-    return NO_PEER;
-}
-
 void PeerManager::addUnbroadcastProof(const ProofId &proofid) {
     // The proof should be bound to a peer
     if (isBoundToPeer(proofid)) {
@@ -6,12 +6,14 @@
 #define BITCOIN_AVALANCHE_PEERMANAGER_H
 
 #include <avalanche/node.h>
+#include <avalanche/peersampler.h>
 #include <avalanche/proof.h>
 #include <avalanche/proofpool.h>
 #include <avalanche/proofradixtreeadapter.h>
 #include <bloom.h>
 #include <coins.h>
 #include <consensus/validation.h>
+#include <fs.h>
 #include <pubkey.h>
 #include <radix.h>
 #include <salteduint256hasher.h>
@@ -31,6 +33,7 @@
 #include <unordered_set>
 #include <vector>
 
+class CBlock;
 class ChainstateManager;
 class CScheduler;
 
@@ -45,47 +48,26 @@ namespace avalanche {
  */
 static constexpr uint32_t AVALANCHE_MAX_ORPHAN_PROOFS = 4000;
 
+/**
+ * Whether the peers and proofs should be saved to disk on shutdown and
+ * reloaded on startup, so the node doesn't need to learn them all again from
+ * the network before it can establish a quorum.
+ */
+static constexpr bool DEFAULT_PERSIST_AVAPEERS = true;
+
+/**
+ * Version of the format the peers are dumped with.
+ */
+static constexpr uint64_t AVALANCHE_PEERS_DUMP_VERSION = 1;
+
 class Delegation;
 
 namespace {
     struct TestPeerManager;
 }
 
-struct Slot {
-private:
-    uint64_t start;
-    uint32_t score;
-    PeerId peerid;
-
-public:
-    Slot(uint64_t startIn, uint32_t scoreIn, PeerId peeridIn)
-        : start(startIn), score(scoreIn), peerid(peeridIn) {}
-
-    Slot withStart(uint64_t startIn) const {
-        return Slot(startIn, score, peerid);
-    }
-    Slot withScore(uint64_t scoreIn) const {
-        return Slot(start, scoreIn, peerid);
-    }
-    Slot withPeerId(PeerId peeridIn) const {
-        return Slot(start, score, peeridIn);
-    }
-
-    uint64_t getStart() const { return start; }
-    uint64_t getStop() const { return start + score; }
-    uint32_t getScore() const { return score; }
-    PeerId getPeerId() const { return peerid; }
-
-    bool contains(uint64_t slot) const {
-        return getStart() <= slot && slot < getStop();
-    }
-    bool precedes(uint64_t slot) const { return slot >= getStop(); }
-    bool follows(uint64_t slot) const { return getStart() > slot; }
-};
-
 struct Peer {
     PeerId peerid;
-    uint32_t index = -1;
     uint32_t node_count = 0;
 
     ProofRef proof;
@@ -152,9 +134,10 @@ class ProofRegistrationState : public ValidationState<ProofRegistrationResult> {
 namespace bmi = boost::multi_index;
 
 class PeerManager {
-    std::vector<Slot> slots;
-    uint64_t slotCount = 0;
-    uint64_t fragmentation = 0;
+    /**
+     * The peers with at least one node, which can be selected for polling.
+     */
+    PeerSampler peerSampler;
 
     /**
      * Several nodes can make an avalanche peer. In this case, all nodes are
@@ -215,8 +198,17 @@ class PeerManager {
                 bmi::member<PendingNode, NodeId, &PendingNode::nodeid>>>>;
     PendingNodeSet pendingNodes;
 
-    static constexpr int SELECT_PEER_MAX_RETRY = 3;
     static constexpr int SELECT_NODE_MAX_RETRY = 3;
+    /**
+     * The node response time is averaged over about that many polls, so it
+     * follows the changes in the node conditions without being too noisy.
+     */
+    static constexpr int RESPONSE_TIME_AVERAGE_WINDOW = 8;
+    /**
+     * Response time differences below this are not significant when selecting
+     * a node, as this is also the pace at which the polls are sent.
+     */
+    static constexpr std::chrono::milliseconds RESPONSE_TIME_RESOLUTION{10};
 
     /**
      * Track proof ids to broadcast
@@ -238,6 +230,15 @@ class PeerManager {
     uint32_t totalPeersScore = 0;
     uint32_t connectedPeersScore = 0;
 
+    /**
+     * Proofs affected by the blocks connected or disconnected since the last
+     * tip update, and the lowest tip height reached since then, or -1 if the
+     * proofs were never evaluated against a tip.
+     */
+    std::unordered_set<ProofId, SaltedProofIdHasher> staleProofIds;
+    bool hasBlockChanges = false;
+    int64_t lastTipHeight = -1;
+
     ChainstateManager &chainman;
 
 public:
@@ -253,6 +254,13 @@ public:
 
     // Update when a node is to be polled next.
     bool updateNextRequestTime(NodeId nodeid, TimePoint timeout);
+    /**
+     * Account for the time it took a node to respond to a poll, or for a poll
+     * that timed out after responseTime.
+     */
+    bool updateResponseTime(NodeId nodeid,
+                            std::chrono::microseconds responseTime,
+                            bool timedOut = false);
     /**
      * Flag that a node did send its compact proofs.
      * @return True if the flag changed state, i;e. if this is the first time
@@ -260,7 +268,10 @@ public:
      */
     bool latchAvaproofsSent(NodeId nodeid);
 
-    // Randomly select a node to poll.
+    /**
+     * Randomly select a node to poll. The peer is selected according to its
+     * stake, then the fastest to respond of its available nodes is selected.
+     */
     NodeId selectNode();
 
     /**
@@ -357,7 +368,17 @@ public:
     }
 
     /**
-     * Update the peer set when a new block is connected.
+     * Record the proofs affected by a block being connected or disconnected,
+     * i.e. the proofs staking an outpoint the block spends or creates.
+     */
+    void blockConnected(const CBlock &block);
+    void blockDisconnected(const CBlock &block, int height);
+
+    /**
+     * Update the peer set when the tip changed. Only the proofs affected by
+     * the blocks connected or disconnected since the last update, and the
+     * ones which stakes maturity changed with the tip height, are
+     * re-evaluated. If these blocks are unknown, all the proofs are.
      */
     std::unordered_set<ProofRef, SaltedProofHasher> updatedBlockTip();
 
@@ -368,6 +389,22 @@ public:
     void removeUnbroadcastProof(const ProofId &proofid);
     auto getUnbroadcastProofs() const { return m_unbroadcast_proofids; }
 
+    /**
+     * Persistence API.
+     *
+     * The proofs of the peers, along with their finalization state and
+     * conflict cooldown, and the conflicting and orphan proofs are dumped to
+     * a file that can be loaded on the next startup. The loaded proofs go
+     * through the usual registration process, so they are verified against
+     * the current UTXO set and the ones which no longer apply are dropped or
+     * kept as orphans. The proofs that got registered as peers are returned
+     * through registeredProofs.
+     */
+    bool dumpPeersToFile(const fs::path &dumpPath) const;
+    bool loadPeersFromFile(
+        const fs::path &dumpPath,
+        std::unordered_set<ProofRef, SaltedProofHasher> &registeredProofs);
+
     /*
      * Quorum management
      */
@@ -388,21 +425,12 @@ public:
      */
     PeerId selectPeer() const;
 
-    /**
-     * Trigger maintenance of internal data structures.
-     * Returns how much slot space was saved after compaction.
-     */
-    uint64_t compact();
-
     /**
      * Perform consistency check on internal data structures.
      */
     bool verify() const;
 
     // Accessors.
-    uint64_t getSlotCount() const { return slotCount; }
-    uint64_t getFragmentation() const { return fragmentation; }
-
     ProofRef getProof(const ProofId &proofid) const;
     bool isBoundToPeer(const ProofId &proofid) const;
     bool isOrphan(const ProofId &proofid) const;
@@ -421,6 +449,8 @@ private:
     template <typename ProofContainer>
     void moveToConflictingPool(const ProofContainer &proofs);
 
+    void addStaleProof(const COutPoint &outpoint);
+
     bool addOrUpdateNode(const PeerSet::iterator &it, NodeId nodeid);
     bool addNodeToPeer(const PeerSet::iterator &it);
     bool removeNodeFromPeer(const PeerSet::iterator &it, uint32_t count = 1);
@@ -428,12 +458,6 @@ private:
     friend struct ::avalanche::TestPeerManager;
 };
 
-/**
- * Internal methods that are exposed for testing purposes.
- */
-PeerId selectPeerImpl(const std::vector<Slot> &slots, const uint64_t slot,
-                      const uint64_t max);
-
 } // namespace avalanche
 
 #endif // BITCOIN_AVALANCHE_PEERMANAGER_H
@@ -0,0 +1,166 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/peersampler.h>
+
+#include <crypto/common.h>
+
+namespace avalanche {
+
+static uint8_t GetBucket(uint32_t score) {
+    return CountBits(score) - 1;
+}
+
+bool PeerSampler::add(PeerId peerid, uint32_t score) {
+    if (score == 0) {
+        return false;
+    }
+
+    const uint8_t b = GetBucket(score);
+    Bucket &bucket = buckets[b];
+    const Position pos{b, uint32_t(bucket.entries.size())};
+    if (!positions.emplace(peerid, pos).second) {
+        return false;
+    }
+
+    bucket.entries.push_back({peerid, score});
+    bucket.totalScore += score;
+    totalScore += score;
+
+    buildAliasTable();
+    return true;
+}
+
+bool PeerSampler::remove(PeerId peerid) {
+    auto it = positions.find(peerid);
+    if (it == positions.end()) {
+        return false;
+    }
+
+    const Position pos = it->second;
+    positions.erase(it);
+
+    Bucket &bucket = buckets[pos.bucket];
+    const uint32_t score = bucket.entries[pos.index].score;
+    bucket.totalScore -= score;
+    totalScore -= score;
+
+    // Move the last entry of the bucket in place of the removed one.
+    if (pos.index + 1 < bucket.entries.size()) {
+        bucket.entries[pos.index] = bucket.entries.back();
+        positions[bucket.entries[pos.index].peerid].index = pos.index;
+    }
+    bucket.entries.pop_back();
+
+    buildAliasTable();
+    return true;
+}
+
+void PeerSampler::buildAliasTable() {
+    aliasTable.clear();
+
+    std::array<uint8_t, BUCKET_COUNT> ids;
+    std::array<uint64_t, BUCKET_COUNT> scaled;
+    size_t count = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        if (buckets[i].totalScore > 0) {
+            ids[count++] = i;
+        }
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    /**
+     * Vose's alias method, in integer arithmetic so the probabilities are
+     * exact: each bucket gets a column of height totalScore, filled with its
+     * own score scaled by the number of columns and topped up by a bucket
+     * with more than its share.
+     */
+    std::vector<size_t> small, large;
+    for (size_t i = 0; i < count; i++) {
+        scaled[i] = buckets[ids[i]].totalScore * count;
+        (scaled[i] < totalScore ? small : large).push_back(i);
+    }
+
+    aliasTable.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        aliasTable[i] = {totalScore, ids[i], ids[i]};
+    }
+
+    while (!small.empty() && !large.empty()) {
+        const size_t s = small.back();
+        small.pop_back();
+        const size_t l = large.back();
+
+        aliasTable[s] = {scaled[s], ids[s], ids[l]};
+        scaled[l] -= totalScore - scaled[s];
+        if (scaled[l] < totalScore) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+}
+
+bool PeerSampler::verify() const {
+    uint64_t scoreFromBuckets = 0;
+    size_t entryCount = 0;
+    for (size_t b = 0; b < BUCKET_COUNT; b++) {
+        const Bucket &bucket = buckets[b];
+
+        uint64_t bucketScore = 0;
+        for (size_t i = 0; i < bucket.entries.size(); i++) {
+            const Entry &e = bucket.entries[i];
+
+            // The entry must be in the bucket for its score.
+            if (GetBucket(e.score) != b) {
+                return false;
+            }
+
+            // The position must point to the entry.
+            auto it = positions.find(e.peerid);
+            if (it == positions.end() || it->second.bucket != b ||
+                it->second.index != i) {
+                return false;
+            }
+
+            bucketScore += e.score;
+        }
+
+        if (bucketScore != bucket.totalScore) {
+            return false;
+        }
+
+        scoreFromBuckets += bucketScore;
+        entryCount += bucket.entries.size();
+    }
+
+    if (scoreFromBuckets != totalScore || entryCount != positions.size()) {
+        return false;
+    }
+
+    // Each bucket must be picked with a probability proportional to its score,
+    // so the alias table must account for score * columns for each bucket.
+    std::array<uint64_t, BUCKET_COUNT> scoreFromAliasTable{};
+    for (const AliasEntry &a : aliasTable) {
+        if (a.threshold > totalScore) {
+            return false;
+        }
+
+        scoreFromAliasTable[a.bucket] += a.threshold;
+        scoreFromAliasTable[a.alias] += totalScore - a.threshold;
+    }
+
+    for (size_t b = 0; b < BUCKET_COUNT; b++) {
+        if (scoreFromAliasTable[b] !=
+            buckets[b].totalScore * aliasTable.size()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace avalanche
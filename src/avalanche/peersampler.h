@@ -0,0 +1,113 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_AVALANCHE_PEERSAMPLER_H
+#define BITCOIN_AVALANCHE_PEERSAMPLER_H
+
+#include <avalanche/node.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace avalanche {
+
+/**
+ * Select peers at random, with a probability proportional to their score.
+ *
+ * The peers are grouped in buckets by score, each bucket holding the peers
+ * which score is in [2^i, 2^(i+1)). A bucket is picked according to its total
+ * score using an alias table, then a peer is picked uniformly within the
+ * bucket and accepted with a probability of score / 2^(i+1). Since this
+ * probability is at least 1/2, a peer is selected after less than 2 draws on
+ * average, whatever the number of peers.
+ *
+ * Adding or removing a peer only updates its bucket and rebuilds the alias
+ * table over the 32 buckets, so there is no fragmentation and no need for
+ * compaction.
+ */
+class PeerSampler {
+    struct Entry {
+        PeerId peerid;
+        uint32_t score;
+    };
+
+    struct Bucket {
+        std::vector<Entry> entries;
+        uint64_t totalScore = 0;
+    };
+
+    static constexpr size_t BUCKET_COUNT = 32;
+    std::array<Bucket, BUCKET_COUNT> buckets;
+
+    struct Position {
+        uint8_t bucket;
+        uint32_t index;
+    };
+    std::unordered_map<PeerId, Position> positions;
+
+    uint64_t totalScore = 0;
+
+    /**
+     * Alias table over the non empty buckets: a draw in [0, totalScore) below
+     * the threshold picks the bucket, otherwise it picks the alias.
+     */
+    struct AliasEntry {
+        uint64_t threshold;
+        uint8_t bucket;
+        uint8_t alias;
+    };
+    std::vector<AliasEntry> aliasTable;
+
+    void buildAliasTable();
+
+public:
+    /**
+     * Add a peer. Returns false if the peer is already present or has no
+     * score, in which case it can never be selected.
+     */
+    bool add(PeerId peerid, uint32_t score);
+
+    /**
+     * Remove a peer. Returns false if the peer is not present.
+     */
+    bool remove(PeerId peerid);
+
+    bool contains(PeerId peerid) const { return positions.count(peerid) > 0; }
+    size_t size() const { return positions.size(); }
+    uint64_t getTotalScore() const { return totalScore; }
+
+    /**
+     * Select a peer at random, or return NO_PEER if there is none. The rng
+     * must provide randrange() and randbits(), like FastRandomContext.
+     */
+    template <typename RNG> PeerId select(RNG &rng) const {
+        if (aliasTable.empty()) {
+            return NO_PEER;
+        }
+
+        const AliasEntry &a = aliasTable[rng.randrange(aliasTable.size())];
+        const uint8_t b =
+            rng.randrange(totalScore) < a.threshold ? a.bucket : a.alias;
+        const std::vector<Entry> &entries = buckets[b].entries;
+
+        while (true) {
+            const Entry &e = entries[rng.randrange(entries.size())];
+            if (rng.randbits(b + 1) < e.score) {
+                return e.peerid;
+            }
+        }
+    }
+
+    /**
+     * Perform consistency check on internal data structures.
+     */
+    bool verify() const;
+};
+
+} // namespace avalanche
+
+#endif // BITCOIN_AVALANCHE_PEERSAMPLER_H
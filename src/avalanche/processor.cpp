@@ -25,11 +25,6 @@
 #include <limits>
 #include <tuple>
 
-/**
- * Run the avalanche event loop every 10ms.
- */
-static constexpr std::chrono::milliseconds AVALANCHE_TIME_STEP{10};
-
 // Unfortunately, the bitcoind codebase is full of global and we are kinda
 // forced into it here.
 std::unique_ptr<avalanche::Processor> g_avalanche;
@@ -108,6 +103,36 @@ class Processor::NotificationsHandler
 public:
     NotificationsHandler(Processor *p) : m_processor(p) {}
 
+    void transactionAddedToMempool(const CTransactionRef &tx,
+                                   uint64_t mempool_sequence) override {
+        m_processor->addTxToReconcile(tx);
+    }
+
+    void transactionRemovedFromMempool(const CTransactionRef &ptx,
+                                       MemPoolRemovalReason reason,
+                                       uint64_t mempool_sequence) override {
+        m_processor->txVoteRecords.getWriteView()->erase(ptx);
+    }
+
+    void blockConnected(const CBlock &block, int height) override {
+        {
+            LOCK(m_processor->cs_peerManager);
+            m_processor->peerManager->blockConnected(block);
+        }
+
+        // The transactions removed from the mempool because they are mined are
+        // not notified, so forget about them here.
+        auto w = m_processor->txVoteRecords.getWriteView();
+        for (const CTransactionRef &tx : block.vtx) {
+            w->erase(tx);
+        }
+    }
+
+    void blockDisconnected(const CBlock &block, int height) override {
+        LOCK(m_processor->cs_peerManager);
+        m_processor->peerManager->blockDisconnected(block, height);
+    }
+
     void updatedBlockTip() override {
         auto registerProofs = [&]() {
             LOCK(m_processor->cs_peerManager);
@@ -129,18 +154,19 @@ public:
 
 Processor::Processor(Config avaconfigIn, interfaces::Chain &chain,
                      CConnman *connmanIn, ChainstateManager &chainmanIn,
-                     CScheduler &scheduler,
+                     CTxMemPool *mempoolIn, CScheduler &scheduler,
                      std::unique_ptr<PeerData> peerDataIn, CKey sessionKeyIn,
                      uint32_t minQuorumTotalScoreIn,
                      double minQuorumConnectedScoreRatioIn,
                      int64_t minAvaproofsNodeCountIn,
                      uint32_t staleVoteThresholdIn, uint32_t staleVoteFactorIn)
     : avaconfig(std::move(avaconfigIn)), connman(connmanIn),
-      chainman(chainmanIn), round(0),
+      chainman(chainmanIn), mempool(mempoolIn), round(0),
       peerManager(std::make_unique<PeerManager>(chainman)),
       peerData(std::move(peerDataIn)), sessionKey(std::move(sessionKeyIn)),
       minQuorumScore(minQuorumTotalScoreIn),
       minQuorumConnectedScoreRatio(minQuorumConnectedScoreRatioIn),
+      startTimeMillis(GetTimeMillis()),
       minAvaproofsNodeCount(minAvaproofsNodeCountIn),
       staleVoteThreshold(staleVoteThresholdIn),
       staleVoteFactor(staleVoteFactorIn) {
@@ -166,7 +192,8 @@ Processor::~Processor() {
 std::unique_ptr<Processor>
 Processor::MakeProcessor(const ArgsManager &argsman, interfaces::Chain &chain,
                          CConnman *connman, ChainstateManager &chainman,
-                         CScheduler &scheduler, bilingual_str &error) {
+                         CTxMemPool *mempoolIn, CScheduler &scheduler,
+                         bilingual_str &error) {
     std::unique_ptr<PeerData> peerData;
     CKey masterKey;
     CKey sessionKey;
@@ -330,7 +357,7 @@ Processor::MakeProcessor(const ArgsManager &argsman, interfaces::Chain &chain,
 
     // We can't use std::make_unique with a private constructor
     return std::unique_ptr<Processor>(new Processor(
-        std::move(avaconfig), chain, connman, chainman, scheduler,
+        std::move(avaconfig), chain, connman, chainman, mempoolIn, scheduler,
         std::move(peerData), std::move(sessionKey),
         Proof::amountToScore(minQuorumStake), minQuorumConnectedStakeRatio,
         minAvaproofsNodeCount, staleVoteThreshold, staleVoteFactor));
@@ -379,6 +406,25 @@ bool Processor::addProofToReconcile(const ProofRef &proof) {
         .second;
 }
 
+bool Processor::addTxToReconcile(const CTransactionRef &tx) {
+    if (!tx || !mempool) {
+        // isWorthPolling expects this to be non-null, so bail early.
+        return false;
+    }
+
+    {
+        LOCK(mempool->cs);
+        if (!isWorthPolling(tx)) {
+            return false;
+        }
+    }
+
+    // The transaction is in our mempool, so we accept it.
+    return txVoteRecords.getWriteView()
+        ->insert(std::make_pair(tx, VoteRecord(true)))
+        .second;
+}
+
 bool Processor::isAccepted(const CBlockIndex *pindex) const {
     if (!pindex) {
         // CBlockIndexWorkComparator expects this to be non-null, so bail early.
@@ -404,6 +450,21 @@ bool Processor::isAccepted(const ProofRef &proof) const {
     return it->second.isAccepted();
 }
 
+bool Processor::isAccepted(const CTransactionRef &tx) const {
+    if (!tx) {
+        // TxComparatorById expects this to be non-null, so bail early.
+        return false;
+    }
+
+    auto r = txVoteRecords.getReadView();
+    auto it = r->find(tx);
+    if (it == r.end()) {
+        return false;
+    }
+
+    return it->second.isAccepted();
+}
+
 int Processor::getConfidence(const CBlockIndex *pindex) const {
     if (!pindex) {
         // CBlockIndexWorkComparator expects this to be non-null, so bail early.
@@ -429,6 +490,21 @@ int Processor::getConfidence(const ProofRef &proof) const {
     return it->second.getConfidence();
 }
 
+int Processor::getConfidence(const CTransactionRef &tx) const {
+    if (!tx) {
+        // TxComparatorById expects this to be non-null, so bail early.
+        return -1;
+    }
+
+    auto r = txVoteRecords.getReadView();
+    auto it = r->find(tx);
+    if (it == r.end()) {
+        return -1;
+    }
+
+    return it->second.getConfidence();
+}
+
 namespace {
     /**
      * When using TCP, we need to sign all messages as the transport layer is
@@ -468,7 +544,8 @@ void Processor::sendResponse(CNode *pfrom, Response response) const {
 bool Processor::registerVotes(NodeId nodeid, const Response &response,
                               std::vector<BlockUpdate> &blockUpdates,
                               std::vector<ProofUpdate> &proofUpdates,
-                              int &banscore, std::string &error) {
+                              std::vector<TxUpdate> &txUpdates, int &banscore,
+                              std::string &error) {
     {
         // Save the time at which we can query again.
         LOCK(cs_peerManager);
@@ -482,6 +559,7 @@ bool Processor::registerVotes(NodeId nodeid, const Response &response,
     }
 
     std::vector<CInv> invs;
+    TimePoint sent;
 
     {
         // Check that the query exists.
@@ -494,9 +572,19 @@ bool Processor::registerVotes(NodeId nodeid, const Response &response,
         }
 
         invs = std::move(it->invs);
+        sent = it->sent;
         w->erase(it);
     }
 
+    {
+        // The node answered, account for how long it took so the fastest
+        // nodes get polled first.
+        LOCK(cs_peerManager);
+        peerManager->updateResponseTime(
+            nodeid, std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - sent));
+    }
+
     // Verify that the request and the vote are consistent.
     const std::vector<Vote> &votes = response.GetVotes();
     size_t size = invs.size();
@@ -516,99 +604,168 @@ bool Processor::registerVotes(NodeId nodeid, const Response &response,
 
     std::map<CBlockIndex *, Vote> responseIndex;
     std::map<ProofRef, Vote, ProofRefComparatorByAddress> responseProof;
+    std::map<CTransactionRef, Vote, TxComparatorById> responseTx;
 
     // At this stage we are certain that invs[i] matches votes[i], so we can use
-    // the inv type to retrieve what is being voted on.
-    for (size_t i = 0; i < size; i++) {
-        if (invs[i].IsMsgBlk()) {
-            CBlockIndex *pindex;
-            {
-                LOCK(cs_main);
-                pindex = chainman.m_blockman.LookupBlockIndex(
-                    BlockHash(votes[i].GetHash()));
-                if (!pindex) {
-                    // This should not happen, but just in case...
-                    continue;
-                }
+    // the inv type to retrieve what is being voted on. Look up all the items of
+    // the same type under a single lock.
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < size; i++) {
+            if (!invs[i].IsMsgBlk()) {
+                continue;
+            }
 
-                if (!isWorthPolling(pindex)) {
-                    // There is no point polling this block.
-                    continue;
-                }
+            CBlockIndex *pindex = chainman.m_blockman.LookupBlockIndex(
+                BlockHash(votes[i].GetHash()));
+            if (!pindex) {
+                // This should not happen, but just in case...
+                continue;
+            }
+
+            if (!isWorthPolling(pindex)) {
+                // There is no point polling this block.
+                continue;
             }
 
             responseIndex.insert(std::make_pair(pindex, votes[i]));
         }
+    }
 
-        if (invs[i].IsMsgProof()) {
-            const ProofId proofid(votes[i].GetHash());
+    {
+        LOCK(cs_peerManager);
+        for (size_t i = 0; i < size; i++) {
+            if (!invs[i].IsMsgProof()) {
+                continue;
+            }
 
-            ProofRef proof;
-            {
-                LOCK(cs_peerManager);
-                proof = peerManager->getProof(proofid);
-                if (!proof) {
-                    continue;
-                }
+            ProofRef proof = peerManager->getProof(ProofId(votes[i].GetHash()));
+            if (!proof) {
+                continue;
+            }
 
-                if (!isWorthPolling(proof)) {
-                    continue;
-                }
+            if (!isWorthPolling(proof)) {
+                continue;
             }
 
             responseProof.insert(std::make_pair(proof, votes[i]));
         }
     }
 
+    if (mempool) {
+        LOCK(mempool->cs);
+        for (size_t i = 0; i < size; i++) {
+            if (!invs[i].IsMsgTx()) {
+                continue;
+            }
+
+            CTransactionRef tx = mempool->get(TxId(votes[i].GetHash()));
+            if (!tx) {
+                continue;
+            }
+
+            if (!isWorthPolling(tx)) {
+                continue;
+            }
+
+            responseTx.insert(std::make_pair(tx, votes[i]));
+        }
+    }
+
     // Thanks to C++14 generic lambdas, we can apply the same logic to various
     // parameter types sharing the same interface.
-    auto registerVoteItems = [&](auto voteRecordsWriteView, auto &updates,
+    auto registerVoteItems = [&](auto &voteRecords, auto &updates,
                                  auto responseItems) {
-        // Register votes.
-        for (const auto &p : responseItems) {
-            auto item = p.first;
-            const Vote &v = p.second;
-
-            auto it = voteRecordsWriteView->find(item);
-            if (it == voteRecordsWriteView.end()) {
-                // We are not voting on that item anymore.
-                continue;
-            }
+        using Item = typename decltype(responseItems)::key_type;
+
+        // The outcome of the votes, in response order, and whether the item is
+        // to be removed from the vote records.
+        std::vector<std::tuple<Item, VoteStatus, bool>> outcomes;
+        bool hasItemsToErase = false;
+
+        // Register votes. The vote records are thread safe, so this only needs
+        // a read only view and does not block the other vote records users.
+        {
+            auto voteRecordsReadView = voteRecords.getReadView();
+            for (const auto &p : responseItems) {
+                auto item = p.first;
+                const Vote &v = p.second;
+
+                auto it = voteRecordsReadView->find(item);
+                if (it == voteRecordsReadView.end()) {
+                    // We are not voting on that item anymore.
+                    continue;
+                }
 
-            auto &vr = it->second;
-            if (!vr.registerVote(nodeid, v.GetError())) {
-                if (vr.isStale(staleVoteThreshold, staleVoteFactor)) {
-                    updates.emplace_back(item, VoteStatus::Stale);
+                auto &vr = it->second;
+                if (!vr.registerVote(nodeid, v.GetError())) {
+                    if (vr.isStale(staleVoteThreshold, staleVoteFactor)) {
+                        // Just drop stale votes. If we see this item again,
+                        // we'll do a new vote.
+                        outcomes.emplace_back(item, VoteStatus::Stale, true);
+                        hasItemsToErase = true;
+                    }
+                    // This vote did not provide any extra information, move
+                    // on.
+                    continue;
+                }
 
-                    // Just drop stale votes. If we see this item again, we'll
-                    // do a new vote.
-                    voteRecordsWriteView->erase(it);
+                if (!vr.hasFinalized()) {
+                    // This item has note been finalized, so we have nothing
+                    // more to do.
+                    outcomes.emplace_back(item,
+                                          vr.isAccepted()
+                                              ? VoteStatus::Accepted
+                                              : VoteStatus::Rejected,
+                                          false);
+                    continue;
                 }
-                // This vote did not provide any extra information, move on.
-                continue;
+
+                // We just finalized a vote. If it is valid, then let the caller
+                // know. Either way, remove the item from the map.
+                outcomes.emplace_back(item,
+                                      vr.isAccepted() ? VoteStatus::Finalized
+                                                      : VoteStatus::Invalid,
+                                      true);
+                hasItemsToErase = true;
             }
+        }
 
-            if (!vr.hasFinalized()) {
-                // This item has note been finalized, so we have nothing more to
-                // do.
-                updates.emplace_back(item, vr.isAccepted()
-                                               ? VoteStatus::Accepted
-                                               : VoteStatus::Rejected);
-                continue;
+        if (!hasItemsToErase) {
+            for (const auto &[item, status, erase] : outcomes) {
+                updates.emplace_back(item, status);
             }
+            return;
+        }
+
+        auto voteRecordsWriteView = voteRecords.getWriteView();
+        for (const auto &[item, status, erase] : outcomes) {
+            if (erase) {
+                // The item might have been removed, or removed and added back,
+                // since the read only view was released. Only the caller which
+                // actually removes the record reports the update.
+                auto it = voteRecordsWriteView->find(item);
+                if (it == voteRecordsWriteView.end()) {
+                    continue;
+                }
+
+                const VoteRecord &vr = it->second;
+                if (status == VoteStatus::Stale
+                        ? !vr.isStale(staleVoteThreshold, staleVoteFactor)
+                        : !vr.hasFinalized()) {
+                    continue;
+                }
 
-            // We just finalized a vote. If it is valid, then let the caller
-            // know. Either way, remove the item from the map.
-            updates.emplace_back(item, vr.isAccepted() ? VoteStatus::Finalized
-                                                       : VoteStatus::Invalid);
-            voteRecordsWriteView->erase(it);
+                voteRecordsWriteView->erase(it);
+            }
+
+            updates.emplace_back(item, status);
         }
     };
 
-    registerVoteItems(blockVoteRecords.getWriteView(), blockUpdates,
-                      responseIndex);
-    registerVoteItems(proofVoteRecords.getWriteView(), proofUpdates,
-                      responseProof);
+    registerVoteItems(blockVoteRecords, blockUpdates, responseIndex);
+    registerVoteItems(proofVoteRecords, proofUpdates, responseProof);
+    registerVoteItems(txVoteRecords, txUpdates, responseTx);
 
     return true;
 }
@@ -741,7 +898,11 @@ bool Processor::isQuorumEstablished() {
         return false;
     }
 
-    quorumIsEstablished = true;
+    if (!quorumIsEstablished.exchange(true)) {
+        LogPrintf("Avalanche quorum established after %dms\n",
+                  GetTimeMillis() - startTimeMillis);
+    }
+
     return true;
 }
 
@@ -786,11 +947,11 @@ void Processor::runEventLoop() {
 
                 {
                     // Compute the time at which this requests times out.
-                    auto timeout = std::chrono::steady_clock::now() +
-                                   avaconfig.queryTimeoutDuration;
+                    auto now = std::chrono::steady_clock::now();
+                    auto timeout = now + avaconfig.queryTimeoutDuration;
                     // Register the query.
                     queries.getWriteView()->insert(
-                        {pnode->GetId(), current_round, timeout, invs});
+                        {pnode->GetId(), current_round, now, timeout, invs});
                     // Set the timeout.
                     peerManager->updateNextRequestTime(pnode->GetId(), timeout);
                 }
@@ -821,6 +982,7 @@ void Processor::runEventLoop() {
 void Processor::clearTimedoutRequests() {
     auto now = std::chrono::steady_clock::now();
     std::map<CInv, uint8_t> timedout_items{};
+    std::vector<NodeId> timedout_nodes;
 
     {
         // Clear expired requests.
@@ -830,11 +992,22 @@ void Processor::clearTimedoutRequests() {
             for (const auto &i : it->invs) {
                 timedout_items[i]++;
             }
+            timedout_nodes.push_back(it->nodeid);
 
             w->get<query_timeout>().erase(it++);
         }
     }
 
+    if (!timedout_nodes.empty()) {
+        // The nodes that don't answer are accounted as answering at the
+        // timeout, so they are the last to be selected.
+        LOCK(cs_peerManager);
+        for (NodeId nodeid : timedout_nodes) {
+            peerManager->updateResponseTime(
+                nodeid, avaconfig.queryTimeoutDuration, true);
+        }
+    }
+
     if (timedout_items.empty()) {
         return;
     }
@@ -845,9 +1018,9 @@ void Processor::clearTimedoutRequests() {
             return false;
         }
 
-        auto voteRecordsWriteView = voteRecords.getWriteView();
-        auto it = voteRecordsWriteView->find(voteItem);
-        if (it == voteRecordsWriteView.end()) {
+        auto voteRecordsReadView = voteRecords.getReadView();
+        auto it = voteRecordsReadView->find(voteItem);
+        if (it == voteRecordsReadView.end()) {
             return false;
         }
 
@@ -878,6 +1051,14 @@ void Processor::clearTimedoutRequests() {
                 continue;
             }
         }
+
+        if (inv.IsMsgTx() && mempool) {
+            const CTransactionRef tx = mempool->get(TxId(inv.hash));
+
+            if (!clearInflightRequest(txVoteRecords, tx, p.second)) {
+                continue;
+            }
+        }
     }
 }
 
@@ -934,10 +1115,56 @@ std::vector<CInv> Processor::getInvsForNextPoll(bool forPoll) {
     // First remove all blocks that are not worth polling.
     WITH_LOCK(cs_main, removeItemsNotWorthPolling(blockVoteRecords));
 
-    auto r = blockVoteRecords.getReadView();
-    extractVoteRecordsToInvs(reverse_iterate(r), [](const CBlockIndex *pindex) {
-        return CInv(MSG_BLOCK, pindex->GetBlockHash());
-    });
+    {
+        auto r = blockVoteRecords.getReadView();
+        if (extractVoteRecordsToInvs(reverse_iterate(r),
+                                     [](const CBlockIndex *pindex) {
+                                         return CInv(MSG_BLOCK,
+                                                     pindex->GetBlockHash());
+                                     })) {
+            // The inventory vector is full, we're done
+            return invs;
+        }
+    }
+
+    if (!mempool) {
+        return invs;
+    }
+
+    // There can be tens of thousands of transactions to vote on, so rather
+    // than sweeping all of them, only the ones about to be polled are checked.
+    std::vector<CTransactionRef> txsNotWorthPolling;
+    {
+        LOCK(mempool->cs);
+        auto r = txVoteRecords.getReadView();
+        for (const auto &[tx, voteRecord] : r) {
+            if (invs.size() >= AVALANCHE_MAX_ELEMENT_POLL) {
+                break;
+            }
+
+            if (!voteRecord.shouldPoll()) {
+                continue;
+            }
+
+            if (!isWorthPolling(tx)) {
+                txsNotWorthPolling.push_back(tx);
+                continue;
+            }
+
+            if (forPoll && !voteRecord.registerPoll()) {
+                continue;
+            }
+
+            invs.emplace_back(MSG_TX, tx->GetId());
+        }
+    }
+
+    if (!txsNotWorthPolling.empty()) {
+        auto w = txVoteRecords.getWriteView();
+        for (const CTransactionRef &tx : txsNotWorthPolling) {
+            w->erase(tx);
+        }
+    }
 
     return invs;
 }
@@ -975,4 +1202,20 @@ bool Processor::isWorthPolling(const ProofRef &proof) const {
            peerManager->isInConflictingPool(proofid);
 }
 
+bool Processor::isWorthPolling(const CTransactionRef &tx) const {
+    AssertLockHeld(mempool->cs);
+
+    if (!gArgs.GetBoolArg("-avalanchepreconsensus",
+                          AVALANCHE_DEFAULT_PRECONSENSUS)) {
+        // The transactions are only polled if the pre-consensus is enabled.
+        return false;
+    }
+
+    const TxId &txid = tx->GetId();
+
+    // Only the transactions from our mempool are voted on, until they are
+    // finalized.
+    return mempool->exists(txid) && !mempool->IsAvalancheFinalized(txid);
+}
+
 } // namespace avalanche
@@ -15,7 +15,9 @@
 #include <interfaces/handler.h>
 #include <key.h>
 #include <net.h>
+#include <primitives/transaction.h>
 #include <rwcollection.h>
+#include <txmempool.h>
 
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -49,6 +51,11 @@ static constexpr size_t AVALANCHE_MAX_ELEMENT_POLL = 16;
 static constexpr std::chrono::milliseconds AVALANCHE_DEFAULT_QUERY_TIMEOUT{
     10000};
 
+/**
+ * Run the avalanche event loop every 10ms.
+ */
+static constexpr std::chrono::milliseconds AVALANCHE_TIME_STEP{10};
+
 namespace avalanche {
 
 class Delegation;
@@ -80,11 +87,23 @@ public:
 
 using BlockUpdate = VoteItemUpdate<CBlockIndex *>;
 using ProofUpdate = VoteItemUpdate<ProofRef>;
+using TxUpdate = VoteItemUpdate<CTransactionRef>;
+
+/**
+ * Compare transactions by id, so they are polled in a deterministic order.
+ */
+struct TxComparatorById {
+    bool operator()(const CTransactionRef &lhs,
+                    const CTransactionRef &rhs) const {
+        return lhs->GetId() < rhs->GetId();
+    }
+};
 
 using BlockVoteMap =
     std::map<const CBlockIndex *, VoteRecord, CBlockIndexWorkComparator>;
 using ProofVoteMap =
     std::map<const ProofRef, VoteRecord, ProofComparatorByScore>;
+using TxVoteMap = std::map<const CTransactionRef, VoteRecord, TxComparatorById>;
 
 struct query_timeout {};
 
@@ -98,6 +117,7 @@ class Processor final : public NetEventsInterface {
     Config avaconfig;
     CConnman *connman;
     ChainstateManager &chainman;
+    CTxMemPool *mempool;
 
     /**
      * Blocks to run avalanche on.
@@ -109,6 +129,14 @@ class Processor final : public NetEventsInterface {
      */
     RWCollection<ProofVoteMap> proofVoteRecords;
 
+    /**
+     * Mempool transactions to run avalanche on. There can be many more of them
+     * than blocks or proofs, so they are only checked for being worth polling
+     * when they are about to be polled, and are removed as they leave the
+     * mempool.
+     */
+    RWCollection<TxVoteMap> txVoteRecords;
+
     /**
      * Keep track of peers and queries sent.
      */
@@ -123,6 +151,7 @@ class Processor final : public NetEventsInterface {
     struct Query {
         NodeId nodeid;
         uint64_t round;
+        TimePoint sent;
         TimePoint timeout;
 
         /**
@@ -164,6 +193,8 @@ class Processor final : public NetEventsInterface {
     uint32_t minQuorumScore;
     double minQuorumConnectedScoreRatio;
     std::atomic<bool> quorumIsEstablished{false};
+    /** Used to report how long it took to establish the quorum. */
+    const int64_t startTimeMillis;
     int64_t minAvaproofsNodeCount;
     std::atomic<int64_t> avaproofsNodeCounter{0};
 
@@ -176,7 +207,8 @@ class Processor final : public NetEventsInterface {
     std::unique_ptr<interfaces::Handler> chainNotificationsHandler;
 
     Processor(Config avaconfig, interfaces::Chain &chain, CConnman *connmanIn,
-              ChainstateManager &chainman, CScheduler &scheduler,
+              ChainstateManager &chainman, CTxMemPool *mempoolIn,
+              CScheduler &scheduler,
               std::unique_ptr<PeerData> peerDataIn, CKey sessionKeyIn,
               uint32_t minQuorumTotalScoreIn,
               double minQuorumConnectedScoreRatioIn,
@@ -189,20 +221,25 @@ public:
     static std::unique_ptr<Processor>
     MakeProcessor(const ArgsManager &argsman, interfaces::Chain &chain,
                   CConnman *connman, ChainstateManager &chainman,
-                  CScheduler &scheduler, bilingual_str &error);
+                  CTxMemPool *mempoolIn, CScheduler &scheduler,
+                  bilingual_str &error);
 
     bool addBlockToReconcile(const CBlockIndex *pindex);
     bool addProofToReconcile(const ProofRef &proof);
+    bool addTxToReconcile(const CTransactionRef &tx);
     bool isAccepted(const CBlockIndex *pindex) const;
     bool isAccepted(const ProofRef &proof) const;
+    bool isAccepted(const CTransactionRef &tx) const;
     int getConfidence(const CBlockIndex *pindex) const;
     int getConfidence(const ProofRef &proof) const;
+    int getConfidence(const CTransactionRef &tx) const;
 
     // TODO: Refactor the API to remove the dependency on avalanche/protocol.h
     void sendResponse(CNode *pfrom, Response response) const;
     bool registerVotes(NodeId nodeid, const Response &response,
                        std::vector<BlockUpdate> &blockUpdates,
-                       std::vector<ProofUpdate> &proofUpdates, int &banscore,
+                       std::vector<ProofUpdate> &proofUpdates,
+                       std::vector<TxUpdate> &txUpdates, int &banscore,
                        std::string &error);
 
     template <typename Callable> auto withPeerManager(Callable &&func) const {
@@ -252,6 +289,8 @@ private:
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool isWorthPolling(const ProofRef &proof) const
         EXCLUSIVE_LOCKS_REQUIRED(cs_peerManager);
+    bool isWorthPolling(const CTransactionRef &tx) const
+        EXCLUSIVE_LOCKS_REQUIRED(mempool->cs);
 
     friend struct ::avalanche::AvalancheTest;
 };
@@ -139,13 +139,24 @@ bool Proof::verify(ProofValidationState &state) const {
             return state.Invalid(ProofValidationResult::INVALID_PAYOUT_SCRIPT,
                                  "payout-script-non-standard");
         }
+    }
 
-        if (!master.VerifySchnorr(limitedProofId, signature)) {
-            return state.Invalid(ProofValidationResult::INVALID_PROOF_SIGNATURE,
-                                 "invalid-proof-signature");
-        }
+    // Verifying all the signatures at once is much faster, but if any of them
+    // is invalid they need to be checked one by one to report which one.
+    bool checkSignatures = false;
+    if (!signaturesVerified) {
+        SchnorrBatchVerifier batch;
+        addSignatures(batch);
+        checkSignatures = !batch.Verify();
     }
 
+    if (checkSignatures && !useLegacy(gArgs) &&
+        !master.VerifySchnorr(limitedProofId, signature)) {
+        return state.Invalid(ProofValidationResult::INVALID_PROOF_SIGNATURE,
+                             "invalid-proof-signature");
+    }
+
+    const StakeCommitment commitment = getStakeCommitment();
     StakeId prevId = uint256::ZERO;
     std::unordered_set<COutPoint, SaltedOutpointHasher> utxos;
     for (const SignedStake &ss : stakes) {
@@ -168,7 +179,7 @@ bool Proof::verify(ProofValidationState &state) const {
                                  "duplicated-stake");
         }
 
-        if (!ss.verify(getStakeCommitment())) {
+        if (checkSignatures && !ss.verify(commitment)) {
             return state.Invalid(
                 ProofValidationResult::INVALID_STAKE_SIGNATURE,
                 "invalid-stake-signature",
@@ -176,9 +187,65 @@ bool Proof::verify(ProofValidationState &state) const {
         }
     }
 
+    signaturesVerified = true;
     return true;
 }
 
+void Proof::addSignatures(SchnorrBatchVerifier &batch) const {
+    if (!useLegacy(gArgs)) {
+        batch.Add(master, limitedProofId, signature);
+    }
+
+    const StakeCommitment commitment = getStakeCommitment();
+    for (const SignedStake &ss : stakes) {
+        const Stake &s = ss.getStake();
+        batch.Add(s.getPubkey(), s.getHash(commitment), ss.getSignature());
+    }
+}
+
+bool Proof::verifySignatures() const {
+    if (!useLegacy(gArgs) && !master.VerifySchnorr(limitedProofId, signature)) {
+        return false;
+    }
+
+    const StakeCommitment commitment = getStakeCommitment();
+    for (const SignedStake &ss : stakes) {
+        if (!ss.verify(commitment)) {
+            return false;
+        }
+    }
+
+    signaturesVerified = true;
+    return true;
+}
+
+bool VerifyProofSignatures(const std::vector<ProofRef> &proofs) {
+    SchnorrBatchVerifier batch;
+    for (const ProofRef &proof : proofs) {
+        if (!proof->signaturesVerified) {
+            proof->addSignatures(batch);
+        }
+    }
+
+    if (batch.Verify()) {
+        for (const ProofRef &proof : proofs) {
+            proof->signaturesVerified = true;
+        }
+        return true;
+    }
+
+    // Fallback to verifying the proofs one by one, so the valid ones don't
+    // need to be verified again.
+    bool ret = true;
+    for (const ProofRef &proof : proofs) {
+        if (!proof->signaturesVerified && !proof->verifySignatures()) {
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
 bool Proof::verify(ProofValidationState &state,
                    const ChainstateManager &chainman) const {
     AssertLockHeld(cs_main);
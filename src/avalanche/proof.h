@@ -15,6 +15,7 @@
 #include <validation.h> // For ChainstateManager and cs_main
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -121,6 +122,17 @@ class Proof {
     uint32_t score;
     void computeScore();
 
+    /**
+     * The signatures only depend on the content of the proof, so they never
+     * need to be checked again once they are known to be valid.
+     */
+    mutable std::atomic<bool> signaturesVerified{false};
+
+    void addSignatures(SchnorrBatchVerifier &batch) const;
+    bool verifySignatures() const;
+
+    friend bool VerifyProofSignatures(const std::vector<RCUPtr<const Proof>> &);
+
     IMPLEMENT_RCU_REFCOUNT(uint64_t);
 
 public:
@@ -144,7 +156,8 @@ public:
           payoutScriptPubKey(std::move(other.payoutScriptPubKey)),
           signature(std::move(other.signature)),
           limitedProofId(std::move(other.limitedProofId)),
-          proofid(std::move(other.proofid)), score(other.score) {}
+          proofid(std::move(other.proofid)), score(other.score),
+          signaturesVerified(other.signaturesVerified.load()) {}
 
     /**
      * Deserialization constructor.
@@ -160,6 +173,7 @@ public:
         }
         SER_READ(obj, obj.computeProofId());
         SER_READ(obj, obj.computeScore());
+        SER_READ(obj, obj.signaturesVerified = false);
     }
 
     static bool useLegacy();
@@ -196,6 +210,14 @@ public:
 
 using ProofRef = RCUPtr<const Proof>;
 
+/**
+ * Verify the signatures of several proofs at once, e.g. when they are received
+ * or loaded together, which is faster than verifying them proof by proof. The
+ * proofs with valid signatures don't get their signatures checked again when
+ * they are verified. Returns false if any of the signatures is invalid.
+ */
+bool VerifyProofSignatures(const std::vector<ProofRef> &proofs);
+
 class SaltedProofHasher : private SaltedUint256Hasher {
 public:
     SaltedProofHasher() : SaltedUint256Hasher() {}
@@ -111,6 +111,23 @@ ProofRef ProofPool::getProof(const COutPoint &outpoint) const {
     return it == pool.end() ? ProofRef() : it->proof;
 }
 
+std::unordered_set<ProofRef, SaltedProofHasher>
+ProofPool::getProofsWithStakeHeight(uint32_t minHeight,
+                                    uint32_t maxHeight) const {
+    std::unordered_set<ProofRef, SaltedProofHasher> proofs;
+    if (minHeight > maxHeight) {
+        return proofs;
+    }
+
+    auto &poolView = pool.get<by_stake_height>();
+    auto end = poolView.upper_bound(maxHeight);
+    for (auto it = poolView.lower_bound(minHeight); it != end; it++) {
+        proofs.insert(it->proof);
+    }
+
+    return proofs;
+}
+
 ProofRef ProofPool::getLowestScoreProof() const {
     auto &poolView = pool.get<by_proof_score>();
     return poolView.rbegin() == poolView.rend() ? ProofRef()
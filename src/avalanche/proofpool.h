@@ -18,6 +18,7 @@
 #include <boost/multi_index_container.hpp>
 
 #include <cstdint>
+#include <unordered_set>
 
 namespace avalanche {
 
@@ -31,6 +32,10 @@ struct ProofPoolEntry {
         return proof->getStakes().at(utxoIndex).getStake().getUTXO();
     }
 
+    uint32_t getStakeHeight() const {
+        return proof->getStakes().at(utxoIndex).getStake().getHeight();
+    }
+
     ProofPoolEntry(size_t _utxoIndex, ProofRef _proof)
         : utxoIndex(_utxoIndex), proof(std::move(_proof)) {}
 };
@@ -38,6 +43,7 @@ struct ProofPoolEntry {
 struct by_utxo;
 struct by_proofid;
 struct by_proof_score;
+struct by_stake_height;
 
 struct ProofPoolEntryProofIdKeyExtractor {
     using result_type = ProofId;
@@ -69,7 +75,12 @@ class ProofPool {
             bmi::ordered_non_unique<
                 bmi::tag<by_proof_score>,
                 bmi::member<ProofPoolEntry, ProofRef, &ProofPoolEntry::proof>,
-                ProofComparatorByScore>>>
+                ProofComparatorByScore>,
+            // ordered by stake height
+            bmi::ordered_non_unique<
+                bmi::tag<by_stake_height>,
+                bmi::const_mem_fun<ProofPoolEntry, uint32_t,
+                                   &ProofPoolEntry::getStakeHeight>>>>
         pool;
 
     bool cacheClean = true;
@@ -116,8 +127,30 @@ public:
     ProofRef getProof(const COutPoint &outpoint) const;
     ProofRef getLowestScoreProof() const;
 
+    /**
+     * Get the proofs with at least one stake which height is in the
+     * [minHeight, maxHeight] range.
+     */
+    std::unordered_set<ProofRef, SaltedProofHasher>
+    getProofsWithStakeHeight(uint32_t minHeight, uint32_t maxHeight) const;
+
     size_t size() const { return pool.size(); }
     size_t countProofs();
+
+    /**
+     * Call func once for each proof in the pool.
+     */
+    template <typename Callable> void forEachProof(Callable &&func) const {
+        ProofId lastProofId;
+        auto &poolView = pool.get<by_proofid>();
+        for (auto it = poolView.begin(); it != poolView.end(); it++) {
+            const ProofId &proofId = it->proof->getId();
+            if (lastProofId != proofId) {
+                lastProofId = proofId;
+                func(it->proof);
+            }
+        }
+    }
 };
 
 } // namespace avalanche
@@ -0,0 +1,384 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/simulator.h>
+
+#include <avalanche/peersampler.h>
+#include <crypto/common.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <queue>
+#include <tuple>
+
+namespace avalanche {
+
+std::chrono::microseconds
+SimulationResult::getFinalizationLatencyPercentile(double percentile) const {
+    if (finalizationLatencies.empty()) {
+        return std::chrono::microseconds{0};
+    }
+
+    const size_t n = finalizationLatencies.size();
+    size_t rank = std::ceil(percentile / 100. * n);
+    return finalizationLatencies[std::clamp<size_t>(rank, 1, n) - 1];
+}
+
+namespace {
+
+    // Same as the PeerManager.
+    static constexpr int SELECT_NODE_MAX_RETRY = 3;
+
+    struct Query {
+        size_t polledNode;
+        std::chrono::microseconds timeout;
+        std::vector<size_t> items;
+    };
+
+    struct SimulatedNode {
+        uint32_t score = 0;
+        bool honest = true;
+
+        // The items this node is still voting on.
+        std::map<size_t, VoteRecord> voteRecords;
+        // The preference of this node for each item.
+        std::vector<bool> accepted;
+
+        // The queries in flight, by round.
+        std::map<uint64_t, Query> queries;
+        uint64_t round = 0;
+        // When each node can be polled again by this node.
+        std::vector<std::chrono::microseconds> nextRequestTime;
+
+        std::chrono::nanoseconds cpuTime{0};
+    };
+
+    enum class EventType {
+        // The event loop of the node runs.
+        EventLoop,
+        // The node receives a poll.
+        Poll,
+        // The node receives a response to one of its polls.
+        Response,
+    };
+
+    struct Event {
+        std::chrono::microseconds time;
+        // Break ties in scheduling order, so the simulation is deterministic.
+        uint64_t sequence;
+
+        EventType type;
+        size_t to;
+        size_t from;
+        uint64_t round;
+        std::vector<size_t> items;
+        std::vector<uint32_t> votes;
+
+        bool operator>(const Event &other) const {
+            return std::tie(time, sequence) >
+                   std::tie(other.time, other.sequence);
+        }
+    };
+
+    class Simulation {
+        const SimulationParams &params;
+        FastRandomContext rng;
+
+        std::vector<SimulatedNode> nodes;
+        PeerSampler peerSampler;
+
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>>
+            events;
+        uint64_t sequence = 0;
+        std::chrono::microseconds now{0};
+
+        // The number of (node, item) pairs that are still being voted on.
+        size_t remainingItems = 0;
+
+        SimulationResult result;
+
+    public:
+        explicit Simulation(const SimulationParams &paramsIn);
+
+        SimulationResult run();
+
+    private:
+        static uint256 seedFromParams(const SimulationParams &paramsIn);
+
+        uint32_t drawScore();
+
+        void schedule(Event event);
+        /** Schedule the delivery of a message, unless it is lost. */
+        void send(Event message);
+
+        void runEventLoop(size_t nodeid);
+        void receivePoll(const Event &poll);
+        void receiveResponse(const Event &response);
+
+        /** Select a node to poll by stake, or return false if none is. */
+        bool selectNode(size_t nodeid, size_t &selected);
+    };
+
+    uint256 Simulation::seedFromParams(const SimulationParams &paramsIn) {
+        uint256 seed;
+        WriteLE64(seed.begin(), paramsIn.seed);
+        return seed;
+    }
+
+    Simulation::Simulation(const SimulationParams &paramsIn)
+        : params(paramsIn), rng(seedFromParams(paramsIn)),
+          nodes(paramsIn.numNodes) {
+        // Pick the dishonest nodes regardless of their stake.
+        std::vector<size_t> order(nodes.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        Shuffle(order.begin(), order.end(), rng);
+        const size_t numDishonest =
+            nodes.size() * params.dishonestPercent / 100;
+        for (size_t i = 0; i < numDishonest; i++) {
+            nodes[order[i]].honest = false;
+        }
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            SimulatedNode &node = nodes[i];
+            node.score = drawScore();
+            peerSampler.add(i, node.score);
+
+            node.accepted.assign(params.numItems, true);
+            node.nextRequestTime.assign(nodes.size(),
+                                        std::chrono::microseconds{0});
+            for (size_t item = 0; item < params.numItems; item++) {
+                node.voteRecords.emplace(item, VoteRecord(true));
+            }
+            remainingItems += params.numItems;
+
+            // Start the event loops out of phase.
+            schedule({std::chrono::microseconds{rng.randrange(
+                          std::chrono::microseconds{params.pollInterval}
+                              .count())},
+                      0, EventType::EventLoop, i, i, 0, {}, {}});
+        }
+
+        result.cpuTimePerNode.resize(nodes.size());
+    }
+
+    uint32_t Simulation::drawScore() {
+        static constexpr uint32_t MIN_SCORE = 100;
+        static constexpr uint32_t MAX_SCORE = 1000000;
+
+        if (params.stakeParetoShape <= 0.) {
+            return MIN_SCORE;
+        }
+
+        // Draw in (0, 1] so the score is finite.
+        const double u = (double(rng.rand32()) + 1.) / 4294967296.;
+        const double score =
+            MIN_SCORE / std::pow(u, 1. / params.stakeParetoShape);
+        return std::min<double>(score, MAX_SCORE);
+    }
+
+    void Simulation::schedule(Event event) {
+        event.sequence = sequence++;
+        events.push(std::move(event));
+    }
+
+    void Simulation::send(Event message) {
+        if (rng.randrange(100) < params.lossPercent) {
+            result.messagesLost++;
+            return;
+        }
+
+        const auto latencySpread = params.maxLatency - params.minLatency;
+        message.time = now + params.minLatency +
+                       std::chrono::microseconds{
+                           rng.randrange(latencySpread.count() + 1)};
+        schedule(std::move(message));
+    }
+
+    bool Simulation::selectNode(size_t nodeid, size_t &selected) {
+        for (int retry = 0; retry < SELECT_NODE_MAX_RETRY; retry++) {
+            const PeerId p = peerSampler.select(rng);
+            if (p == NO_PEER || size_t(p) == nodeid) {
+                continue;
+            }
+
+            if (nodes[nodeid].nextRequestTime[p] <= now) {
+                selected = p;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Simulation::runEventLoop(size_t nodeid) {
+        SimulatedNode &node = nodes[nodeid];
+
+        // Clear the queries that timed out.
+        for (auto it = node.queries.begin(); it != node.queries.end();) {
+            if (it->second.timeout >= now) {
+                ++it;
+                continue;
+            }
+
+            for (size_t item : it->second.items) {
+                auto vrit = node.voteRecords.find(item);
+                if (vrit != node.voteRecords.end()) {
+                    vrit->second.clearInflightRequest();
+                }
+            }
+
+            result.queriesTimedOut++;
+            it = node.queries.erase(it);
+        }
+
+        if (node.voteRecords.empty()) {
+            // This node is done voting, it only answers polls from now on.
+            return;
+        }
+
+        schedule({now + params.pollInterval, 0, EventType::EventLoop, nodeid,
+                  nodeid, 0, {}, {}});
+
+        size_t polled;
+        if (!selectNode(nodeid, polled)) {
+            return;
+        }
+
+        std::vector<size_t> items;
+        for (const auto &[item, voteRecord] : node.voteRecords) {
+            if (items.size() >= params.maxElementPoll) {
+                break;
+            }
+
+            if (voteRecord.registerPoll()) {
+                items.push_back(item);
+            }
+        }
+
+        if (items.empty()) {
+            return;
+        }
+
+        const uint64_t round = node.round++;
+        const auto timeout = now + params.queryTimeout;
+        node.queries.emplace(round, Query{polled, timeout, items});
+        node.nextRequestTime[polled] = timeout;
+
+        result.pollsSent++;
+        send({now, 0, EventType::Poll, polled, nodeid, round, std::move(items),
+              {}});
+    }
+
+    void Simulation::receivePoll(const Event &poll) {
+        const SimulatedNode &node = nodes[poll.to];
+
+        std::vector<uint32_t> votes;
+        votes.reserve(poll.items.size());
+        for (size_t item : poll.items) {
+            votes.push_back(node.honest && node.accepted[item] ? 0 : 1);
+        }
+
+        result.responsesSent++;
+        send({now, 0, EventType::Response, poll.from, poll.to, poll.round,
+              poll.items, std::move(votes)});
+    }
+
+    void Simulation::receiveResponse(const Event &response) {
+        SimulatedNode &node = nodes[response.to];
+
+        auto qit = node.queries.find(response.round);
+        if (qit == node.queries.end() ||
+            qit->second.polledNode != response.from) {
+            // The query timed out already.
+            return;
+        }
+        node.queries.erase(qit);
+        node.nextRequestTime[response.from] = now + params.cooldown;
+
+        for (size_t i = 0; i < response.items.size(); i++) {
+            const size_t item = response.items[i];
+            auto it = node.voteRecords.find(item);
+            if (it == node.voteRecords.end()) {
+                // We are not voting on that item anymore.
+                continue;
+            }
+
+            result.votesRegistered++;
+            VoteRecord &vr = it->second;
+            if (!vr.registerVote(response.from, response.votes[i])) {
+                if (vr.isStale(params.staleVoteThreshold,
+                               params.staleVoteFactor)) {
+                    result.staleItems++;
+                    remainingItems--;
+                    node.voteRecords.erase(it);
+                }
+                continue;
+            }
+
+            node.accepted[item] = vr.isAccepted();
+            if (!vr.hasFinalized()) {
+                continue;
+            }
+
+            result.finalizationLatencies.push_back(now);
+            if (!vr.isAccepted()) {
+                result.invalidItems++;
+            }
+            remainingItems--;
+            node.voteRecords.erase(it);
+        }
+    }
+
+    SimulationResult Simulation::run() {
+        while (!events.empty() && remainingItems > 0) {
+            const Event event = events.top();
+            if (event.time > params.maxDuration) {
+                break;
+            }
+            events.pop();
+            now = event.time;
+
+            const auto start = std::chrono::steady_clock::now();
+            switch (event.type) {
+                case EventType::EventLoop:
+                    runEventLoop(event.to);
+                    break;
+                case EventType::Poll:
+                    receivePoll(event);
+                    break;
+                case EventType::Response:
+                    receiveResponse(event);
+                    break;
+            }
+            nodes[event.to].cpuTime +=
+                std::chrono::steady_clock::now() - start;
+        }
+
+        result.duration = now;
+        result.unfinalizedItems = remainingItems;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            result.cpuTimePerNode[i] = nodes[i].cpuTime;
+        }
+        std::sort(result.finalizationLatencies.begin(),
+                  result.finalizationLatencies.end());
+
+        return std::move(result);
+    }
+
+} // namespace
+
+SimulationResult RunSimulation(const SimulationParams &params) {
+    assert(params.numNodes >= 2);
+    assert(params.minLatency <= params.maxLatency);
+    return Simulation(params).run();
+}
+
+} // namespace avalanche
@@ -0,0 +1,118 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_AVALANCHE_SIMULATOR_H
+#define BITCOIN_AVALANCHE_SIMULATOR_H
+
+#include <avalanche/avalanche.h>
+#include <avalanche/processor.h>
+#include <avalanche/voterecord.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace avalanche {
+
+/**
+ * Parameters of a simulated avalanche network.
+ *
+ * The defaults match the ones of the avalanche Processor, so that the effect
+ * of a single parameter can be evaluated by changing it alone.
+ */
+struct SimulationParams {
+    /** Number of nodes in the network, all of them polling and voting. */
+    size_t numNodes = 100;
+    /** Number of items every node is voting on. */
+    size_t numItems = AVALANCHE_MAX_ELEMENT_POLL;
+
+    /**
+     * Message latency, drawn uniformly in [minLatency, maxLatency] for each
+     * message.
+     */
+    std::chrono::microseconds minLatency{20000};
+    std::chrono::microseconds maxLatency{100000};
+    /** Probability, in percent, that any message is lost. */
+    uint32_t lossPercent = 0;
+
+    /**
+     * Shape of the Pareto distribution the node stakes are drawn from. The
+     * smaller it is, the more the stake concentrates on a few nodes. The
+     * stake is evenly distributed if this is 0.
+     */
+    double stakeParetoShape = 0.;
+    /**
+     * Percentage of the nodes that vote against every item, picked at random
+     * regardless of their stake.
+     */
+    uint32_t dishonestPercent = 0;
+
+    /** Processor tunables. */
+    std::chrono::milliseconds pollInterval = AVALANCHE_TIME_STEP;
+    std::chrono::milliseconds queryTimeout = AVALANCHE_DEFAULT_QUERY_TIMEOUT;
+    std::chrono::milliseconds cooldown{AVALANCHE_DEFAULT_COOLDOWN};
+    size_t maxElementPoll = AVALANCHE_MAX_ELEMENT_POLL;
+    uint32_t staleVoteThreshold = AVALANCHE_VOTE_STALE_THRESHOLD;
+    uint32_t staleVoteFactor = AVALANCHE_VOTE_STALE_FACTOR;
+
+    /** The simulation stops after that much virtual time. */
+    std::chrono::milliseconds maxDuration{10 * 60 * 1000};
+
+    /** Runs with the same parameters and seed produce the same results. */
+    uint64_t seed = 0;
+};
+
+struct SimulationResult {
+    /**
+     * Virtual time it took each node to finalize each item, sorted in
+     * ascending order. Items that did not finalize are not accounted for.
+     */
+    std::vector<std::chrono::microseconds> finalizationLatencies;
+
+    /** Items that did not finalize, because they went stale or timed out. */
+    size_t staleItems = 0;
+    size_t unfinalizedItems = 0;
+    /** Items that finalized as rejected. */
+    size_t invalidItems = 0;
+
+    /** Message accounting. */
+    uint64_t pollsSent = 0;
+    uint64_t responsesSent = 0;
+    uint64_t messagesLost = 0;
+    uint64_t queriesTimedOut = 0;
+    uint64_t votesRegistered = 0;
+
+    /** Real time spent processing the events of each node. */
+    std::vector<std::chrono::nanoseconds> cpuTimePerNode;
+
+    /** Virtual time at which the simulation ended. */
+    std::chrono::microseconds duration{0};
+
+    /**
+     * Finalization latency below which `percentile` percent of the items
+     * finalized, or zero if no item finalized.
+     */
+    std::chrono::microseconds
+    getFinalizationLatencyPercentile(double percentile) const;
+};
+
+/**
+ * Run a simulated avalanche network in process, over a virtual clock and a
+ * virtual message bus, until every node finalized every item or the maximum
+ * duration is reached.
+ *
+ * The nodes use the same VoteRecord and stake weighted PeerSampler as the
+ * avalanche Processor, and follow its polling loop: every poll interval, a
+ * node clears its timed out queries, then polls a node selected by stake for
+ * the items it is still voting on. A polled node votes according to its own
+ * preference and can't be polled again by the same node before its cooldown
+ * elapsed. This lets the timeouts, poll sizes and staleness thresholds be
+ * tuned offline.
+ */
+SimulationResult RunSimulation(const SimulationParams &params);
+
+} // namespace avalanche
+
+#endif // BITCOIN_AVALANCHE_SIMULATOR_H
@@ -6,6 +6,7 @@
 #include <avalanche/delegationbuilder.h>
 #include <avalanche/test/util.h>
 #include <avalanche/validation.h>
+#include <streams.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
 
@@ -201,4 +202,61 @@ BOOST_AUTO_TEST_CASE(level_limit) {
     BOOST_CHECK(state.GetResult() == DelegationResult::TOO_MANY_LEVELS);
 }
 
+BOOST_AUTO_TEST_CASE(verification_cache) {
+    auto proofKey = CKey::MakeCompressedKey();
+    auto p = buildRandomProof(Assert(m_node.chainman)->ActiveChainstate(),
+                              123456, 1234, proofKey);
+
+    DelegationBuilder dgb(*p);
+    CKey delegatorKey = proofKey;
+    for (size_t i = 0; i < 3; i++) {
+        CKey delegatedKey = CKey::MakeCompressedKey();
+        BOOST_CHECK(dgb.addLevel(delegatorKey, delegatedKey.GetPubKey()));
+        delegatorKey = delegatedKey;
+    }
+    const Delegation dg = dgb.build();
+
+    // The cache is shared by all the tests, so only check the increments.
+    DelegationCacheStats stats = GetDelegationCacheStats();
+    auto checkStats = [&](uint64_t hits, uint64_t misses) {
+        const DelegationCacheStats newStats = GetDelegationCacheStats();
+        BOOST_CHECK_EQUAL(newStats.hits - stats.hits, hits);
+        BOOST_CHECK_EQUAL(newStats.misses - stats.misses, misses);
+        stats = newStats;
+    };
+
+    // The first time all the levels are verified, then they are cached
+    CheckDelegation(dg, p, delegatorKey.GetPubKey());
+    checkStats(0, 3);
+    CheckDelegation(dg, p, delegatorKey.GetPubKey());
+    checkStats(3, 0);
+
+    // Only the new level of a longer delegation is verified
+    DelegationBuilder dgb2(dg);
+    CKey delegatedKey = CKey::MakeCompressedKey();
+    BOOST_CHECK(dgb2.addLevel(delegatorKey, delegatedKey.GetPubKey()));
+    const Delegation dgLonger = dgb2.build();
+    CheckDelegation(dgLonger, p, delegatedKey.GetPubKey());
+    checkStats(3, 1);
+
+    // A delegation with the same id but an invalid last signature is not
+    // accepted from the cache
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << dgLonger;
+    ss[ss.size() - 1] ^= 1;
+    Delegation dgBadSig;
+    ss >> dgBadSig;
+    BOOST_CHECK_EQUAL(dgBadSig.getId(), dgLonger.getId());
+
+    DelegationState state;
+    CPubKey auth;
+    BOOST_CHECK(!dgBadSig.verify(state, auth));
+    BOOST_CHECK(state.GetResult() == DelegationResult::INVALID_SIGNATURE);
+    checkStats(3, 1);
+
+    // The invalid level didn't get cached
+    BOOST_CHECK(!dgBadSig.verify(state, auth));
+    checkStats(3, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -148,143 +148,6 @@ struct NoCoolDownFixture : public PeerManagerFixture {
 
 BOOST_FIXTURE_TEST_SUITE(peermanager_tests, PeerManagerFixture)
 
-BOOST_AUTO_TEST_CASE(select_peer_linear) {
-    // No peers.
-    BOOST_CHECK_EQUAL(selectPeerImpl({}, 0, 0), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl({}, 1, 3), NO_PEER);
-
-    // One peer
-    const std::vector<Slot> oneslot = {{100, 100, 23}};
-
-    // Undershoot
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 0, 300), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 42, 300), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 99, 300), NO_PEER);
-
-    // Nailed it
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 100, 300), 23);
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 142, 300), 23);
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 199, 300), 23);
-
-    // Overshoot
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 200, 300), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 242, 300), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(oneslot, 299, 300), NO_PEER);
-
-    // Two peers
-    const std::vector<Slot> twoslots = {{100, 100, 69}, {300, 100, 42}};
-
-    // Undershoot
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 0, 500), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 42, 500), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 99, 500), NO_PEER);
-
-    // First entry
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 100, 500), 69);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 142, 500), 69);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 199, 500), 69);
-
-    // In between
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 200, 500), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 242, 500), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 299, 500), NO_PEER);
-
-    // Second entry
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 300, 500), 42);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 342, 500), 42);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 399, 500), 42);
-
-    // Overshoot
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 400, 500), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 442, 500), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(twoslots, 499, 500), NO_PEER);
-}
-
-BOOST_AUTO_TEST_CASE(select_peer_dichotomic) {
-    std::vector<Slot> slots;
-
-    // 100 peers of size 1 with 1 empty element apart.
-    uint64_t max = 1;
-    for (int i = 0; i < 100; i++) {
-        slots.emplace_back(max, 1, i);
-        max += 2;
-    }
-
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 4, max), NO_PEER);
-
-    // Check that we get what we expect.
-    for (int i = 0; i < 100; i++) {
-        BOOST_CHECK_EQUAL(selectPeerImpl(slots, 2 * i, max), NO_PEER);
-        BOOST_CHECK_EQUAL(selectPeerImpl(slots, 2 * i + 1, max), i);
-    }
-
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, max, max), NO_PEER);
-
-    // Update the slots to be heavily skewed toward the last element.
-    slots[99] = slots[99].withScore(101);
-    max = slots[99].getStop();
-    BOOST_CHECK_EQUAL(max, 300);
-
-    for (int i = 0; i < 100; i++) {
-        BOOST_CHECK_EQUAL(selectPeerImpl(slots, 2 * i, max), NO_PEER);
-        BOOST_CHECK_EQUAL(selectPeerImpl(slots, 2 * i + 1, max), i);
-    }
-
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 200, max), 99);
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 256, max), 99);
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 299, max), 99);
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 300, max), NO_PEER);
-
-    // Update the slots to be heavily skewed toward the first element.
-    for (int i = 0; i < 100; i++) {
-        slots[i] = slots[i].withStart(slots[i].getStart() + 100);
-    }
-
-    slots[0] = Slot(1, slots[0].getStop() - 1, slots[0].getPeerId());
-    slots[99] = slots[99].withScore(1);
-    max = slots[99].getStop();
-    BOOST_CHECK_EQUAL(max, 300);
-
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 0, max), NO_PEER);
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 1, max), 0);
-    BOOST_CHECK_EQUAL(selectPeerImpl(slots, 42, max), 0);
-
-    for (int i = 0; i < 100; i++) {
-        BOOST_CHECK_EQUAL(selectPeerImpl(slots, 100 + 2 * i + 1, max), i);
-        BOOST_CHECK_EQUAL(selectPeerImpl(slots, 100 + 2 * i + 2, max), NO_PEER);
-    }
-}
-
-BOOST_AUTO_TEST_CASE(select_peer_random) {
-    for (int c = 0; c < 1000; c++) {
-        size_t size = InsecureRandBits(10) + 1;
-        std::vector<Slot> slots;
-        slots.reserve(size);
-
-        uint64_t max = InsecureRandBits(3);
-        auto next = [&]() {
-            uint64_t r = max;
-            max += InsecureRandBits(3);
-            return r;
-        };
-
-        for (size_t i = 0; i < size; i++) {
-            const uint64_t start = next();
-            const uint32_t score = InsecureRandBits(3);
-            max += score;
-            slots.emplace_back(start, score, i);
-        }
-
-        for (int k = 0; k < 100; k++) {
-            uint64_t s = max > 0 ? InsecureRandRange(max) : 0;
-            auto i = selectPeerImpl(slots, s, max);
-            // /!\ Because of the way we construct the vector, the peer id is
-            // always the index. This might not be the case in practice.
-            BOOST_CHECK(i == NO_PEER || slots[i].contains(s));
-        }
-    }
-}
-
 static void addNodeWithScore(CChainState &active_chainstate,
                              avalanche::PeerManager &pm, NodeId node,
                              uint32_t score) {
@@ -346,8 +209,7 @@ BOOST_AUTO_TEST_CASE(remove_peer) {
         BOOST_CHECK(pm.addNode(InsecureRand32(), p->getId()));
     }
 
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 400);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 0);
+    BOOST_CHECK(pm.verify());
 
     for (int i = 0; i < 100; i++) {
         PeerId p = pm.selectPeer();
@@ -355,16 +217,9 @@ BOOST_AUTO_TEST_CASE(remove_peer) {
                     p == peerids[3]);
     }
 
-    // Remove one peer, it nevers show up now.
+    // Remove one peer, it nevers show up now and we never get NO_PEER.
     BOOST_CHECK(pm.removePeer(peerids[2]));
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 400);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 100);
-
-    // Make sure we compact to never get NO_PEER.
-    BOOST_CHECK_EQUAL(pm.compact(), 100);
     BOOST_CHECK(pm.verify());
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 300);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 0);
 
     for (int i = 0; i < 100; i++) {
         PeerId p = pm.selectPeer();
@@ -378,23 +233,11 @@ BOOST_AUTO_TEST_CASE(remove_peer) {
         BOOST_CHECK(pm.addNode(InsecureRand32(), p->getId()));
     }
 
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 700);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 0);
+    BOOST_CHECK(pm.verify());
 
     BOOST_CHECK(pm.removePeer(peerids[0]));
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 700);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 100);
-
-    // Removing the last entry do not increase fragmentation.
     BOOST_CHECK(pm.removePeer(peerids[7]));
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 600);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 100);
-
-    // Make sure we compact to never get NO_PEER.
-    BOOST_CHECK_EQUAL(pm.compact(), 100);
     BOOST_CHECK(pm.verify());
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 500);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 0);
 
     for (int i = 0; i < 100; i++) {
         PeerId p = pm.selectPeer();
@@ -409,7 +252,7 @@ BOOST_AUTO_TEST_CASE(remove_peer) {
     BOOST_CHECK(!pm.removePeer(NO_PEER));
 }
 
-BOOST_AUTO_TEST_CASE(compact_slots) {
+BOOST_AUTO_TEST_CASE(remove_all_peers) {
     ChainstateManager &chainman = *Assert(m_node.chainman);
     avalanche::PeerManager pm(chainman);
 
@@ -426,17 +269,10 @@ BOOST_AUTO_TEST_CASE(compact_slots) {
         pm.removePeer(p);
     }
 
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 300);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 300);
-
+    BOOST_CHECK(pm.verify());
     for (int i = 0; i < 100; i++) {
         BOOST_CHECK_EQUAL(pm.selectPeer(), NO_PEER);
     }
-
-    BOOST_CHECK_EQUAL(pm.compact(), 300);
-    BOOST_CHECK(pm.verify());
-    BOOST_CHECK_EQUAL(pm.getSlotCount(), 0);
-    BOOST_CHECK_EQUAL(pm.getFragmentation(), 0);
 }
 
 BOOST_AUTO_TEST_CASE(node_crud) {
@@ -503,6 +339,62 @@ BOOST_AUTO_TEST_CASE(node_crud) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(node_response_time) {
+    ChainstateManager &chainman = *Assert(m_node.chainman);
+    avalanche::PeerManager pm(chainman);
+
+    auto proof = buildRandomProof(chainman.ActiveChainstate(),
+                                  MIN_VALID_PROOF_SCORE);
+    BOOST_CHECK(pm.registerProof(proof));
+    for (NodeId i = 0; i < 3; i++) {
+        BOOST_CHECK(pm.addNode(i, proof->getId()));
+    }
+
+    using namespace std::chrono_literals;
+    auto checkNode = [&](NodeId nodeid, std::chrono::microseconds avg,
+                         uint32_t responses, uint32_t timeouts) {
+        BOOST_CHECK(pm.forNode(nodeid, [&](const Node &n) {
+            BOOST_CHECK_EQUAL(n.avgResponseTime.count(), avg.count());
+            BOOST_CHECK_EQUAL(n.responseCount, responses);
+            BOOST_CHECK_EQUAL(n.timeoutCount, timeouts);
+            return true;
+        }));
+    };
+
+    BOOST_CHECK(!pm.updateResponseTime(3, 10ms));
+
+    // The first response time is used as is, then it is averaged
+    BOOST_CHECK(pm.updateResponseTime(0, 100ms));
+    checkNode(0, 100ms, 1, 0);
+    BOOST_CHECK(pm.updateResponseTime(1, 10ms));
+    BOOST_CHECK(pm.updateResponseTime(1, 18ms));
+    checkNode(1, 11ms, 2, 0);
+
+    // The node that was never polled is selected first so it gets measured
+    BOOST_CHECK_EQUAL(pm.selectNode(), 2);
+    BOOST_CHECK(pm.updateResponseTime(2, 50ms));
+
+    // Then the fastest node is selected
+    for (int i = 0; i < 10; i++) {
+        BOOST_CHECK_EQUAL(pm.selectNode(), 1);
+    }
+
+    // Unless it is not available
+    BOOST_CHECK(
+        pm.updateNextRequestTime(1, std::chrono::steady_clock::now() + 24h));
+    BOOST_CHECK_EQUAL(pm.selectNode(), 2);
+    BOOST_CHECK(pm.updateNextRequestTime(1, std::chrono::steady_clock::now()));
+    BOOST_CHECK_EQUAL(pm.selectNode(), 1);
+
+    // A timeout accounts as a very slow response
+    BOOST_CHECK(pm.updateResponseTime(1, 10s, true));
+    checkNode(1,
+              std::chrono::microseconds(11ms) * 7 / 8 +
+                  std::chrono::microseconds(10s) / 8,
+              2, 1);
+    BOOST_CHECK_EQUAL(pm.selectNode(), 2);
+}
+
 BOOST_AUTO_TEST_CASE(node_binding) {
     ChainstateManager &chainman = *Assert(m_node.chainman);
     avalanche::PeerManager pm(chainman);
@@ -2039,4 +1931,232 @@ BOOST_FIXTURE_TEST_CASE(cleanup_dangling_proof, NoCoolDownFixture) {
     gArgs.ClearForcedArg("-enableavalancheproofreplacement");
 }
 
+BOOST_FIXTURE_TEST_CASE(dump_and_load_peers, NoCoolDownFixture) {
+    ChainstateManager &chainman = *Assert(m_node.chainman);
+    CChainState &active_chainstate = chainman.ActiveChainstate();
+    const fs::path dumpPath = GetDataDir() / "avapeers.dat";
+
+    std::unordered_set<ProofRef, SaltedProofHasher> registeredProofs;
+
+    // Nothing to load yet.
+    {
+        avalanche::PeerManager pm(chainman);
+        BOOST_CHECK(!pm.loadPeersFromFile(dumpPath, registeredProofs));
+        BOOST_CHECK(registeredProofs.empty());
+    }
+
+    const CKey key = CKey::MakeCompressedKey();
+    const auto nextConflictTime = GetTime<std::chrono::seconds>() + 1h;
+
+    std::vector<ProofRef> proofs;
+    std::vector<ProofRef> conflictingProofs;
+    std::vector<ProofRef> orphans;
+    {
+        avalanche::PeerManager pm(chainman);
+        for (size_t i = 0; i < 10; i++) {
+            const COutPoint outpoint = createUtxo(active_chainstate, key);
+            proofs.push_back(buildProofWithSequence(key, {outpoint}, 2));
+            conflictingProofs.push_back(
+                buildProofWithSequence(key, {outpoint}, 1));
+            BOOST_CHECK(pm.registerProof(proofs.back()));
+            BOOST_CHECK(!pm.registerProof(conflictingProofs.back()));
+            BOOST_CHECK(
+                pm.isInConflictingPool(conflictingProofs.back()->getId()));
+
+            // The stake is not mature yet.
+            const COutPoint immature =
+                createUtxo(active_chainstate, key, PROOF_DUST_THRESHOLD, 1000);
+            orphans.push_back(buildProofWithOutpoints(
+                key, {immature}, PROOF_DUST_THRESHOLD, key, 0, 1000));
+            BOOST_CHECK(!pm.registerProof(orphans.back()));
+            BOOST_CHECK(pm.isOrphan(orphans.back()->getId()));
+        }
+
+        // Some peers finalized and some can't have conflicts for a while.
+        for (size_t i = 0; i < proofs.size(); i += 2) {
+            const PeerId peerid =
+                TestPeerManager::getPeerIdForProofId(pm, proofs[i]->getId());
+            BOOST_CHECK(pm.setFinalized(peerid));
+            BOOST_CHECK(
+                pm.updateNextPossibleConflictTime(peerid, nextConflictTime));
+        }
+
+        BOOST_CHECK(pm.dumpPeersToFile(dumpPath));
+    }
+
+    // Spend the stake of one of the peers.
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(active_chainstate.CoinsTip().SpendCoin(
+            proofs[0]->getStakes()[0].getStake().getUTXO()));
+    }
+
+    avalanche::PeerManager pm(chainman);
+    BOOST_CHECK(pm.loadPeersFromFile(dumpPath, registeredProofs));
+    BOOST_CHECK(pm.verify());
+
+    // The proofs with a spent stake are gone.
+    BOOST_CHECK(!pm.exists(proofs[0]->getId()));
+    BOOST_CHECK(!pm.exists(conflictingProofs[0]->getId()));
+    BOOST_CHECK_EQUAL(registeredProofs.size(), proofs.size() - 1);
+
+    std::unordered_set<ProofId, SaltedProofIdHasher> registeredProofIds;
+    for (const ProofRef &proof : registeredProofs) {
+        registeredProofIds.insert(proof->getId());
+    }
+
+    for (size_t i = 1; i < proofs.size(); i++) {
+        BOOST_CHECK(pm.isBoundToPeer(proofs[i]->getId()));
+        BOOST_CHECK_EQUAL(registeredProofIds.count(proofs[i]->getId()), 1);
+        BOOST_CHECK(pm.isInConflictingPool(conflictingProofs[i]->getId()));
+        BOOST_CHECK(pm.forPeer(proofs[i]->getId(), [&](const Peer &peer) {
+            const bool expected = i % 2 == 0;
+            return peer.hasFinalized == expected &&
+                   (peer.nextPossibleConflictTime == nextConflictTime) ==
+                       expected;
+        }));
+    }
+
+    for (const ProofRef &orphan : orphans) {
+        BOOST_CHECK(pm.isOrphan(orphan->getId()));
+    }
+
+    // Loading again doesn't register anything new.
+    BOOST_CHECK(pm.loadPeersFromFile(dumpPath, registeredProofs));
+    BOOST_CHECK(registeredProofs.empty());
+
+    // The proofs can't be loaded with another proof format.
+    gArgs.ForceSetArg("-legacyavaproof", Proof::useLegacy() ? "0" : "1");
+    {
+        avalanche::PeerManager otherFormat(chainman);
+        BOOST_CHECK(!otherFormat.loadPeersFromFile(dumpPath, registeredProofs));
+    }
+    gArgs.ClearForcedArg("-legacyavaproof");
+
+    // A truncated file fails to load.
+    {
+        FILE *file = fsbridge::fopen(dumpPath, "rb+");
+        BOOST_CHECK(file);
+        BOOST_CHECK_EQUAL(fseek(file, 0, SEEK_END), 0);
+        const long size = ftell(file);
+        BOOST_CHECK_EQUAL(ftruncate(fileno(file), size / 2), 0);
+        fclose(file);
+
+        avalanche::PeerManager truncated(chainman);
+        BOOST_CHECK(!truncated.loadPeersFromFile(dumpPath, registeredProofs));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(incremental_tip_update) {
+    ChainstateManager &chainman = *Assert(m_node.chainman);
+    CChainState &active_chainstate = chainman.ActiveChainstate();
+    gArgs.ForceSetArg("-avaproofstakeutxoconfirmations", "2");
+    avalanche::PeerManager pm(chainman);
+
+    const CKey key = CKey::MakeCompressedKey();
+    BOOST_CHECK_EQUAL(chainman.ActiveHeight(), 100);
+
+    // The stake of proofC is the output of a transaction we can put in a
+    // block.
+    CMutableTransaction mtx;
+    mtx.vout.emplace_back(PROOF_DUST_THRESHOLD,
+                          GetScriptForDestination(PKHash(key.GetPubKey())));
+    const CTransactionRef txC = MakeTransactionRef(mtx);
+    const COutPoint outpointC(txC->GetId(), 0);
+    addCoin(active_chainstate, outpointC, key, PROOF_DUST_THRESHOLD, 99);
+
+    const COutPoint outpointA = createUtxo(active_chainstate, key,
+                                           PROOF_DUST_THRESHOLD, 99);
+    const COutPoint outpointB = createUtxo(active_chainstate, key,
+                                           PROOF_DUST_THRESHOLD, 99);
+    const COutPoint outpointOrphan = createUtxo(active_chainstate, key);
+
+    auto proofA = buildProofWithOutpoints(key, {outpointA},
+                                          PROOF_DUST_THRESHOLD, key, 0, 99);
+    auto proofB = buildProofWithOutpoints(key, {outpointB},
+                                          PROOF_DUST_THRESHOLD, key, 0, 99);
+    auto proofC = buildProofWithOutpoints(key, {outpointC},
+                                          PROOF_DUST_THRESHOLD, key, 0, 99);
+    auto orphan = buildProofWithOutpoints(key, {outpointOrphan},
+                                          PROOF_DUST_THRESHOLD, key, 0, 100);
+
+    BOOST_CHECK(pm.registerProof(proofA));
+    BOOST_CHECK(pm.registerProof(proofB));
+    BOOST_CHECK(pm.registerProof(proofC));
+    BOOST_CHECK(!pm.registerProof(orphan));
+    BOOST_CHECK(pm.isOrphan(orphan->getId()));
+
+    // No block is known, this is a full rescan.
+    pm.updatedBlockTip();
+    BOOST_CHECK(pm.isBoundToPeer(proofA->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofB->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofC->getId()));
+    BOOST_CHECK(pm.isOrphan(orphan->getId()));
+
+    // Spend the utxos of proofA and proofB, but only notify the spending of
+    // the utxo from proofA.
+    {
+        LOCK(cs_main);
+        CCoinsViewCache &coins = active_chainstate.CoinsTip();
+        coins.SpendCoin(outpointA);
+        coins.SpendCoin(outpointB);
+    }
+
+    CMutableTransaction spendA;
+    spendA.vin.emplace_back(outpointA);
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(spendA));
+    pm.blockConnected(block);
+
+    // Only proofA is re-evaluated.
+    pm.updatedBlockTip();
+    BOOST_CHECK(!pm.exists(proofA->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofB->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofC->getId()));
+    BOOST_CHECK(pm.isOrphan(orphan->getId()));
+    BOOST_CHECK(pm.verify());
+
+    // Mine a block, the orphan stake is now mature.
+    mineBlocks(1);
+    BOOST_CHECK_EQUAL(chainman.ActiveHeight(), 101);
+    pm.blockConnected(CBlock());
+    BOOST_CHECK_EQUAL(pm.updatedBlockTip().count(orphan), 1);
+    BOOST_CHECK(pm.isBoundToPeer(orphan->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofB->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofC->getId()));
+    BOOST_CHECK(pm.verify());
+
+    // Reorg to a shorter chain, the stake is immature again.
+    {
+        BlockValidationState state;
+        active_chainstate.InvalidateBlock(GetConfig(), state,
+                                          chainman.ActiveTip());
+        BOOST_CHECK_EQUAL(chainman.ActiveHeight(), 100);
+    }
+    pm.blockDisconnected(CBlock(), 101);
+    pm.updatedBlockTip();
+    BOOST_CHECK(pm.isOrphan(orphan->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofB->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofC->getId()));
+    BOOST_CHECK(pm.verify());
+
+    // Disconnecting the block containing the utxo of proofC invalidates it.
+    {
+        LOCK(cs_main);
+        active_chainstate.CoinsTip().SpendCoin(outpointC);
+    }
+    block.vtx = {txC};
+    pm.blockDisconnected(block, 100);
+    pm.updatedBlockTip();
+    BOOST_CHECK(!pm.exists(proofC->getId()));
+    BOOST_CHECK(pm.isBoundToPeer(proofB->getId()));
+    BOOST_CHECK(pm.isOrphan(orphan->getId()));
+
+    // Without any block, all the proofs are re-evaluated.
+    pm.updatedBlockTip();
+    BOOST_CHECK(!pm.exists(proofB->getId()));
+    BOOST_CHECK(pm.isOrphan(orphan->getId()));
+    BOOST_CHECK(pm.verify());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,143 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/peersampler.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+#include <map>
+
+using namespace avalanche;
+
+BOOST_FIXTURE_TEST_SUITE(peersampler_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(add_remove) {
+    PeerSampler sampler;
+
+    // No peers.
+    BOOST_CHECK(sampler.verify());
+    BOOST_CHECK_EQUAL(sampler.size(), 0);
+    BOOST_CHECK_EQUAL(sampler.getTotalScore(), 0);
+    BOOST_CHECK_EQUAL(sampler.select(g_insecure_rand_ctx), NO_PEER);
+
+    // Peers without score can't be selected, so they are not added.
+    BOOST_CHECK(!sampler.add(1, 0));
+    BOOST_CHECK(!sampler.contains(1));
+
+    // One peer, we always return it.
+    BOOST_CHECK(sampler.add(23, 100));
+    BOOST_CHECK(!sampler.add(23, 100));
+    BOOST_CHECK(!sampler.add(23, 42));
+    BOOST_CHECK(sampler.contains(23));
+    BOOST_CHECK(sampler.verify());
+    BOOST_CHECK_EQUAL(sampler.size(), 1);
+    BOOST_CHECK_EQUAL(sampler.getTotalScore(), 100);
+    for (int i = 0; i < 100; i++) {
+        BOOST_CHECK_EQUAL(sampler.select(g_insecure_rand_ctx), 23);
+    }
+
+    // Peers in the same bucket and in other buckets.
+    BOOST_CHECK(sampler.add(42, 127));
+    BOOST_CHECK(sampler.add(69, 1));
+    BOOST_CHECK(sampler.add(70, 1000000));
+    BOOST_CHECK(sampler.verify());
+    BOOST_CHECK_EQUAL(sampler.size(), 4);
+    BOOST_CHECK_EQUAL(sampler.getTotalScore(), 1000228);
+
+    // Remove a peer which is not the last of its bucket, it never shows up.
+    BOOST_CHECK(sampler.remove(23));
+    BOOST_CHECK(!sampler.remove(23));
+    BOOST_CHECK(!sampler.contains(23));
+    BOOST_CHECK(sampler.verify());
+    BOOST_CHECK_EQUAL(sampler.getTotalScore(), 1000128);
+    BOOST_CHECK(sampler.remove(70));
+    BOOST_CHECK(sampler.verify());
+    for (int i = 0; i < 100; i++) {
+        const PeerId p = sampler.select(g_insecure_rand_ctx);
+        BOOST_CHECK(p == 42 || p == 69);
+    }
+
+    // Remove everything.
+    BOOST_CHECK(sampler.remove(42));
+    BOOST_CHECK(sampler.remove(69));
+    BOOST_CHECK(!sampler.remove(NO_PEER));
+    BOOST_CHECK(sampler.verify());
+    BOOST_CHECK_EQUAL(sampler.size(), 0);
+    BOOST_CHECK_EQUAL(sampler.getTotalScore(), 0);
+    BOOST_CHECK_EQUAL(sampler.select(g_insecure_rand_ctx), NO_PEER);
+
+    // Extreme scores.
+    BOOST_CHECK(sampler.add(0, std::numeric_limits<uint32_t>::max()));
+    BOOST_CHECK(sampler.add(1, 1));
+    BOOST_CHECK(sampler.verify());
+    BOOST_CHECK_EQUAL(sampler.getTotalScore(), uint64_t(1) << 32);
+}
+
+BOOST_AUTO_TEST_CASE(probabilities) {
+    PeerSampler sampler;
+
+    // Scores spread over several buckets, and several peers per bucket.
+    const std::vector<uint32_t> scores = {1,   2,   3,    5,    8,   13,
+                                          100, 127, 128,  200,  255, 256,
+                                          300, 999, 1000, 4096, 5000};
+    uint64_t totalScore = 0;
+    for (size_t i = 0; i < scores.size(); i++) {
+        BOOST_CHECK(sampler.add(i, scores[i]));
+        totalScore += scores[i];
+    }
+    BOOST_CHECK(sampler.verify());
+
+    constexpr int DRAWS = 1000000;
+    std::map<PeerId, int> results;
+    for (int i = 0; i < DRAWS; i++) {
+        results[sampler.select(g_insecure_rand_ctx)]++;
+    }
+
+    BOOST_CHECK_EQUAL(results.size(), scores.size());
+    for (size_t i = 0; i < scores.size(); i++) {
+        // Allow 5 standard deviations.
+        const double p = double(scores[i]) / totalScore;
+        const double expected = p * DRAWS;
+        const double deviation = std::sqrt(DRAWS * p * (1 - p));
+        BOOST_CHECK(std::abs(results[i] - expected) < 5 * deviation + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(churn) {
+    PeerSampler sampler;
+    std::map<PeerId, uint32_t> peers;
+
+    for (int i = 0; i < 10000; i++) {
+        if (peers.empty() || InsecureRandBool()) {
+            const PeerId peerid = InsecureRand32() % 1000;
+            const uint32_t score = InsecureRandBits(InsecureRandRange(32) + 1);
+            const bool added = peers.count(peerid) == 0 && score > 0;
+            BOOST_CHECK_EQUAL(sampler.add(peerid, score), added);
+            if (added) {
+                peers.emplace(peerid, score);
+            }
+        } else {
+            auto it = peers.begin();
+            std::advance(it, InsecureRandRange(peers.size()));
+            BOOST_CHECK(sampler.remove(it->first));
+            peers.erase(it);
+        }
+
+        BOOST_CHECK_EQUAL(sampler.size(), peers.size());
+        if (i % 100 == 0) {
+            BOOST_CHECK(sampler.verify());
+        }
+
+        const PeerId p = sampler.select(g_insecure_rand_ctx);
+        BOOST_CHECK(peers.empty() ? p == NO_PEER : peers.count(p) == 1);
+    }
+
+    BOOST_CHECK(sampler.verify());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
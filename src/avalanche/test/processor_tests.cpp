@@ -14,6 +14,7 @@
 #include <net_processing.h> // For ::PeerManager
 #include <reverse_iterator.h>
 #include <scheduler.h>
+#include <txmempool.h>
 #include <util/time.h>
 #include <util/translation.h> // For bilingual_str
 // D6970 moved LookupBlockIndex from chain.h to validation.h TODO: remove this
@@ -110,11 +111,13 @@ struct AvalancheTestingSetup : public TestChain100Setup {
         bilingual_str error;
         m_processor = Processor::MakeProcessor(
             *m_node.args, *m_node.chain, m_node.connman.get(),
-            *Assert(m_node.chainman), *m_node.scheduler, error);
+            *Assert(m_node.chainman), m_node.mempool.get(), *m_node.scheduler,
+            error);
         BOOST_CHECK(m_processor);
 
         gArgs.ForceSetArg("-avaproofstakeutxoconfirmations", "1");
         gArgs.ForceSetArg("-enableavalancheproofreplacement", "1");
+        gArgs.ForceSetArg("-avalanchepreconsensus", "1");
     }
 
     ~AvalancheTestingSetup() {
@@ -123,6 +126,7 @@ struct AvalancheTestingSetup : public TestChain100Setup {
 
         gArgs.ClearForcedArg("-avaproofstakeutxoconfirmations");
         gArgs.ClearForcedArg("-enableavalancheproofreplacement");
+        gArgs.ClearForcedArg("-avalanchepreconsensus");
     }
 
     CNode *ConnectNode(ServiceFlags nServices) {
@@ -206,8 +210,10 @@ struct AvalancheTestingSetup : public TestChain100Setup {
         int banscore;
         std::string error;
         std::vector<avalanche::ProofUpdate> proofUpdates;
+        std::vector<avalanche::TxUpdate> txUpdates;
         return m_processor->registerVotes(nodeid, response, blockUpdates,
-                                          proofUpdates, banscore, error);
+                                          proofUpdates, txUpdates, banscore,
+                                          error);
     }
 };
 
@@ -237,8 +243,10 @@ struct BlockProvider {
                        std::string &error) {
         int banscore;
         std::vector<avalanche::ProofUpdate> proofUpdates;
-        return fixture->m_processor->registerVotes(
-            nodeid, response, updates, proofUpdates, banscore, error);
+        std::vector<avalanche::TxUpdate> txUpdates;
+        return fixture->m_processor->registerVotes(nodeid, response, updates,
+                                                   proofUpdates, txUpdates,
+                                                   banscore, error);
     }
     bool registerVotes(NodeId nodeid, const avalanche::Response &response) {
         std::string error;
@@ -295,8 +303,10 @@ struct ProofProvider {
                        std::string &error) {
         int banscore;
         std::vector<avalanche::BlockUpdate> blockUpdates;
-        return fixture->m_processor->registerVotes(
-            nodeid, response, blockUpdates, updates, banscore, error);
+        std::vector<avalanche::TxUpdate> txUpdates;
+        return fixture->m_processor->registerVotes(nodeid, response,
+                                                   blockUpdates, updates,
+                                                   txUpdates, banscore, error);
     }
     bool registerVotes(NodeId nodeid, const avalanche::Response &response) {
         std::string error;
@@ -331,12 +341,79 @@ struct ProofProvider {
     }
 };
 
+struct TxProvider {
+    AvalancheTestingSetup *fixture;
+
+    std::vector<TxUpdate> updates;
+    uint32_t invType;
+
+    TxProvider(AvalancheTestingSetup *_fixture)
+        : fixture(_fixture), invType(MSG_TX) {}
+
+    CTransactionRef buildVoteItem() const {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint(TxId(InsecureRand256()), 0));
+        mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        const CTransactionRef tx = MakeTransactionRef(std::move(mtx));
+
+        CTxMemPool &mempool = *Assert(fixture->m_node.mempool);
+        LOCK2(cs_main, mempool.cs);
+        mempool.addUnchecked(TestMemPoolEntryHelper().FromTx(tx));
+        return tx;
+    }
+
+    uint256 getVoteItemId(const CTransactionRef &tx) const {
+        return tx->GetId();
+    }
+
+    bool registerVotes(NodeId nodeid, const avalanche::Response &response,
+                       std::string &error) {
+        int banscore;
+        std::vector<avalanche::BlockUpdate> blockUpdates;
+        std::vector<avalanche::ProofUpdate> proofUpdates;
+        return fixture->m_processor->registerVotes(nodeid, response,
+                                                   blockUpdates, proofUpdates,
+                                                   updates, banscore, error);
+    }
+    bool registerVotes(NodeId nodeid, const avalanche::Response &response) {
+        std::string error;
+        return registerVotes(nodeid, response, error);
+    }
+
+    bool addToReconcile(const CTransactionRef &tx) {
+        return fixture->m_processor->addTxToReconcile(tx);
+    }
+
+    std::vector<Vote> buildVotesForItems(uint32_t error,
+                                         std::vector<CTransactionRef> &&items) {
+        size_t numItems = items.size();
+
+        std::vector<Vote> votes;
+        votes.reserve(numItems);
+
+        // Votes are sorted by txid
+        std::sort(items.begin(), items.end(), TxComparatorById());
+        for (auto &item : items) {
+            votes.emplace_back(error, item->GetId());
+        }
+
+        return votes;
+    }
+
+    void invalidateItem(const CTransactionRef &tx) {
+        CTxMemPool &mempool = *Assert(fixture->m_node.mempool);
+        LOCK(mempool.cs);
+        mempool.removeRecursive(*tx, MemPoolRemovalReason::CONFLICT);
+    }
+};
+
 } // namespace
 
 BOOST_FIXTURE_TEST_SUITE(processor_tests, AvalancheTestingSetup)
 
 // FIXME A std::tuple can be used instead of boost::mpl::list after boost 1.67
-using VoteItemProviders = boost::mpl::list<BlockProvider, ProofProvider>;
+using VoteItemProviders =
+    boost::mpl::list<BlockProvider, ProofProvider, TxProvider>;
 
 BOOST_AUTO_TEST_CASE(block_update) {
     CBlockIndex index;
@@ -842,7 +919,8 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(poll_inflight_timeout, P, VoteItemProviders) {
     bilingual_str error;
     m_processor =
         Processor::MakeProcessor(argsman, *m_node.chain, m_node.connman.get(),
-                                 chainman, *m_node.scheduler, error);
+                                 chainman, m_node.mempool.get(),
+                                 *m_node.scheduler, error);
 
     const auto item = provider.buildVoteItem();
     const auto itemid = provider.getVoteItemId(item);
@@ -1296,7 +1374,7 @@ BOOST_AUTO_TEST_CASE(quorum_detection) {
     ChainstateManager &chainman = *Assert(m_node.chainman);
     std::unique_ptr<Processor> processor = Processor::MakeProcessor(
         *m_node.args, *m_node.chain, m_node.connman.get(), chainman,
-        *m_node.scheduler, error);
+        m_node.mempool.get(), *m_node.scheduler, error);
 
     BOOST_CHECK(processor != nullptr);
     BOOST_CHECK(processor->getLocalProof() != nullptr);
@@ -1465,7 +1543,8 @@ BOOST_AUTO_TEST_CASE(quorum_detection_parameter_validation) {
         bilingual_str error;
         std::unique_ptr<Processor> processor = Processor::MakeProcessor(
             *m_node.args, *m_node.chain, m_node.connman.get(),
-            *Assert(m_node.chainman), *m_node.scheduler, error);
+            *Assert(m_node.chainman), m_node.mempool.get(), *m_node.scheduler,
+            error);
 
         if (std::get<3>(*it)) {
             BOOST_CHECK(processor != nullptr);
@@ -1497,7 +1576,7 @@ BOOST_AUTO_TEST_CASE(min_avaproofs_messages) {
         bilingual_str error;
         auto processor = Processor::MakeProcessor(
             argsman, *m_node.chain, m_node.connman.get(), chainman,
-            *m_node.scheduler, error);
+            m_node.mempool.get(), *m_node.scheduler, error);
 
         auto addNode = [&](NodeId nodeid) {
             auto proof = buildRandomProof(chainman.ActiveChainstate(),
@@ -1562,7 +1641,8 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(voting_parameters, P, VoteItemProviders) {
     bilingual_str error;
     m_processor = Processor::MakeProcessor(
         *m_node.args, *m_node.chain, m_node.connman.get(),
-        *Assert(m_node.chainman), *m_node.scheduler, error);
+        *Assert(m_node.chainman), m_node.mempool.get(), *m_node.scheduler,
+        error);
 
     BOOST_CHECK(m_processor != nullptr);
     BOOST_CHECK(error.empty());
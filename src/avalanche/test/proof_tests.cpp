@@ -78,6 +78,106 @@ struct TestVector {
     ProofValidationResult result;
 };
 
+BOOST_AUTO_TEST_CASE(batch_verify_signatures) {
+    const auto buildProof = [](uint64_t sequence, size_t numStakes) {
+        auto key = CKey::MakeCompressedKey();
+        ProofBuilder pb(sequence, 0, key);
+        for (size_t i = 0; i < numStakes; i++) {
+            key.MakeNewKey(true);
+            BOOST_CHECK(pb.addUTXO(COutPoint(TxId(GetRandHash()), 0),
+                                   10 * COIN, 100, false, key));
+        }
+        return pb.build();
+    };
+
+    // Reusing the stakes of a proof with another sequence invalidates the
+    // stake signatures, which commit to the proof.
+    const auto forgeProof = [](const ProofRef &proof) {
+        return ProofRef::make(proof->getSequence() + 1,
+                              proof->getExpirationTime(), proof->getMaster(),
+                              proof->getStakes(), proof->getPayoutScript(),
+                              SchnorrSig());
+    };
+
+    std::vector<ProofRef> proofs;
+    for (size_t i = 0; i < 10; i++) {
+        proofs.push_back(buildProof(i, i + 1));
+    }
+
+    BOOST_CHECK(VerifyProofSignatures({}));
+    BOOST_CHECK(VerifyProofSignatures(proofs));
+    for (const ProofRef &proof : proofs) {
+        ProofValidationState state;
+        BOOST_CHECK(proof->verify(state));
+    }
+
+    // A single invalid proof fails the batch, but the valid ones are still
+    // found to be valid.
+    std::vector<ProofRef> fresh;
+    for (size_t i = 0; i < 10; i++) {
+        fresh.push_back(buildProof(i, 3));
+    }
+    const ProofRef forged = forgeProof(fresh[5]);
+    fresh.push_back(forged);
+    BOOST_CHECK(!VerifyProofSignatures(fresh));
+    BOOST_CHECK(!VerifyProofSignatures({forged}));
+    BOOST_CHECK(VerifyProofSignatures({fresh[0], fresh[9]}));
+
+    for (const ProofRef &proof : fresh) {
+        ProofValidationState state;
+        const bool valid = proof != forged;
+        BOOST_CHECK_EQUAL(proof->verify(state), valid);
+        BOOST_CHECK(state.GetResult() ==
+                    (valid ? ProofValidationResult::NONE
+                           : ProofValidationResult::INVALID_STAKE_SIGNATURE));
+    }
+
+    // The invalid stake is reported when verifying a single proof, even if
+    // the master and other stake signatures are valid. With the regular
+    // format, the stakes don't commit to the other stakes so they can be
+    // mixed.
+    gArgs.ForceSetArg("-legacyavaproof", "0");
+
+    const CKey masterKey = CKey::MakeCompressedKey();
+    const CScript payoutScript =
+        GetScriptForDestination(PKHash(masterKey.GetPubKey()));
+    ProofBuilder pb(42, 0, masterKey, payoutScript);
+    for (size_t i = 0; i < 100; i++) {
+        BOOST_CHECK(pb.addUTXO(COutPoint(TxId(GetRandHash()), 0), 10 * COIN,
+                               100, false, CKey::MakeCompressedKey()));
+    }
+    std::vector<SignedStake> stakes = pb.build()->getStakes();
+
+    // This stake is signed for another master.
+    const SignedStake otherStake = buildProof(43, 1)->getStakes()[0];
+    stakes[50] = otherStake;
+    std::sort(stakes.begin(), stakes.end(),
+              [](const SignedStake &a, const SignedStake &b) {
+                  return a.getStake().getId() < b.getStake().getId();
+              });
+
+    const auto unsignedProof =
+        ProofRef::make(42, 0, masterKey.GetPubKey(), stakes, payoutScript,
+                       SchnorrSig());
+    SchnorrSig proofSignature;
+    BOOST_CHECK(
+        masterKey.SignSchnorr(unsignedProof->getLimitedId(), proofSignature));
+    const ProofRef mixed =
+        ProofRef::make(42, 0, masterKey.GetPubKey(), std::move(stakes),
+                       payoutScript, proofSignature);
+
+    ProofValidationState state;
+    BOOST_CHECK(!mixed->verify(state));
+    BOOST_CHECK(state.GetResult() ==
+                ProofValidationResult::INVALID_STAKE_SIGNATURE);
+    BOOST_CHECK_EQUAL(
+        state.GetDebugMessage(),
+        strprintf("TxId: %s",
+                  otherStake.getStake().getUTXO().GetTxId().ToString()));
+
+    gArgs.ClearForcedArg("-legacyavaproof");
+}
+
 BOOST_AUTO_TEST_CASE(deserialization) {
     // All stakes signed using the key:
     // KydYrKDNsVnY5uhpLyC4UmazuJvUjNoKJhEEv9f1mdK1D5zcnMSM
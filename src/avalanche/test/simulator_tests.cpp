@@ -0,0 +1,118 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/simulator.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace avalanche;
+
+BOOST_FIXTURE_TEST_SUITE(simulator_tests, BasicTestingSetup)
+
+static SimulationParams GetTestParams() {
+    SimulationParams params;
+    params.numNodes = 30;
+    params.numItems = 20;
+    return params;
+}
+
+BOOST_AUTO_TEST_CASE(finalize_all_items) {
+    const SimulationParams params = GetTestParams();
+    const SimulationResult result = RunSimulation(params);
+
+    // Every node finalized every item.
+    BOOST_CHECK_EQUAL(result.unfinalizedItems, 0);
+    BOOST_CHECK_EQUAL(result.staleItems, 0);
+    BOOST_CHECK_EQUAL(result.invalidItems, 0);
+    BOOST_CHECK_EQUAL(result.finalizationLatencies.size(),
+                      params.numNodes * params.numItems);
+    BOOST_CHECK_EQUAL(result.cpuTimePerNode.size(), params.numNodes);
+
+    // Nothing gets lost nor times out, but some polls may still be in flight
+    // when the last item finalizes.
+    BOOST_CHECK_EQUAL(result.messagesLost, 0);
+    BOOST_CHECK_EQUAL(result.queriesTimedOut, 0);
+    BOOST_CHECK(result.responsesSent <= result.pollsSent);
+    BOOST_CHECK(result.responsesSent > 0);
+    BOOST_CHECK(result.votesRegistered >= result.finalizationLatencies.size() *
+                                              AVALANCHE_FINALIZATION_SCORE);
+
+    // Each item needs at least one round trip to finalize.
+    const auto fastest = result.getFinalizationLatencyPercentile(0);
+    const auto median = result.getFinalizationLatencyPercentile(50);
+    const auto slowest = result.getFinalizationLatencyPercentile(100);
+    BOOST_CHECK(fastest == result.finalizationLatencies.front());
+    BOOST_CHECK(slowest == result.finalizationLatencies.back());
+    BOOST_CHECK(fastest <= median);
+    BOOST_CHECK(median <= slowest);
+    BOOST_CHECK(fastest >= 2 * params.minLatency);
+    BOOST_CHECK(slowest <= result.duration);
+}
+
+BOOST_AUTO_TEST_CASE(deterministic) {
+    SimulationParams params = GetTestParams();
+    params.lossPercent = 10;
+    params.stakeParetoShape = 1.5;
+
+    const SimulationResult result = RunSimulation(params);
+    const SimulationResult same = RunSimulation(params);
+    BOOST_CHECK(result.finalizationLatencies == same.finalizationLatencies);
+    BOOST_CHECK_EQUAL(result.pollsSent, same.pollsSent);
+    BOOST_CHECK_EQUAL(result.messagesLost, same.messagesLost);
+    BOOST_CHECK(result.duration == same.duration);
+
+    params.seed = 1;
+    const SimulationResult other = RunSimulation(params);
+    BOOST_CHECK(result.finalizationLatencies != other.finalizationLatencies);
+}
+
+BOOST_AUTO_TEST_CASE(message_loss) {
+    SimulationParams params = GetTestParams();
+    params.lossPercent = 20;
+    params.queryTimeout = std::chrono::milliseconds{500};
+
+    const SimulationResult result = RunSimulation(params);
+    BOOST_CHECK(result.messagesLost > 0);
+    BOOST_CHECK(result.queriesTimedOut > 0);
+    BOOST_CHECK(result.responsesSent < result.pollsSent);
+    BOOST_CHECK_EQUAL(result.unfinalizedItems, 0);
+
+    // Losing messages slows finalization down.
+    const SimulationResult lossless = RunSimulation(GetTestParams());
+    BOOST_CHECK(result.getFinalizationLatencyPercentile(50) >
+                lossless.getFinalizationLatencyPercentile(50));
+}
+
+BOOST_AUTO_TEST_CASE(dishonest_nodes) {
+    SimulationParams params = GetTestParams();
+
+    // A dishonest minority can't prevent the honest nodes from finalizing.
+    params.dishonestPercent = 10;
+    SimulationResult result = RunSimulation(params);
+    BOOST_CHECK_EQUAL(result.unfinalizedItems, 0);
+    BOOST_CHECK_EQUAL(result.staleItems, 0);
+
+    // A dishonest majority causes the items to be rejected.
+    params.dishonestPercent = 90;
+    result = RunSimulation(params);
+    BOOST_CHECK(result.invalidItems > 0);
+}
+
+BOOST_AUTO_TEST_CASE(max_duration) {
+    SimulationParams params = GetTestParams();
+    params.maxDuration = std::chrono::milliseconds{1000};
+
+    // Not enough time to finalize anything.
+    const SimulationResult result = RunSimulation(params);
+    BOOST_CHECK_EQUAL(result.unfinalizedItems,
+                      params.numNodes * params.numItems);
+    BOOST_CHECK(result.finalizationLatencies.empty());
+    BOOST_CHECK(result.getFinalizationLatencyPercentile(50) ==
+                std::chrono::microseconds{0});
+    BOOST_CHECK(result.duration <= params.maxDuration);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
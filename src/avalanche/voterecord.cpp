@@ -10,78 +10,90 @@
 
 namespace avalanche {
 
-bool VoteRecord::registerVote(NodeId nodeid, uint32_t error) {
+bool VoteRecord::registerVote(NodeId nodeid, uint32_t error) const {
     // We just got a new vote, so there is one less inflight request.
     clearInflightRequest();
 
-    // We want to avoid having the same node voting twice in a quorum.
-    if (!addNodeToQuorum(nodeid)) {
-        return false;
-    }
+    const uint16_t h = getNodeFilterHash(nodeid);
+
+    uint64_t current = state.load();
+    while (true) {
+        const uint32_t successfulVotes = getSuccessfulVotesField(current);
 
-    /**
-     * The result of the vote is determined from the error code. If the error
-     * code is 0, there is no error and therefore the vote is yes. If there is
-     * an error, we check the most significant bit to decide if the vote is a no
-     * (for instance, the block is invalid) or is the vote inconclusive (for
-     * instance, the queried node does not have the block yet).
-     */
-    votes = (votes << 1) | (error == 0);
-    consider = (consider << 1) | (int32_t(error) >= 0);
-
-    /**
-     * We compute the number of yes and/or no votes as follow:
-     *
-     * votes:     1010
-     * consider:  1100
-     *
-     * yes votes: 1000 using votes & consider
-     * no votes:  0100 using ~votes & consider
-     */
-    bool yes = countBits(votes & consider & 0xff) > 6;
-    if (!yes) {
-        bool no = countBits(~votes & consider & 0xff) > 6;
-        if (!no) {
-            // The round is inconclusive.
+        // We want to avoid having the same node voting twice in a quorum.
+        if (isInQuorum(h, successfulVotes)) {
             return false;
         }
-    }
 
-    // If the round is in agreement with previous rounds, increase confidence.
-    if (isAccepted() == yes) {
-        confidence += 2;
-        return getConfidence() == AVALANCHE_FINALIZATION_SCORE;
-    }
+        /**
+         * The result of the vote is determined from the error code. If the
+         * error code is 0, there is no error and therefore the vote is yes. If
+         * there is an error, we check the most significant bit to decide if
+         * the vote is a no (for instance, the block is invalid) or is the vote
+         * inconclusive (for instance, the queried node does not have the block
+         * yet).
+         */
+        const uint8_t votes = (getVotesField(current) << 1) | (error == 0);
+        const uint8_t consider =
+            (getConsiderField(current) << 1) | (int32_t(error) >= 0);
+
+        /**
+         * We compute the number of yes and/or no votes as follow:
+         *
+         * votes:     1010
+         * consider:  1100
+         *
+         * yes votes: 1000 using votes & consider
+         * no votes:  0100 using ~votes & consider
+         */
+        uint16_t confidence = getConfidenceField(current);
+        bool changed = false;
+        const bool yes = countBits(votes & consider & 0xff) > 6;
+        if (yes || countBits(~votes & consider & 0xff) > 6) {
+            if (bool(confidence & 0x01) == yes) {
+                // If the round is in agreement with previous rounds, increase
+                // confidence.
+                confidence += 2;
+                changed = (confidence >> 1) == AVALANCHE_FINALIZATION_SCORE;
+            } else {
+                // The round changed our state. We reset the confidence.
+                confidence = yes;
+                changed = true;
+            }
+        }
 
-    // The round changed our state. We reset the confidence.
-    confidence = yes;
-    return true;
+        const uint64_t next =
+            packState(confidence, votes, consider, successfulVotes + 1);
+        if (state.compare_exchange_weak(current, next)) {
+            /**
+             * Add the node which just voted to the filter. A concurrent vote
+             * may check the filter before this slot is updated, which is fine
+             * as the filter is probabilistic anyway.
+             */
+            nodeFilter[successfulVotes % nodeFilter.size()] = h;
+            return changed;
+        }
+    }
 }
 
-bool VoteRecord::addNodeToQuorum(NodeId nodeid) {
+uint16_t VoteRecord::getNodeFilterHash(NodeId nodeid) const {
     // MMIX Linear Congruent Generator.
     const uint64_t r1 =
         6364136223846793005 * uint64_t(nodeid) + 1442695040888963407;
     // Fibonacci hashing.
     const uint64_t r2 = 11400714819323198485ull * (nodeid ^ seed);
     // Combine and extract hash.
-    const uint16_t h = (r1 + r2) >> 48;
+    return (r1 + r2) >> 48;
+}
 
-    /**
-     * Check if the node is in the filter.
-     */
+bool VoteRecord::isInQuorum(uint16_t h, uint32_t successfulVotes) const {
     for (size_t i = 1; i < nodeFilter.size(); i++) {
         if (nodeFilter[(successfulVotes + i) % nodeFilter.size()] == h) {
-            return false;
+            return true;
         }
     }
 
-    /**
-     * Add the node which just voted to the filter.
-     */
-    nodeFilter[successfulVotes % nodeFilter.size()] = h;
-    successfulVotes++;
-    return true;
+    return false;
 }
 
 bool VoteRecord::registerPoll() const {
@@ -9,6 +9,7 @@
 
 #include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 /**
@@ -43,62 +44,81 @@ namespace avalanche {
 
 /**
  * Vote history.
+ *
+ * The vote state is packed into a single atomic word so that votes can be
+ * registered concurrently through a read only view of the vote records.
  */
 struct VoteRecord {
 private:
-    // confidence's LSB bit is the result. Higher bits are actual confidence
-    // score.
-    uint16_t confidence = 0;
-
-    // Historical record of votes.
-    uint8_t votes = 0;
-    // Each bit indicate if the vote is to be considered.
-    uint8_t consider = 0;
+    /**
+     * Packed vote state, from the least significant bits:
+     *  - confidence (16 bits): the LSB is the result, higher bits are the
+     *    actual confidence score;
+     *  - votes (8 bits): historical record of votes;
+     *  - consider (8 bits): each bit indicate if the vote is to be considered;
+     *  - successfulVotes (32 bits): track how many successful votes occured.
+     */
+    mutable std::atomic<uint64_t> state;
+
     // How many in flight requests exists for this element.
     mutable std::atomic<uint8_t> inflight{0};
 
     // Seed for pseudorandom operations.
     const uint32_t seed = 0;
 
-    // Track how many successful votes occured.
-    uint32_t successfulVotes = 0;
-
     // Track the nodes which are part of the quorum.
-    std::array<uint16_t, 8> nodeFilter{{0, 0, 0, 0, 0, 0, 0, 0}};
+    mutable std::array<std::atomic<uint16_t>, 8> nodeFilter{{0, 0, 0, 0, 0, 0, 0, 0}};
+
+    static uint16_t getConfidenceField(uint64_t s) { return s & 0xffff; }
+    static uint8_t getVotesField(uint64_t s) { return (s >> 16) & 0xff; }
+    static uint8_t getConsiderField(uint64_t s) { return (s >> 24) & 0xff; }
+    static uint32_t getSuccessfulVotesField(uint64_t s) { return s >> 32; }
+
+    static uint64_t packState(uint16_t confidence, uint8_t votes,
+                              uint8_t consider, uint32_t successfulVotes) {
+        return uint64_t(confidence) | (uint64_t(votes) << 16) |
+               (uint64_t(consider) << 24) | (uint64_t(successfulVotes) << 32);
+    }
 
 public:
-    explicit VoteRecord(bool accepted) : confidence(accepted) {}
+    explicit VoteRecord(bool accepted) : state(packState(accepted, 0, 0, 0)) {}
 
     /**
      * Copy semantic
      */
     VoteRecord(const VoteRecord &other)
-        : confidence(other.confidence), votes(other.votes),
-          consider(other.consider), inflight(other.inflight.load()),
-          successfulVotes(other.successfulVotes), nodeFilter(other.nodeFilter) {
+        : state(other.state.load()), inflight(other.inflight.load()) {
+        for (size_t i = 0; i < nodeFilter.size(); i++) {
+            nodeFilter[i] = other.nodeFilter[i].load();
+        }
     }
 
     /**
      * Vote accounting facilities.
      */
-    bool isAccepted() const { return confidence & 0x01; }
+    bool isAccepted() const { return getConfidenceField(state) & 0x01; }
 
-    uint16_t getConfidence() const { return confidence >> 1; }
+    uint16_t getConfidence() const { return getConfidenceField(state) >> 1; }
     bool hasFinalized() const {
         return getConfidence() >= AVALANCHE_FINALIZATION_SCORE;
     }
 
     bool isStale(uint32_t staleThreshold = AVALANCHE_VOTE_STALE_THRESHOLD,
                  uint32_t staleFactor = AVALANCHE_VOTE_STALE_FACTOR) const {
+        const uint64_t s = state;
+        const uint32_t successfulVotes = getSuccessfulVotesField(s);
         return successfulVotes > staleThreshold &&
-               successfulVotes > getConfidence() * staleFactor;
+               successfulVotes >
+                   uint32_t(getConfidenceField(s) >> 1) * staleFactor;
     }
 
     /**
      * Register a new vote for an item and update confidence accordingly.
      * Returns true if the acceptance or finalization state changed.
+     * Like registerPoll, this is made const and thread safe so it can be
+     * called via a read only view of the vote records.
      */
-    bool registerVote(NodeId nodeid, uint32_t error);
+    bool registerVote(NodeId nodeid, uint32_t error) const;
 
     /**
      * Register that a request is being made regarding that item.
@@ -115,15 +135,19 @@ public:
     /**
      * Clear `count` inflight requests.
      */
-    void clearInflightRequest(uint8_t count = 1) { inflight -= count; }
+    void clearInflightRequest(uint8_t count = 1) const { inflight -= count; }
 
 private:
     /**
-     * Add the node to the quorum.
-     * Returns true if the node was added, false if the node already was in the
-     * quorum.
+     * Compute the hash identifying the node in the quorum filter.
+     */
+    uint16_t getNodeFilterHash(NodeId nodeid) const;
+
+    /**
+     * Check if the node is in the quorum, as of `successfulVotes` successful
+     * votes.
      */
-    bool addNodeToQuorum(NodeId nodeid);
+    bool isInQuorum(uint16_t h, uint32_t successfulVotes) const;
 };
 
 } // namespace avalanche
@@ -0,0 +1,130 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/peermanager.h>
+#include <avalanche/proofbuilder.h>
+#include <bench/bench.h>
+#include <key.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/system.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr size_t NUM_PROOFS = 10000;
+static constexpr size_t NUM_STAKES = 100;
+static constexpr Amount STAKE_AMOUNT = 10 * avalanche::PROOF_DUST_THRESHOLD;
+
+/**
+ * Signing the stakes takes a while, so the proofs are built once and shared by
+ * the benchmarks. The stakes are confirmed at the genesis block height.
+ */
+static const std::vector<avalanche::ProofRef> &GetProofs() {
+    static const std::vector<avalanche::ProofRef> proofs = [] {
+        const CKey key = CKey::MakeCompressedKey();
+        FastRandomContext rng(/* fDeterministic */ true);
+
+        std::vector<avalanche::ProofRef> ret;
+        ret.reserve(NUM_PROOFS);
+        for (size_t i = 0; i < NUM_PROOFS; i++) {
+            avalanche::ProofBuilder pb(0, 0, key);
+            for (size_t j = 0; j < NUM_STAKES; j++) {
+                bool added = pb.addUTXO(COutPoint(TxId(rng.rand256()), 0),
+                                        STAKE_AMOUNT, 0, false, key);
+                assert(added);
+            }
+            ret.push_back(pb.build());
+        }
+
+        bool verified = avalanche::VerifyProofSignatures(ret);
+        assert(verified);
+        return ret;
+    }();
+
+    return proofs;
+}
+
+/**
+ * Update the tip of a peer manager holding 10k proofs of 100 stakes each,
+ * after a block which doesn't spend any of the stakes. Either the block is
+ * known and only the proofs it affects are re-evaluated, or all the proofs
+ * are.
+ */
+static void UpdatedBlockTip(benchmark::Bench &bench, bool notifyBlock) {
+    constexpr size_t NUM_BLOCK_INPUTS = 2000;
+
+    TestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */
+        {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+    gArgs.ForceSetArg("-avaproofstakeutxoconfirmations", "1");
+
+    const std::vector<avalanche::ProofRef> &proofs = GetProofs();
+
+    ChainstateManager &chainman = *test_setup.m_node.chainman;
+    {
+        LOCK(cs_main);
+        CCoinsViewCache &coins = chainman.ActiveChainstate().CoinsTip();
+        for (const avalanche::ProofRef &proof : proofs) {
+            for (const avalanche::SignedStake &ss : proof->getStakes()) {
+                const avalanche::Stake &s = ss.getStake();
+                const CScript script =
+                    GetScriptForDestination(PKHash(s.getPubkey()));
+                coins.AddCoin(s.getUTXO(),
+                              Coin(CTxOut(s.getAmount(), script),
+                                   s.getHeight(), s.isCoinbase()),
+                              false);
+            }
+        }
+    }
+
+    avalanche::PeerManager pm(chainman);
+    for (const avalanche::ProofRef &proof : proofs) {
+        bool ret = pm.registerProof(proof);
+        assert(ret);
+    }
+
+    // The block spends coins that are not staked.
+    FastRandomContext rng(/* fDeterministic */ true);
+    CBlock block;
+    for (size_t i = 0; i < NUM_BLOCK_INPUTS; i++) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint(TxId(rng.rand256()), 0));
+        tx.vout.emplace_back(STAKE_AMOUNT, CScript() << OP_TRUE);
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    // Evaluate all the proofs once, the following updates are incremental.
+    pm.updatedBlockTip();
+
+    bench.minEpochIterations(10).unit("block").run([&] {
+        if (notifyBlock) {
+            pm.blockConnected(block);
+        }
+        pm.updatedBlockTip();
+    });
+
+    assert(pm.getTotalPeersScore() > 0);
+    gArgs.ClearForcedArg("-avaproofstakeutxoconfirmations");
+}
+
+static void AvalanchePeerManagerUpdatedBlockTip(benchmark::Bench &bench) {
+    UpdatedBlockTip(bench, true);
+}
+
+static void
+AvalanchePeerManagerUpdatedBlockTipFullRescan(benchmark::Bench &bench) {
+    UpdatedBlockTip(bench, false);
+}
+
+BENCHMARK(AvalanchePeerManagerUpdatedBlockTip);
+BENCHMARK(AvalanchePeerManagerUpdatedBlockTipFullRescan);
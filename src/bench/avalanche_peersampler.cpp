@@ -0,0 +1,70 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/peersampler.h>
+#include <bench/bench.h>
+#include <random.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr size_t NUM_PEERS = 20000;
+static constexpr size_t SELECTIONS_PER_CHURN = 16;
+
+using avalanche::PeerSampler;
+
+static uint32_t RandomScore(FastRandomContext &rng) {
+    // Most peers have a small stake, a few have a large one.
+    return rng.randbits(rng.randrange(20) + 1) + 1;
+}
+
+static void FillPeerSampler(PeerSampler &sampler, FastRandomContext &rng) {
+    for (size_t i = 0; i < NUM_PEERS; i++) {
+        sampler.add(i, RandomScore(rng));
+    }
+}
+
+static void AvalanchePeerSelection(benchmark::Bench &bench) {
+    FastRandomContext rng(/* fDeterministic */ true);
+    PeerSampler sampler;
+    FillPeerSampler(sampler, rng);
+
+    bench.unit("selection").run([&] {
+        const PeerId p = sampler.select(rng);
+        assert(p != NO_PEER);
+    });
+}
+
+/**
+ * Replace a random peer with a new one every few selections, as proofs get
+ * registered and nodes disconnect.
+ */
+static void AvalanchePeerSelectionChurn(benchmark::Bench &bench) {
+    FastRandomContext rng(/* fDeterministic */ true);
+    PeerSampler sampler;
+    FillPeerSampler(sampler, rng);
+
+    std::vector<PeerId> peerids(NUM_PEERS);
+    for (size_t i = 0; i < NUM_PEERS; i++) {
+        peerids[i] = i;
+    }
+    PeerId nextPeerId = NUM_PEERS;
+
+    bench.batch(SELECTIONS_PER_CHURN).unit("selection").run([&] {
+        PeerId &peerid = peerids[rng.randrange(NUM_PEERS)];
+        bool ret = sampler.remove(peerid);
+        assert(ret);
+        peerid = nextPeerId++;
+        ret = sampler.add(peerid, RandomScore(rng));
+        assert(ret);
+
+        for (size_t i = 0; i < SELECTIONS_PER_CHURN; i++) {
+            const PeerId p = sampler.select(rng);
+            assert(p != NO_PEER);
+        }
+    });
+}
+
+BENCHMARK(AvalanchePeerSelection);
+BENCHMARK(AvalanchePeerSelectionChurn);
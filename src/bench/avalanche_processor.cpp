@@ -0,0 +1,127 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/processor.h>
+#include <avalanche/protocol.h>
+#include <bench/bench.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <util/system.h>
+#include <util/translation.h>
+#include <validation.h>
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+static constexpr size_t NUM_TXS = 20000;
+static constexpr NodeId NUM_NODES = 16;
+
+namespace avalanche {
+namespace {
+    struct AvalancheTest {
+        static std::vector<CInv> getInvsForNextPoll(Processor &p) {
+            return p.getInvsForNextPoll();
+        }
+
+        /** Register the query as if the poll was sent to the node. */
+        static uint64_t registerQuery(Processor &p, NodeId nodeid,
+                                      std::vector<CInv> invs) {
+            const uint64_t round = p.round++;
+            const auto now = std::chrono::steady_clock::now();
+            p.queries.getWriteView()->insert(
+                {nodeid, round, now, now + std::chrono::hours(1),
+                 std::move(invs)});
+            return round;
+        }
+    };
+} // namespace
+} // namespace avalanche
+
+/**
+ * Poll the transactions of a mempool holding tens of thousands of them and
+ * register the votes, the way the avalanche event loop and the message handler
+ * do. The finalized transactions are voted on again, so the number of
+ * transactions being voted on remains constant.
+ */
+static void AvalancheTxPolling(benchmark::Bench &bench) {
+    TestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */
+        {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+    gArgs.ForceSetArg("-avalanchepreconsensus", "1");
+
+    NodeContext &node = test_setup.m_node;
+    bilingual_str error;
+    std::unique_ptr<avalanche::Processor> processor =
+        avalanche::Processor::MakeProcessor(
+            *node.args, *node.chain, node.connman.get(), *node.chainman,
+            node.mempool.get(), *node.scheduler, error);
+    assert(processor);
+
+    CTxMemPool &mempool = *node.mempool;
+    FastRandomContext rng(/* fDeterministic */ true);
+    std::vector<CTransactionRef> txs;
+    txs.reserve(NUM_TXS);
+    {
+        LOCK2(cs_main, mempool.cs);
+        for (size_t i = 0; i < NUM_TXS; i++) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(COutPoint(TxId(rng.rand256()), 0));
+            mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+            txs.push_back(MakeTransactionRef(std::move(mtx)));
+            mempool.addUnchecked(TestMemPoolEntryHelper().FromTx(txs.back()));
+        }
+    }
+
+    for (const CTransactionRef &tx : txs) {
+        bool added = processor->addTxToReconcile(tx);
+        assert(added);
+    }
+
+    NodeId nodeid = 0;
+    bench.batch(AVALANCHE_MAX_ELEMENT_POLL).unit("vote").run([&] {
+        std::vector<CInv> invs =
+            avalanche::AvalancheTest::getInvsForNextPoll(*processor);
+        assert(invs.size() == AVALANCHE_MAX_ELEMENT_POLL);
+
+        std::vector<avalanche::Vote> votes;
+        votes.reserve(invs.size());
+        for (const CInv &inv : invs) {
+            votes.emplace_back(0, inv.hash);
+        }
+
+        nodeid = (nodeid + 1) % NUM_NODES;
+        const uint64_t round = avalanche::AvalancheTest::registerQuery(
+            *processor, nodeid, std::move(invs));
+
+        std::vector<avalanche::BlockUpdate> blockUpdates;
+        std::vector<avalanche::ProofUpdate> proofUpdates;
+        std::vector<avalanche::TxUpdate> txUpdates;
+        int banscore;
+        std::string voteError;
+        bool registered = processor->registerVotes(
+            nodeid, avalanche::Response(round, 0, std::move(votes)),
+            blockUpdates, proofUpdates, txUpdates, banscore, voteError);
+        assert(registered);
+
+        for (avalanche::TxUpdate &u : txUpdates) {
+            if (u.getStatus() == avalanche::VoteStatus::Finalized) {
+                processor->addTxToReconcile(u.getVoteItem());
+            }
+        }
+    });
+
+    processor.reset();
+    gArgs.ClearForcedArg("-avalanchepreconsensus");
+}
+
+BENCHMARK(AvalancheTxPolling);
@@ -0,0 +1,150 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/proof.h>
+#include <avalanche/proofbuilder.h>
+#include <avalanche/validation.h>
+#include <bench/bench.h>
+#include <key.h>
+#include <random.h>
+#include <streams.h>
+
+#include <cassert>
+#include <vector>
+
+using namespace avalanche;
+
+static std::vector<ProofRef> BuildProofs(size_t numProofs, size_t minStakes,
+                                         size_t maxStakes) {
+    FastRandomContext rng(/* fDeterministic */ true);
+
+    std::vector<ProofRef> proofs;
+    for (size_t i = 0; i < numProofs; i++) {
+        ProofBuilder pb(i, 0, CKey::MakeCompressedKey());
+        const size_t numStakes =
+            minStakes + rng.randrange(maxStakes - minStakes + 1);
+        for (size_t j = 0; j < numStakes; j++) {
+            bool ret = pb.addUTXO(COutPoint(TxId(rng.rand256()), 0),
+                                  int64_t(10 + rng.randrange(1000)) * COIN,
+                                  100 + rng.randrange(100000), false,
+                                  CKey::MakeCompressedKey());
+            assert(ret);
+        }
+        proofs.push_back(pb.build());
+    }
+
+    return proofs;
+}
+
+/**
+ * A proof doesn't get its signatures verified twice, so deserialize fresh
+ * copies of the proofs before verifying them.
+ */
+static std::vector<ProofRef>
+CopyProofs(const std::vector<CDataStream> &serialized) {
+    std::vector<ProofRef> proofs;
+    proofs.reserve(serialized.size());
+    for (CDataStream ss : serialized) {
+        auto proof = RCUPtr<Proof>::make();
+        ss >> *proof;
+        proofs.push_back(proof);
+    }
+    return proofs;
+}
+
+static std::vector<CDataStream>
+SerializeProofs(const std::vector<ProofRef> &proofs) {
+    std::vector<CDataStream> serialized;
+    for (const ProofRef &proof : proofs) {
+        serialized.emplace_back(SER_NETWORK, PROTOCOL_VERSION);
+        serialized.back() << *proof;
+    }
+    return serialized;
+}
+
+static void VerifyProofs(benchmark::Bench &bench, size_t numProofs,
+                         size_t minStakes, size_t maxStakes, bool batched) {
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+
+    const std::vector<CDataStream> serialized =
+        SerializeProofs(BuildProofs(numProofs, minStakes, maxStakes));
+
+    bench.batch(numProofs).unit("proof").run([&] {
+        const std::vector<ProofRef> proofs = CopyProofs(serialized);
+        if (batched) {
+            bool ret = VerifyProofSignatures(proofs);
+            assert(ret);
+        }
+
+        for (const ProofRef &proof : proofs) {
+            ProofValidationState state;
+            bool ret = proof->verify(state);
+            assert(ret);
+        }
+    });
+
+    ECC_Stop();
+}
+
+/** Verify the signatures one by one, as was done before batching them. */
+static void VerifyProofsOneByOne(benchmark::Bench &bench, size_t numProofs,
+                                 size_t minStakes, size_t maxStakes) {
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+
+    const std::vector<CDataStream> serialized =
+        SerializeProofs(BuildProofs(numProofs, minStakes, maxStakes));
+
+    bench.batch(numProofs).unit("proof").run([&] {
+        const std::vector<ProofRef> proofs = CopyProofs(serialized);
+        for (const ProofRef &proof : proofs) {
+            const StakeCommitment commitment = proof->getStakeCommitment();
+            for (const SignedStake &ss : proof->getStakes()) {
+                bool ret = ss.verify(commitment);
+                assert(ret);
+            }
+        }
+    });
+
+    ECC_Stop();
+}
+
+// Most proofs are expected to hold a single stake.
+static void AvalancheProofVerifySingleStake(benchmark::Bench &bench) {
+    VerifyProofs(bench, 1, 1, 1, false);
+}
+
+static void AvalancheProofVerify10Stakes(benchmark::Bench &bench) {
+    VerifyProofs(bench, 1, 10, 10, false);
+}
+
+static void AvalancheProofVerify10StakesOneByOne(benchmark::Bench &bench) {
+    VerifyProofsOneByOne(bench, 1, 10, 10);
+}
+
+static void AvalancheProofVerify100Stakes(benchmark::Bench &bench) {
+    VerifyProofs(bench, 1, 100, 100, false);
+}
+
+static void AvalancheProofVerify100StakesOneByOne(benchmark::Bench &bench) {
+    VerifyProofsOneByOne(bench, 1, 100, 100);
+}
+
+// A set of proofs received or loaded at once, verified together.
+static void AvalancheProofVerifyManyProofs(benchmark::Bench &bench) {
+    VerifyProofs(bench, 100, 1, 5, true);
+}
+
+static void AvalancheProofVerifyManyProofsOneByOne(benchmark::Bench &bench) {
+    VerifyProofsOneByOne(bench, 100, 1, 5);
+}
+
+BENCHMARK(AvalancheProofVerifySingleStake);
+BENCHMARK(AvalancheProofVerify10Stakes);
+BENCHMARK(AvalancheProofVerify10StakesOneByOne);
+BENCHMARK(AvalancheProofVerify100Stakes);
+BENCHMARK(AvalancheProofVerify100StakesOneByOne);
+BENCHMARK(AvalancheProofVerifyManyProofs);
+BENCHMARK(AvalancheProofVerifyManyProofsOneByOne);
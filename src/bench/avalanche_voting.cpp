@@ -0,0 +1,133 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <avalanche/processor.h>
+#include <avalanche/simulator.h>
+#include <avalanche/voterecord.h>
+#include <bench/bench.h>
+#include <random.h>
+#include <util/system.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <vector>
+
+static constexpr int MIN_CORES = 2;
+static constexpr size_t NUM_ITEMS = 1024;
+static constexpr size_t NUM_PEERS = 500;
+
+using avalanche::VoteRecord;
+
+/**
+ * Simulate a single peer answering a poll: it votes yes most of the time and
+ * sometimes does not know about the item yet.
+ */
+static uint32_t SimulateVote(FastRandomContext &rng) {
+    return rng.randrange(20) == 0 ? uint32_t(-1) : 0;
+}
+
+/**
+ * Register the votes of many peers concurrently, each worker thread handling
+ * the responses to polls of AVALANCHE_MAX_ELEMENT_POLL items over a shared set
+ * of vote records.
+ */
+static void AvalancheConcurrentVotes(benchmark::Bench &bench) {
+    const int num_threads = std::max(MIN_CORES, GetNumCores());
+    constexpr size_t VOTES_PER_THREAD = 50000;
+
+    std::deque<VoteRecord> records;
+    for (size_t i = 0; i < NUM_ITEMS; i++) {
+        records.emplace_back(true);
+    }
+
+    bench.batch(VOTES_PER_THREAD * num_threads).unit("vote").run([&] {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back([&] {
+                FastRandomContext rng;
+                size_t votes = 0;
+                while (votes < VOTES_PER_THREAD) {
+                    const NodeId nodeid = rng.randrange(NUM_PEERS);
+                    const size_t first = rng.randrange(NUM_ITEMS);
+                    for (size_t i = 0; i < AVALANCHE_MAX_ELEMENT_POLL &&
+                                       votes < VOTES_PER_THREAD;
+                         i++, votes++) {
+                        records[(first + i) % NUM_ITEMS].registerVote(
+                            nodeid, SimulateVote(rng));
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    });
+}
+
+/**
+ * Poll a set of new items until they are all finalized, with the responses
+ * being processed concurrently by several worker threads. This measures the
+ * time it takes to finalize an item once the quorum is established.
+ */
+static void AvalancheTimeToFinalization(benchmark::Bench &bench) {
+    const int num_threads = std::max(MIN_CORES, GetNumCores());
+
+    bench.minEpochIterations(10).batch(NUM_ITEMS).unit("item").run([&] {
+        std::deque<VoteRecord> records;
+        for (size_t i = 0; i < NUM_ITEMS; i++) {
+            records.emplace_back(true);
+        }
+
+        std::atomic<size_t> finalized{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++) {
+            threads.emplace_back([&] {
+                FastRandomContext rng;
+                while (finalized < NUM_ITEMS) {
+                    const NodeId nodeid = rng.randrange(NUM_PEERS);
+                    const size_t first = rng.randrange(NUM_ITEMS);
+                    for (size_t i = 0; i < AVALANCHE_MAX_ELEMENT_POLL; i++) {
+                        const VoteRecord &vr = records[(first + i) % NUM_ITEMS];
+                        if (vr.hasFinalized()) {
+                            continue;
+                        }
+                        if (vr.registerVote(nodeid, SimulateVote(rng)) &&
+                            vr.hasFinalized()) {
+                            finalized++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    });
+}
+
+/**
+ * Simulate a network of a hundred avalanche nodes with uneven stakes and some
+ * message loss finalizing a poll worth of items.
+ */
+static void AvalancheSimulation(benchmark::Bench &bench) {
+    avalanche::SimulationParams params;
+    params.numNodes = 100;
+    params.lossPercent = 1;
+    params.stakeParetoShape = 1.5;
+
+    bench.unit("simulation").run([&] {
+        const avalanche::SimulationResult result =
+            avalanche::RunSimulation(params);
+        assert(result.unfinalizedItems == 0);
+        params.seed++;
+    });
+}
+
+BENCHMARK(AvalancheConcurrentVotes);
+BENCHMARK(AvalancheTimeToFinalization);
+BENCHMARK(AvalancheSimulation);
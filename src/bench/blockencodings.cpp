@@ -0,0 +1,78 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <config.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr size_t NUM_MEMPOOL_TXS = 50000;
+static constexpr size_t NUM_BLOCK_TXS = 2000;
+
+/**
+ * Reconstruct a compact block of 2000 transactions against a mempool of 50k
+ * transactions. If the block contains a transaction which is not in the
+ * mempool, the short ids of all the mempool transactions are computed.
+ */
+static void InitData(benchmark::Bench &bench, bool allTxsInMempool) {
+    const Config &config = GetConfig();
+    CTxMemPool pool;
+    FastRandomContext rng(/* fDeterministic */ true);
+
+    CBlock block;
+    block.nBits = 0x207fffff;
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    {
+        LOCK2(cs_main, pool.cs);
+        for (size_t i = 0; i < NUM_MEMPOOL_TXS; i++) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(COutPoint(TxId(rng.rand256()), 0));
+            mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+            const CTransactionRef tx = MakeTransactionRef(std::move(mtx));
+            pool.addUnchecked(TestMemPoolEntryHelper().FromTx(tx));
+
+            // Pick the block transactions across the whole mempool.
+            if (i % (NUM_MEMPOOL_TXS / NUM_BLOCK_TXS) == 0) {
+                block.vtx.push_back(tx);
+            }
+        }
+    }
+
+    if (!allTxsInMempool) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint(TxId(rng.rand256()), 0));
+        mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+        block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+
+    const CBlockHeaderAndShortTxIDs cmpctblock(block);
+    const std::vector<std::pair<TxHash, CTransactionRef>> extra_txn;
+
+    bench.unit("block").run([&] {
+        PartiallyDownloadedBlock partialBlock(config, &pool);
+        ReadStatus status = partialBlock.InitData(cmpctblock, extra_txn);
+        assert(status == READ_STATUS_OK);
+    });
+}
+
+static void BlockEncodingsInitData(benchmark::Bench &bench) {
+    InitData(bench, true);
+}
+
+static void BlockEncodingsInitDataMissingTx(benchmark::Bench &bench) {
+    InitData(bench, false);
+}
+
+BENCHMARK(BlockEncodingsInitData);
+BENCHMARK(BlockEncodingsInitDataMissingTx);
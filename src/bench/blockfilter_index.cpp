@@ -0,0 +1,57 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockfilter.h>
+#include <chain.h>
+#include <index/blockfilterindex.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+/**
+ * Simulate light wallets asking for the filters of the most recent blocks
+ * through getcfilters, each of them with a slightly different range.
+ */
+static void BlockFilterIndexServeRanges(benchmark::Bench &bench) {
+    TestChain100Setup test_setup{};
+
+    BlockFilterIndex filter_index(BlockFilterType::BASIC, 1 << 20, true);
+    filter_index.Start(test_setup.m_node.chainman->ActiveChainstate());
+    while (!filter_index.BlockUntilSyncedToCurrentChain()) {
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+
+    const CBlockIndex *tip =
+        WITH_LOCK(cs_main, return test_setup.m_node.chainman->ActiveTip());
+
+    constexpr size_t NUM_CLIENTS = 500;
+    FastRandomContext rng(/* fDeterministic */ true);
+    std::vector<std::pair<int, const CBlockIndex *>> requests;
+    requests.reserve(NUM_CLIENTS);
+    for (size_t i = 0; i < NUM_CLIENTS; ++i) {
+        const CBlockIndex *stop_index =
+            tip->GetAncestor(tip->nHeight - rng.randrange(10));
+        requests.emplace_back(stop_index->nHeight - rng.randrange(50),
+                              stop_index);
+    }
+
+    bench.batch(NUM_CLIENTS).unit("request").run([&] {
+        for (const auto &request : requests) {
+            std::vector<BlockFilter> filters;
+            bool ret = filter_index.LookupFilterRange(request.first,
+                                                      request.second, filters);
+            assert(ret);
+        }
+    });
+
+    filter_index.Interrupt();
+    filter_index.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BENCHMARK(BlockFilterIndexServeRanges);
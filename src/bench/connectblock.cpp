@@ -0,0 +1,105 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <config.h>
+#include <consensus/consensus.h>
+#include <consensus/validation.h>
+#include <script/script.h>
+#include <script/standard.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr size_t NUM_TXS = 1000;
+
+/**
+ * Connect a block made of transactions which were accepted to the mempool, so
+ * their script executions are cached, as the block template validation does.
+ * Either they are still in the mempool, or it was cleared and the sighash
+ * midstates have to be computed again.
+ */
+static void ConnectBlockMempoolTxs(benchmark::Bench &bench, bool inMempool) {
+    const Config &config = GetConfig();
+    TestingSetup test_setup{
+        CBaseChainParams::REGTEST,
+        /* extra_args */
+        {
+            "-nodebuglogfile",
+            "-nodebug",
+        },
+    };
+    const NodeContext &node = test_setup.m_node;
+    CChainState &chainstate = node.chainman->ActiveChainstate();
+
+    const CScript redeemScript = CScript() << OP_DROP << OP_TRUE;
+    const CScript SCRIPT_PUB =
+        CScript() << OP_HASH160 << ToByteVector(CScriptID(redeemScript))
+                  << OP_EQUAL;
+    const CScript scriptSig = CScript() << std::vector<uint8_t>(100, 0xff)
+                                        << ToByteVector(redeemScript);
+
+    const auto AcceptTx = [&](const CMutableTransaction &mtx) {
+        LOCK(cs_main);
+        const MempoolAcceptResult res =
+            AcceptToMemoryPool(chainstate, config, *node.mempool,
+                               MakeTransactionRef(mtx), false);
+        assert(res.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    };
+
+    // Split a mature coinbase into the outputs spent by the transactions.
+    CMutableTransaction fanout;
+    fanout.vin.push_back(MineBlock(config, node, SCRIPT_PUB));
+    fanout.vin.back().scriptSig = scriptSig;
+    for (int i = 0; i < COINBASE_MATURITY; i++) {
+        MineBlock(config, node, SCRIPT_PUB);
+    }
+    const Amount value = 10 * COIN / int(NUM_TXS);
+    fanout.vout.assign(NUM_TXS, CTxOut(value, SCRIPT_PUB));
+    AcceptTx(fanout);
+    MineBlock(config, node, SCRIPT_PUB);
+
+    for (size_t i = 0; i < NUM_TXS; i++) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint(fanout.GetId(), i));
+        tx.vin.back().scriptSig = scriptSig;
+        tx.vout.assign(2, CTxOut(value / 2 - 1000 * SATOSHI, SCRIPT_PUB));
+        AcceptTx(tx);
+    }
+
+    const std::shared_ptr<CBlock> block =
+        PrepareBlock(config, node, SCRIPT_PUB);
+    assert(block->vtx.size() == NUM_TXS + 1);
+
+    if (!inMempool) {
+        node.mempool->clear();
+    }
+
+    LOCK(cs_main);
+    const BlockValidationOptions options =
+        BlockValidationOptions(config).withCheckPoW(false);
+    bench.minEpochIterations(10).batch(NUM_TXS).unit("tx").run([&] {
+        BlockValidationState state;
+        bool ret =
+            TestBlockValidity(state, config.GetChainParams(), chainstate,
+                              *block, chainstate.m_chain.Tip(), options);
+        assert(ret);
+    });
+}
+
+static void ConnectBlockInMempool(benchmark::Bench &bench) {
+    ConnectBlockMempoolTxs(bench, true);
+}
+
+static void ConnectBlockNotInMempool(benchmark::Bench &bench) {
+    ConnectBlockMempoolTxs(bench, false);
+}
+
+BENCHMARK(ConnectBlockInMempool);
+BENCHMARK(ConnectBlockNotInMempool);
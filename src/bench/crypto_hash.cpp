@@ -15,6 +15,7 @@
 #include <uint256.h>
 
 #include <string>
+#include <vector>
 
 /* Number of bytes to hash per iteration */
 static const uint64_t BUFFER_SIZE = 1000 * 1000;
@@ -59,6 +60,44 @@ static void SHA256D64_1024(benchmark::Bench &bench) {
         [&] { SHA256D64(in.data(), in.data(), 1024); });
 }
 
+/**
+ * Double SHA256 of 1024 messages with the sizes of typical transactions, as
+ * when computing the ids of the transactions of a block.
+ */
+static void SHA256DMessages(benchmark::Bench &bench, bool multi) {
+    FastRandomContext rng(/* fDeterministic */ true);
+    std::vector<std::vector<uint8_t>> messages(1024);
+    std::vector<const uint8_t *> inputs;
+    std::vector<size_t> sizes;
+    size_t totalSize = 0;
+    for (std::vector<uint8_t> &message : messages) {
+        message = rng.randbytes(200 + rng.randrange(400));
+        inputs.push_back(message.data());
+        sizes.push_back(message.size());
+        totalSize += message.size();
+    }
+
+    std::vector<uint8_t> out(32 * messages.size());
+    bench.batch(totalSize).unit("byte").run([&] {
+        if (multi) {
+            SHA256DMulti(out.data(), inputs.data(), sizes.data(),
+                         messages.size());
+            return;
+        }
+        for (size_t i = 0; i < messages.size(); i++) {
+            CHash256().Write(messages[i]).Finalize({out.data() + 32 * i, 32});
+        }
+    });
+}
+
+static void SHA256D_1024Messages(benchmark::Bench &bench) {
+    SHA256DMessages(bench, false);
+}
+
+static void SHA256DMulti_1024Messages(benchmark::Bench &bench) {
+    SHA256DMessages(bench, true);
+}
+
 static void SHA512(benchmark::Bench &bench) {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
     std::vector<uint8_t> in(BUFFER_SIZE, 0);
@@ -75,6 +114,46 @@ static void SipHash_32b(benchmark::Bench &bench) {
     });
 }
 
+/**
+ * Hash 1024 values, the way the salted hashers do for a batch of outpoints,
+ * one by one or several at a time.
+ */
+static void SipHashBatch(benchmark::Bench &bench, bool batched) {
+    constexpr size_t NUM_VALUES = 1024;
+    FastRandomContext rng(true);
+    std::vector<uint256> vals(NUM_VALUES);
+    std::vector<const uint256 *> pvals;
+    std::vector<uint32_t> extras;
+    for (uint256 &val : vals) {
+        val = rng.rand256();
+        pvals.push_back(&val);
+        extras.push_back(rng.rand32());
+    }
+
+    std::vector<uint64_t> hashes(NUM_VALUES);
+    uint64_t k1 = 0;
+    bench.batch(NUM_VALUES).unit("hash").run([&] {
+        ++k1;
+        if (batched) {
+            SipHashUint256ExtraBatch(0, k1, pvals.data(), extras.data(),
+                                     hashes.data(), NUM_VALUES);
+        } else {
+            for (size_t i = 0; i < NUM_VALUES; i++) {
+                hashes[i] = SipHashUint256Extra(0, k1, vals[i], extras[i]);
+            }
+        }
+        ankerl::nanobench::doNotOptimizeAway(hashes);
+    });
+}
+
+static void SipHash_32b_1024(benchmark::Bench &bench) {
+    SipHashBatch(bench, false);
+}
+
+static void SipHash_batch(benchmark::Bench &bench) {
+    SipHashBatch(bench, true);
+}
+
 static void FastRandom_32bit(benchmark::Bench &bench) {
     FastRandomContext rng(true);
     bench.run([&] { rng.rand32(); });
@@ -123,6 +202,50 @@ static void MuHashPrecompute(benchmark::Bench &bench) {
     bench.run([&] { MuHash3072{key}; });
 }
 
+/** The modular inverse, mostly made of squarings. */
+static void MuHashFinalize(benchmark::Bench &bench) {
+    FastRandomContext rng(true);
+    MuHash3072 acc{rng.randbytes(32)};
+    acc /= MuHash3072{rng.randbytes(32)};
+
+    uint256 out;
+    bench.run([&] {
+        MuHash3072 copy = acc;
+        copy.Finalize(out);
+    });
+}
+
+/** The outputs created by a block, of about the size of a serialized UTXO. */
+static std::vector<std::vector<uint8_t>> MuHashElements() {
+    FastRandomContext rng(true);
+    std::vector<std::vector<uint8_t>> elements(1000);
+    for (std::vector<uint8_t> &element : elements) {
+        element = rng.randbytes(70);
+    }
+    return elements;
+}
+
+static void MuHashInsert1000(benchmark::Bench &bench) {
+    MuHash3072 acc;
+    const std::vector<std::vector<uint8_t>> elements = MuHashElements();
+
+    bench.batch(elements.size()).unit("element").run([&] {
+        for (const std::vector<uint8_t> &element : elements) {
+            acc.Insert(element);
+        }
+    });
+}
+
+static void MuHashInsertBatch1000(benchmark::Bench &bench) {
+    MuHash3072 acc;
+    const std::vector<std::vector<uint8_t>> elements = MuHashElements();
+    const std::vector<Span<const uint8_t>> spans(elements.begin(),
+                                                 elements.end());
+
+    bench.batch(elements.size()).unit("element").run(
+        [&] { acc.InsertBatch(spans); });
+}
+
 BENCHMARK(RIPEMD160);
 BENCHMARK(SHA1);
 BENCHMARK(SHA256);
@@ -131,7 +254,11 @@ BENCHMARK(SHA3_256_1M);
 
 BENCHMARK(SHA256_32b);
 BENCHMARK(SipHash_32b);
+BENCHMARK(SipHash_32b_1024);
+BENCHMARK(SipHash_batch);
 BENCHMARK(SHA256D64_1024);
+BENCHMARK(SHA256D_1024Messages);
+BENCHMARK(SHA256DMulti_1024Messages);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
 
@@ -139,3 +266,6 @@ BENCHMARK(MuHash);
 BENCHMARK(MuHashMul);
 BENCHMARK(MuHashDiv);
 BENCHMARK(MuHashPrecompute);
+BENCHMARK(MuHashFinalize);
+BENCHMARK(MuHashInsert1000);
+BENCHMARK(MuHashInsertBatch1000);
@@ -5,14 +5,20 @@
 #include <bench/bench.h>
 #include <blockfilter.h>
 
-static void ConstructGCSFilter(benchmark::Bench &bench) {
+static GCSFilter::ElementSet GenerateGCSTestElements(int offset = 0) {
     GCSFilter::ElementSet elements;
-    for (int i = 0; i < 10000; ++i) {
+    for (int i = offset; i < offset + 10000; ++i) {
         GCSFilter::Element element(32);
         element[0] = static_cast<uint8_t>(i);
         element[1] = static_cast<uint8_t>(i >> 8);
+        element[2] = static_cast<uint8_t>(i >> 16);
         elements.insert(std::move(element));
     }
+    return elements;
+}
+
+static void ConstructGCSFilter(benchmark::Bench &bench) {
+    GCSFilter::ElementSet elements = GenerateGCSTestElements();
 
     uint64_t siphash_k0 = 0;
     bench.batch(elements.size()).unit("elem").run([&] {
@@ -22,18 +28,47 @@ static void ConstructGCSFilter(benchmark::Bench &bench) {
     });
 }
 
+static void ConstructBasicGCSFilter(benchmark::Bench &bench) {
+    // Same as a basic block filter for a block with as many distinct scripts.
+    GCSFilter::ElementSet elements = GenerateGCSTestElements();
+
+    uint64_t siphash_k0 = 0;
+    bench.batch(elements.size()).unit("elem").run([&] {
+        GCSFilter filter({siphash_k0, 0, BASIC_FILTER_P, BASIC_FILTER_M},
+                         elements);
+
+        siphash_k0++;
+    });
+}
+
+static void DecodeGCSFilter(benchmark::Bench &bench) {
+    GCSFilter::ElementSet elements = GenerateGCSTestElements();
+    const GCSFilter::Params params{0, 0, BASIC_FILTER_P, BASIC_FILTER_M};
+    const std::vector<uint8_t> encoded = GCSFilter(params, elements).GetEncoded();
+
+    bench.batch(elements.size()).unit("elem").run(
+        [&] { GCSFilter filter(params, encoded); });
+}
+
 static void MatchGCSFilter(benchmark::Bench &bench) {
-    GCSFilter::ElementSet elements;
-    for (int i = 0; i < 10000; ++i) {
-        GCSFilter::Element element(32);
-        element[0] = static_cast<uint8_t>(i);
-        element[1] = static_cast<uint8_t>(i >> 8);
-        elements.insert(std::move(element));
-    }
+    GCSFilter::ElementSet elements = GenerateGCSTestElements();
     GCSFilter filter({0, 0, 20, 1 << 20}, elements);
 
     bench.unit("elem").run([&] { filter.Match(GCSFilter::Element()); });
 }
 
+static void MatchAnyGCSFilter(benchmark::Bench &bench) {
+    // A wallet rescan matches all the wallet scripts against each filter.
+    GCSFilter::ElementSet elements = GenerateGCSTestElements();
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+    GCSFilter::ElementSet queries = GenerateGCSTestElements(1 << 20);
+
+    bench.batch(filter.GetN()).unit("elem").run(
+        [&] { filter.MatchAny(queries); });
+}
+
 BENCHMARK(ConstructGCSFilter);
+BENCHMARK(ConstructBasicGCSFilter);
+BENCHMARK(DecodeGCSFilter);
 BENCHMARK(MatchGCSFilter);
+BENCHMARK(MatchAnyGCSFilter);
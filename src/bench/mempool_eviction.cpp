@@ -15,7 +15,8 @@ static void AddTx(const CTransactionRef &tx, const Amount &nFee,
     unsigned int nSigOpCount = 1;
     LockPoints lp;
     pool.addUnchecked(CTxMemPoolEntry(tx, nFee, nTime, nHeight, spendsCoinbase,
-                                      nSigOpCount, lp));
+                                      nSigOpCount, lp,
+                                      PrecomputedTransactionData(*tx)));
 }
 
 // Right now this is only testing eviction performance in an extremely small
@@ -18,7 +18,8 @@ static void AddTx(const CTransactionRef &tx, CTxMemPool &pool)
     unsigned int sigOpCost = 4;
     LockPoints lp;
     pool.addUnchecked(CTxMemPoolEntry(tx, 1000 * SATOSHI, nTime, nHeight,
-                                      spendsCoinbase, sigOpCost, lp));
+                                      spendsCoinbase, sigOpCost, lp,
+                                      PrecomputedTransactionData(*tx)));
 }
 
 struct Available {
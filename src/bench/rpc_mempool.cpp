@@ -14,7 +14,8 @@ static void AddTx(const CTransactionRef &tx, const Amount &fee,
     pool.addUnchecked(CTxMemPoolEntry(tx, fee, /* time */ 0,
                                       /* height */ 1,
                                       /* spendsCoinbase */ false,
-                                      /* sigOpCount */ 1, lp));
+                                      /* sigOpCount */ 1, lp,
+                                      PrecomputedTransactionData(*tx)));
 }
 
 static void RpcMempool(benchmark::Bench &bench) {
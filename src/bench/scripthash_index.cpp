@@ -0,0 +1,93 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/consensus.h>
+#include <index/scripthashindex.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+/**
+ * Page through the history of a script with tens of thousands of entries, as
+ * an Electrum server does for the busiest addresses. The cost of a page only
+ * depends on its size and not on the length of the full history, because each
+ * lookup is a single seek followed by a sequential scan.
+ */
+static void ScriptHashIndexHotScriptPages(benchmark::Bench &bench) {
+    TestChain100Setup test_setup{};
+
+    constexpr size_t TXS_PER_BLOCK = 2000;
+    constexpr size_t NUM_BLOCKS = 10;
+    constexpr size_t PAGE_SIZE = 100;
+
+    // Anyone can spend from the hot script, so the setup needs no signature.
+    const CScript hot_script = CScript() << OP_1;
+    // Pad the transactions to the minimum transaction size.
+    const CScript padding = CScript()
+                            << OP_RETURN << std::vector<uint8_t>(40, 0x42);
+
+    // Fund the hot script from a coinbase that anyone can spend as well.
+    const CScript coinbase_script = CScript() << OP_1 << OP_DROP << OP_1;
+    const CBlock funding_block =
+        test_setup.CreateAndProcessBlock({}, coinbase_script);
+    test_setup.mineBlocks(COINBASE_MATURITY);
+
+    CMutableTransaction funding;
+    funding.nVersion = 1;
+    funding.vin.emplace_back(COutPoint(funding_block.vtx[0]->GetId(), 0));
+    const Amount value =
+        funding_block.vtx[0]->vout[0].nValue / int(TXS_PER_BLOCK);
+    funding.vout.assign(TXS_PER_BLOCK, CTxOut(value, hot_script));
+    test_setup.CreateAndProcessBlock({funding}, coinbase_script);
+
+    std::vector<COutPoint> hot_outpoints;
+    for (size_t i = 0; i < TXS_PER_BLOCK; ++i) {
+        hot_outpoints.emplace_back(funding.GetId(), i);
+    }
+    for (size_t block = 0; block < NUM_BLOCKS; ++block) {
+        std::vector<CMutableTransaction> txs;
+        for (COutPoint &outpoint : hot_outpoints) {
+            CMutableTransaction &tx = txs.emplace_back();
+            tx.nVersion = 1;
+            tx.vin.emplace_back(outpoint);
+            tx.vout.emplace_back(value, hot_script);
+            tx.vout.emplace_back(Amount::zero(), padding);
+            outpoint = COutPoint(tx.GetId(), 0);
+        }
+        test_setup.CreateAndProcessBlock(txs, coinbase_script);
+    }
+
+    ScriptHashIndex index(1 << 20, true);
+    index.Start(test_setup.m_node.chainman->ActiveChainstate());
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+
+    const uint256 hot_script_hash = ComputeScriptHash(hot_script);
+    const int tip_height =
+        WITH_LOCK(cs_main, return test_setup.m_node.chainman->ActiveHeight());
+    FastRandomContext rng(/* fDeterministic */ true);
+    std::vector<ScriptHistoryEntry> entries;
+    bench.batch(PAGE_SIZE).unit("entry").run([&] {
+        bool more;
+        const int from_height = tip_height - rng.randrange(NUM_BLOCKS);
+        const uint32_t from_position = rng.randrange(TXS_PER_BLOCK / 2);
+        bool ret = index.LookupHistory(hot_script_hash, from_height,
+                                       from_position, PAGE_SIZE, entries, more);
+        assert(ret);
+        assert(entries.size() == PAGE_SIZE);
+    });
+
+    index.Interrupt();
+    index.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BENCHMARK(ScriptHashIndexHotScriptPages);
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <key.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/sigcache.h>
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+static constexpr size_t NUM_SIGNATURES = 4096;
+static constexpr size_t NUM_THREADS = 8;
+
+/**
+ * Look up cached signatures concurrently, the way the script check threads do
+ * when connecting a block whose transactions were accepted to the mempool.
+ */
+static void SigCacheConcurrentLookups(benchmark::Bench &bench) {
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+    InitSignatureCache();
+
+    CMutableTransaction mtx;
+    mtx.vin.resize(1);
+    mtx.vout.resize(1);
+    const CTransaction tx(mtx);
+    PrecomputedTransactionData txdata(tx);
+
+    struct Signature {
+        std::vector<uint8_t> sig;
+        CPubKey pubkey;
+        uint256 sighash;
+    };
+
+    const CKey key = CKey::MakeCompressedKey();
+    FastRandomContext rng(/* fDeterministic */ true);
+    std::vector<Signature> signatures(NUM_SIGNATURES);
+    for (Signature &s : signatures) {
+        s.pubkey = key.GetPubKey();
+        s.sighash = rng.rand256();
+        bool signed_ok = key.SignECDSA(s.sighash, s.sig);
+        assert(signed_ok);
+    }
+
+    // Populate the cache, as the mempool acceptance does.
+    const CachingTransactionSignatureChecker storeChecker(
+        &tx, 0, Amount::zero(), true, txdata);
+    for (const Signature &s : signatures) {
+        bool ret = storeChecker.VerifySignature(s.sig, s.pubkey, s.sighash);
+        assert(ret);
+    }
+
+    const CachingTransactionSignatureChecker checker(&tx, 0, Amount::zero(),
+                                                     false, txdata);
+    bench.batch(NUM_SIGNATURES * NUM_THREADS).unit("lookup").run([&] {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < NUM_THREADS; i++) {
+            threads.emplace_back([&] {
+                for (const Signature &s : signatures) {
+                    bool ret = checker.VerifySignature(s.sig, s.pubkey,
+                                                       s.sighash);
+                    assert(ret);
+                }
+            });
+        }
+        for (std::thread &t : threads) {
+            t.join();
+        }
+    });
+
+    ECC_Stop();
+}
+
+BENCHMARK(SigCacheConcurrentLookups);
@@ -0,0 +1,83 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/consensus.h>
+#include <index/spentindex.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+/**
+ * Look up the spenders of random outpoints, as a payment tracking service
+ * does for each of the outputs it watches.
+ */
+static void SpentIndexFindSpender(benchmark::Bench &bench) {
+    TestChain100Setup test_setup{};
+
+    constexpr size_t TXS_PER_BLOCK = 2000;
+    constexpr size_t NUM_BLOCKS = 5;
+
+    // Anyone can spend the coins, so the setup needs no signature.
+    const CScript script = CScript() << OP_1;
+    // Pad the transactions to the minimum transaction size.
+    const CScript padding = CScript()
+                            << OP_RETURN << std::vector<uint8_t>(40, 0x42);
+
+    const CBlock funding_block = test_setup.CreateAndProcessBlock({}, script);
+    test_setup.mineBlocks(COINBASE_MATURITY);
+
+    CMutableTransaction funding;
+    funding.nVersion = 1;
+    funding.vin.emplace_back(COutPoint(funding_block.vtx[0]->GetId(), 0));
+    const Amount value =
+        funding_block.vtx[0]->vout[0].nValue / int(TXS_PER_BLOCK);
+    funding.vout.assign(TXS_PER_BLOCK, CTxOut(value, script));
+    test_setup.CreateAndProcessBlock({funding}, script);
+
+    std::vector<COutPoint> spent_outpoints;
+    std::vector<COutPoint> outpoints;
+    for (size_t i = 0; i < TXS_PER_BLOCK; ++i) {
+        outpoints.emplace_back(funding.GetId(), i);
+    }
+    for (size_t block = 0; block < NUM_BLOCKS; ++block) {
+        std::vector<CMutableTransaction> txs;
+        for (COutPoint &outpoint : outpoints) {
+            spent_outpoints.push_back(outpoint);
+            CMutableTransaction &tx = txs.emplace_back();
+            tx.nVersion = 1;
+            tx.vin.emplace_back(outpoint);
+            tx.vout.emplace_back(value, script);
+            tx.vout.emplace_back(Amount::zero(), padding);
+            outpoint = COutPoint(tx.GetId(), 0);
+        }
+        test_setup.CreateAndProcessBlock(txs, script);
+    }
+
+    SpentIndex index(1 << 20, true);
+    index.Start(test_setup.m_node.chainman->ActiveChainstate());
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+
+    FastRandomContext rng(/* fDeterministic */ true);
+    SpendingInput spender;
+    bench.run([&] {
+        const COutPoint &outpoint =
+            spent_outpoints[rng.randrange(spent_outpoints.size())];
+        bool ret = index.FindSpender(outpoint, spender);
+        assert(ret);
+    });
+
+    index.Interrupt();
+    index.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BENCHMARK(SpentIndexFindSpender);
@@ -4,6 +4,7 @@
 
 #include <bench/bench.h>
 #include <key.h>
+#include <policy/policy.h>
 #if defined(HAVE_CONSENSUS_LIB)
 #include <script/bitcoinconsensus.h>
 #endif
@@ -15,6 +16,99 @@
 #include <test/util/transaction_utils.h>
 
 #include <array>
+#include <cassert>
+#include <vector>
+
+static std::vector<uint8_t> SignInput(const CKey &key,
+                                      const CScript &scriptCode,
+                                      const CTransaction &txSpend,
+                                      const Amount amount) {
+    const SigHashType sigHashType = SigHashType().withForkId();
+    const uint256 hash =
+        SignatureHash(scriptCode, txSpend, 0, sigHashType, amount);
+    std::vector<uint8_t> sig;
+    bool ret = key.SignECDSA(hash, sig);
+    assert(ret);
+    sig.push_back(uint8_t(sigHashType.getRawSigHashType()));
+    return sig;
+}
+
+/**
+ * Verify the input spending a standard output, including the signature
+ * checks, with the standard flags.
+ */
+static void VerifyStandardInput(benchmark::Bench &bench,
+                                const CScript &scriptPubKey,
+                                const CScript &scriptSig,
+                                const CTransaction &txSpend,
+                                const Amount amount) {
+    const TransactionSignatureChecker checker(&txSpend, 0, amount);
+    bench.run([&] {
+        ScriptError error;
+        bool ret = VerifyScript(scriptSig, scriptPubKey,
+                                STANDARD_SCRIPT_VERIFY_FLAGS, checker, &error);
+        assert(ret);
+    });
+}
+
+static void VerifyScriptP2PKH(benchmark::Bench &bench) {
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+
+    const CKey key = CKey::MakeCompressedKey();
+    const CPubKey pubkey = key.GetPubKey();
+    const CScript scriptPubKey = GetScriptForDestination(PKHash(pubkey));
+    const Amount amount = COIN;
+
+    const CMutableTransaction txCredit =
+        BuildCreditingTransaction(scriptPubKey, amount);
+    CMutableTransaction txSpend =
+        BuildSpendingTransaction(CScript(), CTransaction(txCredit));
+    txSpend.vin[0].scriptSig
+        << SignInput(key, scriptPubKey, CTransaction(txSpend), amount)
+        << ToByteVector(pubkey);
+
+    VerifyStandardInput(bench, scriptPubKey, txSpend.vin[0].scriptSig,
+                        CTransaction(txSpend), amount);
+
+    ECC_Stop();
+}
+
+static void VerifyScriptP2SHMultisig(benchmark::Bench &bench) {
+    const ECCVerifyHandle verify_handle;
+    ECC_Start();
+
+    // 2-of-3 multisig.
+    std::vector<CKey> keys;
+    std::vector<CPubKey> pubkeys;
+    for (size_t i = 0; i < 3; i++) {
+        keys.push_back(CKey::MakeCompressedKey());
+        pubkeys.push_back(keys.back().GetPubKey());
+    }
+    const CScript redeemScript = GetScriptForMultisig(2, pubkeys);
+    const CScript scriptPubKey =
+        GetScriptForDestination(ScriptHash(redeemScript));
+    const Amount amount = COIN;
+
+    const CMutableTransaction txCredit =
+        BuildCreditingTransaction(scriptPubKey, amount);
+    CMutableTransaction txSpend =
+        BuildSpendingTransaction(CScript(), CTransaction(txCredit));
+    CScript scriptSig;
+    scriptSig << OP_0;
+    for (size_t i = 0; i < 2; i++) {
+        scriptSig << SignInput(keys[i], redeemScript, CTransaction(txSpend),
+                               amount);
+    }
+    scriptSig << std::vector<uint8_t>(redeemScript.begin(),
+                                      redeemScript.end());
+    txSpend.vin[0].scriptSig = scriptSig;
+
+    VerifyStandardInput(bench, scriptPubKey, scriptSig, CTransaction(txSpend),
+                        amount);
+
+    ECC_Stop();
+}
 
 static void VerifyNestedIfScript(benchmark::Bench &bench) {
     std::vector<std::vector<uint8_t>> stack;
@@ -38,4 +132,31 @@ static void VerifyNestedIfScript(benchmark::Bench &bench) {
     });
 }
 
+/**
+ * A script close to the maximum script size, made of data pushes that are
+ * dropped from the stack, so the execution is dominated by reading the
+ * instructions and pushing the elements.
+ */
+static void VerifyLargeScript(benchmark::Bench &bench) {
+    CScript script;
+    const std::vector<uint8_t> data(75, 0x42);
+    for (int i = 0; i < 65; ++i) {
+        script << data << data << OP_2DROP;
+    }
+    script << OP_1;
+    assert(script.size() <= MAX_SCRIPT_SIZE);
+
+    bench.run([&] {
+        std::vector<std::vector<uint8_t>> stack;
+        ScriptExecutionMetrics metrics = {};
+        ScriptError error;
+        bool ret = EvalScript(stack, script, STANDARD_SCRIPT_VERIFY_FLAGS,
+                              BaseSignatureChecker(), metrics, &error);
+        assert(ret);
+    });
+}
+
 BENCHMARK(VerifyNestedIfScript);
+BENCHMARK(VerifyScriptP2PKH);
+BENCHMARK(VerifyScriptP2SHMultisig);
+BENCHMARK(VerifyLargeScript);
@@ -16,6 +16,8 @@
 #include <util/system.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <array>
 #include <unordered_map>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock &block)
@@ -48,6 +50,15 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const TxHash &txhash) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, txhash) & 0xffffffffffffL;
 }
 
+void CBlockHeaderAndShortTxIDs::GetShortIDs(const uint256 *const *txhashes,
+                                            uint64_t *shortids,
+                                            size_t count) const {
+    SipHashUint256Batch(shorttxidk0, shorttxidk1, txhashes, shortids, count);
+    for (size_t i = 0; i < count; i++) {
+        shortids[i] &= 0xffffffffffffL;
+    }
+}
+
 ReadStatus PartiallyDownloadedBlock::InitData(
     const CBlockHeaderAndShortTxIDs &cmpctblock,
     const std::vector<std::pair<TxHash, CTransactionRef>> &extra_txns) {
@@ -97,16 +108,28 @@ ReadStatus PartiallyDownloadedBlock::InitData(
     }
 
     {
-        LOCK(pool->cs);
-        for (size_t i = 0; i < pool->vTxHashes.size(); i++) {
-            uint64_t shortid = cmpctblock.GetShortID(pool->vTxHashes[i].first);
+        // The short ids of the mempool transactions are computed a batch at a
+        // time, and the transaction refs are only copied for the matching ones.
+        constexpr size_t SHORTID_BATCH_SIZE = 64;
+        std::array<const uint256 *, SHORTID_BATCH_SIZE> txhashes;
+        std::array<uint64_t, SHORTID_BATCH_SIZE> shortids;
 
-            mempool_count += shortidProcessor->matchKnownItem(
-                shortid, pool->vTxHashes[i].second->GetSharedTx());
-
-            if (mempool_count == shortidProcessor->getShortIdCount()) {
-                break;
+        LOCK(pool->cs);
+        const size_t poolSize = pool->vTxHashes.size();
+        bool done = false;
+        for (size_t begin = 0; begin < poolSize && !done;
+             begin += SHORTID_BATCH_SIZE) {
+            const size_t count =
+                std::min(SHORTID_BATCH_SIZE, poolSize - begin);
+            for (size_t i = 0; i < count; i++) {
+                txhashes[i] = &pool->vTxHashes[begin + i].first;
             }
+            cmpctblock.GetShortIDs(txhashes.data(), shortids.data(), count);
+
+            done = shortidProcessor->matchKnownItemsLazy(
+                shortids.data(), count, mempool_count, [&](size_t i) {
+                    return pool->vTxHashes[begin + i].second->GetSharedTx();
+                });
         }
     }
 
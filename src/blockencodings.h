@@ -101,6 +101,12 @@ public:
     explicit CBlockHeaderAndShortTxIDs(const CBlock &block);
 
     uint64_t GetShortID(const TxHash &txhash) const;
+    /**
+     * Compute the short ids of count transactions at once, which is faster
+     * than calling GetShortID for each of them.
+     */
+    void GetShortIDs(const uint256 *const *txhashes, uint64_t *shortids,
+                     size_t count) const;
 
     size_t BlockTxCount() const {
         return shorttxids.size() + prefilledtxn.size();
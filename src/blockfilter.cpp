@@ -4,6 +4,7 @@
 
 #include <blockfilter.h>
 
+#include <crypto/common.h>
 #include <crypto/siphash.h>
 #include <hash.h>
 #include <primitives/transaction.h>
@@ -64,6 +65,42 @@ uint64_t GCSFilter::HashToRange(const Element &element) const {
     return MapIntoRange(hash, m_F);
 }
 
+/**
+ * Below this many elements, std::sort is faster than the radix sort because of
+ * the fixed cost of the histograms.
+ */
+static constexpr size_t RADIX_SORT_MIN_ELEMENTS = 256;
+
+/**
+ * Sort values that are all lower than max_value using a LSD radix sort on 8
+ * bits digits. Only the digits that can be non zero are sorted, which is 4
+ * passes for a typical basic filter.
+ */
+static void RadixSort(std::vector<uint64_t> &values, uint64_t max_value) {
+    std::vector<uint64_t> buffer(values.size());
+    const int passes = (CountBits(max_value) + 7) / 8;
+    for (int pass = 0; pass < passes; ++pass) {
+        const int shift = 8 * pass;
+
+        size_t offsets[256] = {};
+        for (uint64_t value : values) {
+            ++offsets[(value >> shift) & 0xff];
+        }
+
+        size_t total = 0;
+        for (size_t &offset : offsets) {
+            const size_t count = offset;
+            offset = total;
+            total += count;
+        }
+
+        for (uint64_t value : values) {
+            buffer[offsets[(value >> shift) & 0xff]++] = value;
+        }
+        values.swap(buffer);
+    }
+}
+
 std::vector<uint64_t>
 GCSFilter::BuildHashedSet(const ElementSet &elements) const {
     std::vector<uint64_t> hashed_elements;
@@ -71,7 +108,11 @@ GCSFilter::BuildHashedSet(const ElementSet &elements) const {
     for (const Element &element : elements) {
         hashed_elements.push_back(HashToRange(element));
     }
-    std::sort(hashed_elements.begin(), hashed_elements.end());
+    if (hashed_elements.size() < RADIX_SORT_MIN_ELEMENTS) {
+        std::sort(hashed_elements.begin(), hashed_elements.end());
+    } else {
+        RadixSort(hashed_elements, m_F);
+    }
     return hashed_elements;
 }
 
@@ -92,11 +133,12 @@ GCSFilter::GCSFilter(const Params &params, std::vector<uint8_t> encoded_filter)
     // Verify that the encoded filter contains exactly N elements. If it has too
     // much or too little data, a std::ios_base::failure exception will be
     // raised.
-    BitStreamReader<VectorReader> bitreader(stream);
+    GolombRiceDecoder decoder(
+        MakeSpan(m_encoded).subspan(m_encoded.size() - stream.size()));
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        decoder.Decode(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (decoder.GetBytesRead() != stream.size()) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -118,16 +160,16 @@ GCSFilter::GCSFilter(const Params &params, const ElementSet &elements)
         return;
     }
 
-    BitStreamWriter<CVectorWriter> bitwriter(stream);
+    GolombRiceEncoder encoder(m_encoded);
 
     uint64_t last_value = 0;
     for (uint64_t value : BuildHashedSet(elements)) {
         uint64_t delta = value - last_value;
-        GolombRiceEncode(bitwriter, m_params.m_P, delta);
+        encoder.Encode(m_params.m_P, delta);
         last_value = value;
     }
 
-    bitwriter.Flush();
+    encoder.Flush();
 }
 
 bool GCSFilter::MatchInternal(const uint64_t *element_hashes,
@@ -138,12 +180,13 @@ bool GCSFilter::MatchInternal(const uint64_t *element_hashes,
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader<VectorReader> bitreader(stream);
+    GolombRiceDecoder decoder(
+        MakeSpan(m_encoded).subspan(m_encoded.size() - stream.size()));
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = decoder.Decode(m_params.m_P);
         value += delta;
 
         while (true) {
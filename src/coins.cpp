@@ -9,6 +9,9 @@
 #include <random.h>
 #include <version.h>
 
+#include <algorithm>
+#include <array>
+
 bool CCoinsView::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     return false;
 }
@@ -60,6 +63,22 @@ SaltedOutpointHasher::SaltedOutpointHasher()
     : k0(GetRand(std::numeric_limits<uint64_t>::max())),
       k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
 
+void SaltedOutpointHasher::operator()(const COutPoint *const *outpoints,
+                                      uint64_t *out, size_t count) const {
+    constexpr size_t BATCH_SIZE = 64;
+    std::array<const uint256 *, BATCH_SIZE> txids;
+    std::array<uint32_t, BATCH_SIZE> ns;
+    for (size_t begin = 0; begin < count; begin += BATCH_SIZE) {
+        const size_t n = std::min(BATCH_SIZE, count - begin);
+        for (size_t i = 0; i < n; i++) {
+            txids[i] = &outpoints[begin + i]->GetTxId();
+            ns[i] = outpoints[begin + i]->GetN();
+        }
+        SipHashUint256ExtraBatch(k0, k1, txids.data(), ns.data(), out + begin,
+                                 n);
+    }
+}
+
 CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn)
     : CCoinsViewBacked(baseIn), cachedCoinsUsage(0) {}
 
@@ -97,6 +97,13 @@ public:
     size_t operator()(const COutPoint &outpoint) const noexcept {
         return SipHashUint256Extra(k0, k1, outpoint.GetTxId(), outpoint.GetN());
     }
+
+    /**
+     * Hash count outpoints into out, several at a time. The results are the
+     * same as hashing them one by one.
+     */
+    void operator()(const COutPoint *const *outpoints, uint64_t *out,
+                    size_t count) const;
 };
 
 /**
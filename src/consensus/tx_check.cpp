@@ -8,7 +8,64 @@
 #include <primitives/transaction.h>
 #include <version.h>
 
-#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Return the index of the first input which spends the same outpoint as a
+ * previous one, or the number of inputs if there is none. The outpoints are
+ * hashed in a batch and sorted by hash, so only the ones with the same hash
+ * need to be compared. This avoids allocating a set node per input.
+ */
+static size_t FindFirstDuplicateInput(const CTransaction &tx) {
+    const size_t nInputs = tx.vin.size();
+    if (nInputs < 2) {
+        return nInputs;
+    }
+
+    std::vector<const COutPoint *> prevouts;
+    prevouts.reserve(nInputs);
+    for (const CTxIn &txin : tx.vin) {
+        prevouts.push_back(&txin.prevout);
+    }
+
+    // The salt makes it impractical to craft many outpoints with the same hash.
+    static const SaltedOutpointHasher hasher;
+    std::vector<uint64_t> hashes(nInputs);
+    hasher(prevouts.data(), hashes.data(), nInputs);
+
+    std::vector<std::pair<uint64_t, size_t>> sorted;
+    sorted.reserve(nInputs);
+    for (size_t i = 0; i < nInputs; i++) {
+        sorted.emplace_back(hashes[i], i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t firstDuplicate = nInputs;
+    for (size_t begin = 0; begin < nInputs;) {
+        size_t end = begin + 1;
+        while (end < nInputs && sorted[end].first == sorted[begin].first) {
+            end++;
+        }
+
+        // The indices are increasing within a group of equal hashes.
+        for (size_t i = begin + 1; i < end; i++) {
+            const size_t index = sorted[i].second;
+            for (size_t j = begin; j < i; j++) {
+                if (*prevouts[index] == *prevouts[sorted[j].second]) {
+                    firstDuplicate = std::min(firstDuplicate, index);
+                    break;
+                }
+            }
+        }
+
+        begin = end;
+    }
+
+    return firstDuplicate;
+}
 
 static bool CheckTransactionCommon(const CTransaction &tx,
                                    TxValidationState &state) {
@@ -82,20 +139,20 @@ bool CheckRegularTransaction(const CTransaction &tx, TxValidationState &state) {
         return false;
     }
 
-    std::unordered_set<COutPoint, SaltedOutpointHasher> vInOutPoints;
-    for (const auto &txin : tx.vin) {
-        if (txin.prevout.IsNull()) {
+    // Check for duplicate inputs (see CVE-2018-17144)
+    // While Consensus::CheckTxInputs does check if all inputs of a tx are
+    // available, and UpdateCoins marks all inputs of a tx as spent, it does
+    // not check if the tx has duplicate inputs. Failure to run this check
+    // will result in either a crash or an inflation bug, depending on the
+    // implementation of the underlying coins database.
+    const size_t firstDuplicate = FindFirstDuplicateInput(tx);
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        if (tx.vin[i].prevout.IsNull()) {
             return state.Invalid(TxValidationResult::TX_CONSENSUS,
                                  "bad-txns-prevout-null");
         }
 
-        // Check for duplicate inputs (see CVE-2018-17144)
-        // While Consensus::CheckTxInputs does check if all inputs of a tx are
-        // available, and UpdateCoins marks all inputs of a tx as spent, it does
-        // not check if the tx has duplicate inputs. Failure to run this check
-        // will result in either a crash or an inflation bug, depending on the
-        // implementation of the underlying coins database.
-        if (!vInOutPoints.insert(txin.prevout).second) {
+        if (i == firstDuplicate) {
             return state.Invalid(TxValidationResult::TX_CONSENSUS,
                                  "bad-txns-inputs-duplicate");
         }
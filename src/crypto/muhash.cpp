@@ -34,34 +34,6 @@ inline void extract3(limb_t &c0, limb_t &c1, limb_t &c2, limb_t &n) {
     c2 = 0;
 }
 
-/** [c0,c1] = a * b */
-inline void mul(limb_t &c0, limb_t &c1, const limb_t &a, const limb_t &b) {
-    double_limb_t t = (double_limb_t)a * b;
-    c1 = t >> LIMB_SIZE;
-    c0 = t;
-}
-
-/* [c0,c1,c2] += n * [d0,d1,d2]. c2 is 0 initially */
-inline void mulnadd3(limb_t &c0, limb_t &c1, limb_t &c2, limb_t &d0, limb_t &d1,
-                     limb_t &d2, const limb_t &n) {
-    double_limb_t t = (double_limb_t)d0 * n + c0;
-    c0 = t;
-    t >>= LIMB_SIZE;
-    t += (double_limb_t)d1 * n + c1;
-    c1 = t;
-    t >>= LIMB_SIZE;
-    c2 = t + d2 * n;
-}
-
-/* [c0,c1] *= n */
-inline void muln2(limb_t &c0, limb_t &c1, const limb_t &n) {
-    double_limb_t t = (double_limb_t)c0 * n;
-    c0 = t;
-    t >>= LIMB_SIZE;
-    t += (double_limb_t)c1 * n;
-    c1 = t;
-}
-
 /** [c0,c1,c2] += a * b */
 inline void muladd3(limb_t &c0, limb_t &c1, limb_t &c2, const limb_t &a,
                     const limb_t &b) {
@@ -93,27 +65,142 @@ inline void muldbladd3(limb_t &c0, limb_t &c1, limb_t &c2, const limb_t &a,
 }
 
 /**
- * Add limb a to [c0,c1]: [c0,c1] += a. Then extract the lowest
- * limb of [c0,c1] into n, and left shift the number by 1 limb.
+ * Up to this number of limbs, the products are computed with the schoolbook
+ * method rather than by splitting the operands in halves.
  */
-inline void addnextract2(limb_t &c0, limb_t &c1, const limb_t &a, limb_t &n) {
-    limb_t c2 = 0;
+constexpr int KARATSUBA_THRESHOLD = 12;
+
+/** r[0..N) = a + b, returning the carry. */
+template <int N>
+inline limb_t AddN(limb_t *r, const limb_t *a, const limb_t *b) {
+    limb_t carry = 0;
+    for (int i = 0; i < N; ++i) {
+        double_limb_t t = (double_limb_t)a[i] + b[i] + carry;
+        r[i] = t;
+        carry = t >> LIMB_SIZE;
+    }
+    return carry;
+}
+
+/** r[0..N) = a - b, returning the borrow. */
+template <int N>
+inline limb_t SubN(limb_t *r, const limb_t *a, const limb_t *b) {
+    limb_t borrow = 0;
+    for (int i = 0; i < N; ++i) {
+        double_limb_t t = (double_limb_t)a[i] - b[i] - borrow;
+        r[i] = t;
+        borrow = (t >> LIMB_SIZE) & 1;
+    }
+    return borrow;
+}
 
-    // add
-    c0 += a;
-    if (c0 < a) {
-        c1 += 1;
+/** r[0..N) = |a - b|, returning whether a < b. */
+template <int N>
+inline bool AbsDiff(limb_t *r, const limb_t *a, const limb_t *b) {
+    int i = N - 1;
+    while (i > 0 && a[i] == b[i]) {
+        --i;
+    }
+    if (a[i] < b[i]) {
+        SubN<N>(r, b, a);
+        return true;
+    }
+    SubN<N>(r, a, b);
+    return false;
+}
 
-        // Handle case when c1 has overflown
-        if (c1 == 0) {
-            c2 = 1;
+/** r[0..2N) = a * b, with the schoolbook method. */
+template <int N>
+inline void MulSchoolbook(limb_t *r, const limb_t *a, const limb_t *b) {
+    limb_t c0 = 0, c1 = 0, c2 = 0;
+    for (int k = 0; k < 2 * N - 1; ++k) {
+        const int start = k < N ? 0 : k - N + 1;
+        const int end = k < N ? k : N - 1;
+        for (int i = start; i <= end; ++i) {
+            muladd3(c0, c1, c2, a[i], b[k - i]);
         }
+        extract3(c0, c1, c2, r[k]);
     }
+    r[2 * N - 1] = c0;
+}
 
-    // extract
-    n = c0;
-    c0 = c1;
-    c1 = c2;
+/**
+ * r[0..2N) = a * a, with the schoolbook method. The products of distinct limbs
+ * are only computed once and doubled.
+ */
+template <int N> inline void SqrSchoolbook(limb_t *r, const limb_t *a) {
+    limb_t c0 = 0, c1 = 0, c2 = 0;
+    for (int k = 0; k < 2 * N - 1; ++k) {
+        int i = k < N ? 0 : k - N + 1;
+        for (; i < k - i; ++i) {
+            muldbladd3(c0, c1, c2, a[i], a[k - i]);
+        }
+        if (i == k - i) {
+            muladd3(c0, c1, c2, a[i], a[i]);
+        }
+        extract3(c0, c1, c2, r[k]);
+    }
+    r[2 * N - 1] = c0;
+}
+
+/**
+ * Add the middle term z1 of a Karatsuba product to r[0..2N), which holds the
+ * low and high halves products z0 and z2. z1 is z0 + z2 + m or z0 + z2 - m.
+ */
+template <int N>
+inline void AddMiddle(limb_t *r, const limb_t *m, bool negative) {
+    constexpr int H = N / 2;
+    limb_t z1[N];
+    limb_t carry = AddN<N>(z1, r, r + N);
+    if (negative) {
+        carry -= SubN<N>(z1, z1, m);
+    } else {
+        carry += AddN<N>(z1, z1, m);
+    }
+
+    carry += AddN<N>(r + H, r + H, z1);
+    for (int i = H + N; i < 2 * N; ++i) {
+        r[i] += carry;
+        carry = r[i] < carry;
+    }
+}
+
+/**
+ * r[0..2N) = a * b. The operands are split in halves, so the product only
+ * needs 3 half size products instead of 4 (Karatsuba).
+ */
+template <int N> void Mul(limb_t *r, const limb_t *a, const limb_t *b) {
+    if constexpr (N <= KARATSUBA_THRESHOLD || N % 2 != 0) {
+        MulSchoolbook<N>(r, a, b);
+    } else {
+        constexpr int H = N / 2;
+        Mul<H>(r, a, b);
+        Mul<H>(r + N, a + H, b + H);
+
+        // a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 + (a0 - a1) * (b1 - b0)
+        limb_t da[H], db[H], m[N];
+        const bool negative =
+            AbsDiff<H>(da, a, a + H) != AbsDiff<H>(db, b + H, b);
+        Mul<H>(m, da, db);
+        AddMiddle<N>(r, m, negative);
+    }
+}
+
+/** r[0..2N) = a * a, using Karatsuba as well. */
+template <int N> void Sqr(limb_t *r, const limb_t *a) {
+    if constexpr (N <= KARATSUBA_THRESHOLD || N % 2 != 0) {
+        SqrSchoolbook<N>(r, a);
+    } else {
+        constexpr int H = N / 2;
+        Sqr<H>(r, a);
+        Sqr<H>(r + N, a + H);
+
+        // 2 * a0 * a1 = a0 * a0 + a1 * a1 - (a0 - a1) * (a0 - a1)
+        limb_t d[H], m[N];
+        AbsDiff<H>(d, a, a + H);
+        Sqr<H>(m, d);
+        AddMiddle<N>(r, m, true);
+    }
 }
 
 /** in_out = in_out^(2^sq) * mul */
@@ -140,10 +227,10 @@ bool Num3072::IsOverflow() const {
 }
 
 void Num3072::FullReduce() {
-    limb_t c0 = MAX_PRIME_DIFF;
-    limb_t c1 = 0;
+    limb_t carry = MAX_PRIME_DIFF;
     for (int i = 0; i < LIMBS; ++i) {
-        addnextract2(c0, c1, this->limbs[i], this->limbs[i]);
+        this->limbs[i] += carry;
+        carry = this->limbs[i] < carry;
     }
 }
 
@@ -187,105 +274,47 @@ Num3072 Num3072::GetInverse() const {
     return out;
 }
 
-void Num3072::Multiply(const Num3072 &a) {
-    limb_t c0 = 0, c1 = 0, c2 = 0;
-    Num3072 tmp;
-
-    /* Compute limbs 0..N-2 of this*a into tmp, including one reduction. */
-    for (int j = 0; j < LIMBS - 1; ++j) {
-        limb_t d0 = 0, d1 = 0, d2 = 0;
-        mul(d0, d1, this->limbs[1 + j], a.limbs[LIMBS + j - (1 + j)]);
-        for (int i = 2 + j; i < LIMBS; ++i) {
-            muladd3(d0, d1, d2, this->limbs[i], a.limbs[LIMBS + j - i]);
-        }
-        mulnadd3(c0, c1, c2, d0, d1, d2, MAX_PRIME_DIFF);
-        for (int i = 0; i < j + 1; ++i) {
-            muladd3(c0, c1, c2, this->limbs[i], a.limbs[j - i]);
-        }
-        extract3(c0, c1, c2, tmp.limbs[j]);
-    }
-
-    /* Compute limb N-1 of a*b into tmp. */
-    assert(c2 == 0);
+void Num3072::Reduce(const limb_t (&t)[2 * LIMBS]) {
+    // 2^3072 is MAX_PRIME_DIFF modulo the prime, so the high half of the
+    // product is folded into the low half after multiplying it by
+    // MAX_PRIME_DIFF.
+    limb_t carry = 0;
     for (int i = 0; i < LIMBS; ++i) {
-        muladd3(c0, c1, c2, this->limbs[i], a.limbs[LIMBS - 1 - i]);
+        double_limb_t x = (double_limb_t)t[LIMBS + i] * MAX_PRIME_DIFF + t[i] +
+                          carry;
+        this->limbs[i] = x;
+        carry = x >> LIMB_SIZE;
     }
-    extract3(c0, c1, c2, tmp.limbs[LIMBS - 1]);
 
-    /* Perform a second reduction. */
-    muln2(c0, c1, MAX_PRIME_DIFF);
-    for (int j = 0; j < LIMBS; ++j) {
-        addnextract2(c0, c1, tmp.limbs[j], this->limbs[j]);
+    // Fold the carry the same way. If this overflows again, the number is now
+    // small enough that folding the last carry doesn't.
+    for (int round = 0; round < 2 && carry; ++round) {
+        double_limb_t x =
+            (double_limb_t)carry * MAX_PRIME_DIFF + this->limbs[0];
+        this->limbs[0] = x;
+        carry = x >> LIMB_SIZE;
+        for (int i = 1; i < LIMBS && carry; ++i) {
+            this->limbs[i] += carry;
+            carry = this->limbs[i] < carry;
+        }
     }
+    assert(carry == 0);
 
-    assert(c1 == 0);
-    assert(c0 == 0 || c0 == 1);
-
-    /**
-     * Perform up to two more reductions if the internal state has already
-     * overflown the MAX of Num3072 or if it is larger than the modulus or
-     * if both are the case.
-     */
     if (this->IsOverflow()) {
         this->FullReduce();
     }
-    if (c0) {
-        this->FullReduce();
-    }
 }
 
-void Num3072::Square() {
-    limb_t c0 = 0, c1 = 0, c2 = 0;
-    Num3072 tmp;
-
-    /* Compute limbs 0..N-2 of this*this into tmp, including one reduction. */
-    for (int j = 0; j < LIMBS - 1; ++j) {
-        limb_t d0 = 0, d1 = 0, d2 = 0;
-        for (int i = 0; i < (LIMBS - 1 - j) / 2; ++i) {
-            muldbladd3(d0, d1, d2, this->limbs[i + j + 1],
-                       this->limbs[LIMBS - 1 - i]);
-        }
-        if ((j + 1) & 1) {
-            muladd3(d0, d1, d2, this->limbs[(LIMBS - 1 - j) / 2 + j + 1],
-                    this->limbs[LIMBS - 1 - (LIMBS - 1 - j) / 2]);
-        }
-        mulnadd3(c0, c1, c2, d0, d1, d2, MAX_PRIME_DIFF);
-        for (int i = 0; i < (j + 1) / 2; ++i) {
-            muldbladd3(c0, c1, c2, this->limbs[i], this->limbs[j - i]);
-        }
-        if ((j + 1) & 1) {
-            muladd3(c0, c1, c2, this->limbs[(j + 1) / 2],
-                    this->limbs[j - (j + 1) / 2]);
-        }
-        extract3(c0, c1, c2, tmp.limbs[j]);
-    }
-
-    assert(c2 == 0);
-    for (int i = 0; i < LIMBS / 2; ++i) {
-        muldbladd3(c0, c1, c2, this->limbs[i], this->limbs[LIMBS - 1 - i]);
-    }
-    extract3(c0, c1, c2, tmp.limbs[LIMBS - 1]);
-
-    /* Perform a second reduction. */
-    muln2(c0, c1, MAX_PRIME_DIFF);
-    for (int j = 0; j < LIMBS; ++j) {
-        addnextract2(c0, c1, tmp.limbs[j], this->limbs[j]);
-    }
-
-    assert(c1 == 0);
-    assert(c0 == 0 || c0 == 1);
+void Num3072::Multiply(const Num3072 &a) {
+    limb_t t[2 * LIMBS];
+    Mul<LIMBS>(t, this->limbs, a.limbs);
+    Reduce(t);
+}
 
-    /**
-     * Perform up to two more reductions if the internal state has already
-     * overflown the MAX of Num3072 or if it is larger than the modulus or
-     * if both are the case.
-     */
-    if (this->IsOverflow()) {
-        this->FullReduce();
-    }
-    if (c0) {
-        this->FullReduce();
-    }
+void Num3072::Square() {
+    limb_t t[2 * LIMBS];
+    Sqr<LIMBS>(t, this->limbs);
+    Reduce(t);
 }
 
 void Num3072::SetToOne() {
@@ -346,6 +375,18 @@ Num3072 MuHash3072::ToNum3072(Span<const uint8_t> in) {
     return out;
 }
 
+Num3072 MuHash3072::ToNum3072Product(Span<const Span<const uint8_t>> in) {
+    if (in.empty()) {
+        return Num3072{};
+    }
+
+    Num3072 out = ToNum3072(in[0]);
+    for (const Span<const uint8_t> &data : in.subspan(1)) {
+        out.Multiply(ToNum3072(data));
+    }
+    return out;
+}
+
 MuHash3072::MuHash3072(Span<const uint8_t> in) noexcept {
     m_numerator = ToNum3072(in);
 }
@@ -382,3 +423,15 @@ MuHash3072 &MuHash3072::Remove(Span<const uint8_t> in) noexcept {
     m_denominator.Multiply(ToNum3072(in));
     return *this;
 }
+
+MuHash3072 &
+MuHash3072::InsertBatch(Span<const Span<const uint8_t>> in) noexcept {
+    m_numerator.Multiply(ToNum3072Product(in));
+    return *this;
+}
+
+MuHash3072 &
+MuHash3072::RemoveBatch(Span<const Span<const uint8_t>> in) noexcept {
+    m_denominator.Multiply(ToNum3072Product(in));
+    return *this;
+}
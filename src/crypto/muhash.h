@@ -47,6 +47,11 @@ public:
     static_assert(sizeof(limb_t) == 4 || sizeof(limb_t) == 8,
                   "bad size for limb_t");
 
+private:
+    /** Set this to the double size product t, reduced modulo the prime. */
+    void Reduce(const limb_t (&t)[2 * LIMBS]);
+
+public:
     void Multiply(const Num3072 &a);
     void Divide(const Num3072 &a);
     void SetToOne();
@@ -99,6 +104,7 @@ private:
     Num3072 m_denominator;
 
     Num3072 ToNum3072(Span<const uint8_t> in);
+    Num3072 ToNum3072Product(Span<const Span<const uint8_t>> in);
 
 public:
     /* The empty set. */
@@ -113,6 +119,15 @@ public:
     /* Remove a single piece of data from the set. */
     MuHash3072 &Remove(Span<const uint8_t> in) noexcept;
 
+    /**
+     * Insert several pieces of data into the set. Their product is computed
+     * first, then multiplied into the numerator once.
+     */
+    MuHash3072 &InsertBatch(Span<const Span<const uint8_t>> in) noexcept;
+
+    /* Remove several pieces of data from the set, the same way. */
+    MuHash3072 &RemoveBatch(Span<const Span<const uint8_t>> in) noexcept;
+
     /* Multiply (resulting in a hash for the union of the sets) */
     MuHash3072 &operator*=(const MuHash3072 &mul) noexcept;
 
@@ -10,6 +10,16 @@
 #include <cassert>
 #include <cstring>
 
+#if defined(ENABLE_ARM_SHANI) && !defined(BUILD_BITCOIN_INTERNAL)
+#if defined(__linux__) && defined(__aarch64__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#endif
+#endif
+
 #if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #if defined(USE_ASM)
 namespace sha256_sse4 {
@@ -26,6 +36,14 @@ namespace sha256d64_avx2 {
 void Transform_8way(uint8_t *out, const uint8_t *in);
 }
 
+namespace sha256d64_avx512 {
+void Transform_16way(uint8_t *out, const uint8_t *in);
+}
+
+namespace sha256_avx2 {
+void Transform_8way(uint32_t *s, const uint8_t *const *chunks);
+}
+
 namespace sha256d64_shani {
 void Transform_2way(uint8_t *out, const uint8_t *in);
 }
@@ -34,6 +52,10 @@ namespace sha256_shani {
 void Transform(uint32_t *s, const uint8_t *chunk, size_t blocks);
 }
 
+namespace sha256_arm_shani {
+void Transform(uint32_t *s, const uint8_t *chunk, size_t blocks);
+}
+
 // Internal implementation code.
 namespace {
 /// Internal SHA-256 implementation.
@@ -578,6 +600,7 @@ namespace sha256 {
 
 typedef void (*TransformType)(uint32_t *, const uint8_t *, size_t);
 typedef void (*TransformD64Type)(uint8_t *, const uint8_t *);
+typedef void (*TransformMultiType)(uint32_t *, const uint8_t *const *);
 
 template <TransformType tr>
 void TransformD64Wrapper(uint8_t *out, const uint8_t *in) {
@@ -618,6 +641,8 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -729,6 +754,41 @@ bool SelfTest() {
         }
     }
 
+    // Test TransformD64_16way, if available. There are only 8 messages in the
+    // test data, so they are hashed twice.
+    if (TransformD64_16way) {
+        uint8_t in[1024];
+        std::copy(data + 1, data + 513, in);
+        std::copy(data + 1, data + 513, in + 512);
+        uint8_t out[512];
+        TransformD64_16way(out, in);
+        if (!std::equal(out, out + 256, result_d64) ||
+            !std::equal(out + 256, out + 512, result_d64)) {
+            return false;
+        }
+    }
+
+    // Test TransformMulti_8way, if available. Each lane processes a different
+    // chunk of the input, starting from the state after the previous chunks.
+    if (TransformMulti_8way) {
+        uint32_t state[64];
+        const uint8_t *chunks[8];
+        for (size_t lane = 0; lane < 8; ++lane) {
+            for (size_t i = 0; i < 8; ++i) {
+                state[8 * i + lane] = result[lane][i];
+            }
+            chunks[lane] = data + 1 + 64 * lane;
+        }
+        TransformMulti_8way(state, chunks);
+        for (size_t lane = 0; lane < 8; ++lane) {
+            for (size_t i = 0; i < 8; ++i) {
+                if (state[8 * i + lane] != result[lane + 1][i]) {
+                    return false;
+                }
+            }
+        }
+    }
+
     return true;
 }
 
@@ -740,6 +800,13 @@ bool AVXEnabled() {
     __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
     return (a & 6) == 6;
 }
+
+/** Check whether the OS has enabled the AVX-512 opmask and ZMM registers. */
+bool AVX512Enabled() {
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 0xe6) == 0xe6;
+}
 #endif
 } // namespace
 
@@ -750,16 +817,21 @@ std::string SHA256AutoDetect() {
     bool have_xsave = false;
     bool have_avx = false;
     bool have_avx2 = false;
+    bool have_avx512 = false;
     bool have_shani = false;
     bool enabled_avx = false;
+    bool enabled_avx512 = false;
 
     (void)AVXEnabled;
+    (void)AVX512Enabled;
     (void)have_sse4;
     (void)have_avx;
     (void)have_xsave;
     (void)have_avx2;
+    (void)have_avx512;
     (void)have_shani;
     (void)enabled_avx;
+    (void)enabled_avx512;
 
     uint32_t eax, ebx, ecx, edx;
     GetCPUID(1, 0, eax, ebx, ecx, edx);
@@ -768,10 +840,12 @@ std::string SHA256AutoDetect() {
     have_avx = (ecx >> 28) & 1;
     if (have_xsave && have_avx) {
         enabled_avx = AVXEnabled();
+        enabled_avx512 = AVX512Enabled();
     }
     if (have_sse4) {
         GetCPUID(7, 0, eax, ebx, ecx, edx);
         have_avx2 = (ebx >> 5) & 1;
+        have_avx512 = (ebx >> 16) & 1;
         have_shani = (ebx >> 29) & 1;
     }
 
@@ -801,9 +875,38 @@ std::string SHA256AutoDetect() {
 #if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256_avx2::Transform_8way;
         ret += ",avx2(8way)";
     }
 #endif
+
+#if defined(ENABLE_AVX512) && !defined(BUILD_BITCOIN_INTERNAL)
+    // Hashing 16 messages at once outperforms the SHA-NI 2-way transform, so
+    // this is used for the batches of 64 bytes messages whenever available.
+    if (have_avx512 && have_avx && enabled_avx512) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
+#endif
+
+#if defined(ENABLE_ARM_SHANI) && !defined(BUILD_BITCOIN_INTERNAL)
+    bool have_arm_shani = false;
+#if defined(__linux__) && defined(__aarch64__)
+    have_arm_shani = getauxval(AT_HWCAP) & HWCAP_SHA2;
+#elif defined(__APPLE__)
+    int val = 0;
+    size_t len = sizeof(val);
+    if (sysctlbyname("hw.optional.arm.FEAT_SHA256", &val, &len, nullptr, 0) ==
+        0) {
+        have_arm_shani = val != 0;
+    }
+#endif
+    if (have_arm_shani) {
+        Transform = sha256_arm_shani::Transform;
+        TransformD64 = TransformD64Wrapper<sha256_arm_shani::Transform>;
+        ret = "arm_shani(1way)";
+    }
 #endif
 
     assert(SelfTest());
@@ -864,6 +967,14 @@ CSHA256 &CSHA256::Reset() {
 }
 
 void SHA256D64(uint8_t *out, const uint8_t *in, size_t blocks) {
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
     if (TransformD64_8way) {
         while (blocks >= 8) {
             TransformD64_8way(out, in);
@@ -895,3 +1006,162 @@ void SHA256D64(uint8_t *out, const uint8_t *in, size_t blocks) {
         --blocks;
     }
 }
+
+namespace {
+/**
+ * When there are no more messages to start and fewer lanes than this are still
+ * busy, it is faster to finish them one by one.
+ */
+static constexpr size_t MULTI_MIN_BUSY_LANES = 4;
+
+/** A message being hashed in a lane of the multi-buffer transform. */
+struct MultiLane {
+    //! Index of the message, only meaningful if the lane is busy.
+    size_t index;
+    bool busy;
+    //! Whether this is the second hash of a double SHA256.
+    bool second;
+    //! The full chunks of the message which remain to be processed.
+    const uint8_t *data;
+    size_t blocks;
+    //! The end of the message followed by the padding.
+    uint8_t tail[128];
+    size_t tail_pos;
+    size_t tail_blocks;
+
+    void Start(const uint8_t *in, size_t size) {
+        data = in;
+        blocks = size / 64;
+        const size_t remaining = size % 64;
+        tail_pos = 0;
+        tail_blocks = remaining + 9 > 64 ? 2 : 1;
+        memcpy(tail, in + 64 * blocks, remaining);
+        tail[remaining] = 0x80;
+        memset(tail + remaining + 1, 0, 64 * tail_blocks - remaining - 9);
+        WriteBE64(tail + 64 * tail_blocks - 8, uint64_t(size) << 3);
+    }
+
+    const uint8_t *NextChunk() {
+        if (blocks) {
+            blocks--;
+            data += 64;
+            return data - 64;
+        }
+        return tail + 64 * tail_pos++;
+    }
+
+    bool Done() const { return blocks == 0 && tail_pos == tail_blocks; }
+};
+
+void WriteState(uint8_t *out, const uint32_t *s, size_t stride) {
+    for (size_t i = 0; i < 8; ++i) {
+        WriteBE32(out + 4 * i, s[stride * i]);
+    }
+}
+
+void SHA256MultiImpl(uint8_t *out, const uint8_t *const *inputs,
+                     const size_t *sizes, size_t count, bool dbl) {
+    size_t next = 0;
+    if (TransformMulti_8way && count >= MULTI_MIN_BUSY_LANES) {
+        static const uint8_t idle_chunk[64] = {0};
+        static const uint32_t init[8] = {0x6a09e667ul, 0xbb67ae85ul,
+                                         0x3c6ef372ul, 0xa54ff53aul,
+                                         0x510e527ful, 0x9b05688cul,
+                                         0x1f83d9abul, 0x5be0cd19ul};
+
+        uint32_t state[64];
+        MultiLane lanes[8];
+        const uint8_t *chunks[8];
+        size_t busy = 0;
+
+        auto StartHash = [&](size_t lane, const uint8_t *in, size_t size) {
+            for (size_t i = 0; i < 8; ++i) {
+                state[8 * i + lane] = init[i];
+            }
+            lanes[lane].Start(in, size);
+        };
+        auto StartNextMessage = [&](size_t lane) {
+            lanes[lane].busy = next < count;
+            if (!lanes[lane].busy) {
+                return;
+            }
+            lanes[lane].index = next;
+            lanes[lane].second = false;
+            StartHash(lane, inputs[next], sizes[next]);
+            busy++;
+            next++;
+        };
+
+        for (size_t lane = 0; lane < 8; ++lane) {
+            StartNextMessage(lane);
+        }
+
+        // The idle lanes are refilled as long as there are messages left, so
+        // this only stops once they have all been started.
+        while (busy >= MULTI_MIN_BUSY_LANES) {
+            for (size_t lane = 0; lane < 8; ++lane) {
+                chunks[lane] =
+                    lanes[lane].busy ? lanes[lane].NextChunk() : idle_chunk;
+            }
+            TransformMulti_8way(state, chunks);
+
+            for (size_t lane = 0; lane < 8; ++lane) {
+                MultiLane &l = lanes[lane];
+                if (!l.busy || !l.Done()) {
+                    continue;
+                }
+                if (dbl && !l.second) {
+                    // Hash the digest in the same lane.
+                    uint8_t digest[32];
+                    WriteState(digest, state + lane, 8);
+                    StartHash(lane, digest, 32);
+                    l.second = true;
+                    continue;
+                }
+                WriteState(out + 32 * l.index, state + lane, 8);
+                busy--;
+                StartNextMessage(lane);
+            }
+        }
+
+        // Finish the remaining messages one by one.
+        for (size_t lane = 0; lane < 8; ++lane) {
+            MultiLane &l = lanes[lane];
+            if (!l.busy) {
+                continue;
+            }
+            uint32_t s[8];
+            for (size_t i = 0; i < 8; ++i) {
+                s[i] = state[8 * i + lane];
+            }
+            if (l.blocks) {
+                Transform(s, l.data, l.blocks);
+            }
+            Transform(s, l.tail + 64 * l.tail_pos, l.tail_blocks - l.tail_pos);
+            uint8_t *result = out + 32 * l.index;
+            WriteState(result, s, 1);
+            if (dbl && !l.second) {
+                CSHA256().Write(result, 32).Finalize(result);
+            }
+        }
+    }
+
+    for (; next < count; ++next) {
+        uint8_t *result = out + 32 * next;
+        CSHA256().Write(inputs[next], sizes[next]).Finalize(result);
+        if (dbl) {
+            CSHA256().Write(result, 32).Finalize(result);
+        }
+    }
+}
+} // namespace
+
+void SHA256Multi(uint8_t *output, const uint8_t *const *inputs,
+                 const size_t *sizes, size_t count) {
+    SHA256MultiImpl(output, inputs, sizes, count, false);
+}
+
+void SHA256DMulti(uint8_t *output, const uint8_t *const *inputs,
+                  const size_t *sizes, size_t count) {
+    SHA256MultiImpl(output, inputs, sizes, count, true);
+}
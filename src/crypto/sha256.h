@@ -39,4 +39,19 @@ std::string SHA256AutoDetect();
  */
 void SHA256D64(uint8_t *output, const uint8_t *input, size_t blocks);
 
+/**
+ * Compute the SHA256's of multiple independent messages of any size, several
+ * of them at once when a multi-buffer implementation is available.
+ * output:  pointer to a count*32 byte output buffer
+ * inputs:  pointers to the messages
+ * sizes:   the sizes of the messages
+ * count:   the number of hashes to compute.
+ */
+void SHA256Multi(uint8_t *output, const uint8_t *const *inputs,
+                 const size_t *sizes, size_t count);
+
+/** Same as SHA256Multi, computing double-SHA256's. */
+void SHA256DMulti(uint8_t *output, const uint8_t *const *inputs,
+                  const size_t *sizes, size_t count);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
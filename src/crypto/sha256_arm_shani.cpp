@@ -0,0 +1,78 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Based on the ARMv8 SHA2 extensions sample code, which is in the public
+// domain, by Jeffrey Walton.
+
+#ifdef ENABLE_ARM_SHANI
+
+#include <arm_acle.h>
+#include <arm_neon.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+alignas(16) const uint32_t K[64] = {
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul,
+    0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul, 0xd807aa98ul, 0x12835b01ul,
+    0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul,
+    0xc19bf174ul, 0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+    0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul, 0x983e5152ul,
+    0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul,
+    0x06ca6351ul, 0x14292967ul, 0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul,
+    0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul,
+    0xd6990624ul, 0xf40e3585ul, 0x106aa070ul, 0x19a4c116ul, 0x1e376c08ul,
+    0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful,
+    0x682e6ff3ul, 0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+    0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+};
+
+uint32x4_t inline Load(const uint8_t *chunk) {
+    // The message words are big endian.
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(chunk)));
+}
+} // namespace
+
+namespace sha256_arm_shani {
+void Transform(uint32_t *s, const uint8_t *chunk, size_t blocks) {
+    // Unlike the x86 SHA extensions, the state is kept as ABCD and EFGH.
+    uint32x4_t abcd = vld1q_u32(s);
+    uint32x4_t efgh = vld1q_u32(s + 4);
+
+    while (blocks--) {
+        const uint32x4_t abcd_save = abcd;
+        const uint32x4_t efgh_save = efgh;
+
+        // msg[j] holds the message words 4 * j to 4 * j + 3 of the current
+        // group of 16 words.
+        uint32x4_t msg[4] = {Load(chunk), Load(chunk + 16), Load(chunk + 32),
+                             Load(chunk + 48)};
+
+        // 16 groups of 4 rounds.
+        for (int i = 0; i < 16; ++i) {
+            const uint32x4_t wk = vaddq_u32(msg[i % 4], vld1q_u32(K + 4 * i));
+            if (i < 12) {
+                // Expand the 4 message words needed 4 groups from now.
+                msg[i % 4] = vsha256su1q_u32(
+                    vsha256su0q_u32(msg[i % 4], msg[(i + 1) % 4]),
+                    msg[(i + 2) % 4], msg[(i + 3) % 4]);
+            }
+            const uint32x4_t abcd_prev = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, abcd_prev, wk);
+        }
+
+        abcd = vaddq_u32(abcd, abcd_save);
+        efgh = vaddq_u32(efgh, efgh_save);
+        chunk += 64;
+    }
+
+    vst1q_u32(s, abcd);
+    vst1q_u32(s + 4, efgh);
+}
+} // namespace sha256_arm_shani
+
+#endif
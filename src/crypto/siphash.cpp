@@ -4,6 +4,27 @@
 
 #include <crypto/siphash.h>
 
+#include <compat/cpuid.h>
+#include <crypto/common.h>
+
+#include <cstddef>
+
+namespace siphash_avx2 {
+void SipHashUint256_4way(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                         uint64_t *out);
+void SipHashUint256Extra_4way(uint64_t k0, uint64_t k1,
+                              const uint256 *const *vals,
+                              const uint32_t *extras, uint64_t *out);
+} // namespace siphash_avx2
+
+namespace siphash_avx512 {
+void SipHashUint256_8way(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                         uint64_t *out);
+void SipHashUint256Extra_8way(uint64_t k0, uint64_t k1,
+                              const uint256 *const *vals,
+                              const uint32_t *extras, uint64_t *out);
+} // namespace siphash_avx512
+
 #define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
 
 #define SIPROUND                                                               \
@@ -57,6 +78,31 @@ CSipHasher &CSipHasher::Write(const uint8_t *data, size_t size) {
     uint64_t t = tmp;
     uint8_t c = count;
 
+    // Complete the pending word one byte at a time, then process whole words.
+    while (size && (c & 7) != 0) {
+        t |= uint64_t(*(data++)) << (8 * (c % 8));
+        c++;
+        size--;
+        if ((c & 7) == 0) {
+            v3 ^= t;
+            SIPROUND;
+            SIPROUND;
+            v0 ^= t;
+            t = 0;
+        }
+    }
+
+    while (size >= 8) {
+        uint64_t w = ReadLE64(data);
+        v3 ^= w;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= w;
+        data += 8;
+        size -= 8;
+        c += 8;
+    }
+
     while (size--) {
         t |= uint64_t(*(data++)) << (8 * (c % 8));
         c++;
@@ -175,3 +221,121 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256 &val,
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+
+using HashNWayFn = void (*)(uint64_t k0, uint64_t k1,
+                            const uint256 *const *vals, uint64_t *out);
+using HashExtraNWayFn = void (*)(uint64_t k0, uint64_t k1,
+                                 const uint256 *const *vals,
+                                 const uint32_t *extras, uint64_t *out);
+
+/** The multi way implementations the CPU supports, if any. */
+struct BatchImpl {
+    HashNWayFn hash4way = nullptr;
+    HashExtraNWayFn hashExtra4way = nullptr;
+    HashNWayFn hash8way = nullptr;
+    HashExtraNWayFn hashExtra8way = nullptr;
+};
+
+#if (defined(ENABLE_AVX2) || defined(ENABLE_AVX512)) &&                        \
+    defined(HAVE_GETCPUID) && !defined(BUILD_BITCOIN_INTERNAL)
+/** Check that the OS saves the AVX registers. */
+bool AVXEnabled() {
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+
+/** Check that the OS saves the AVX-512 opmask and ZMM registers as well. */
+bool AVX512Enabled() {
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 0xe6) == 0xe6;
+}
+#endif
+
+/**
+ * Select the multi way implementations the CPU supports. There is no point in
+ * interleaving the scalar implementation: the CPU already overlaps the
+ * computation of consecutive hashes.
+ */
+BatchImpl DetectBatchImpl() {
+    BatchImpl impl;
+#if (defined(ENABLE_AVX2) || defined(ENABLE_AVX512)) &&                        \
+    defined(HAVE_GETCPUID) && !defined(BUILD_BITCOIN_INTERNAL)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave = (ecx >> 27) & 1;
+    const bool have_avx = (ecx >> 28) & 1;
+    if (!have_xsave || !have_avx || !AVXEnabled()) {
+        return impl;
+    }
+
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+#if defined(ENABLE_AVX2)
+    if ((ebx >> 5) & 1) {
+        impl.hash4way = siphash_avx2::SipHashUint256_4way;
+        impl.hashExtra4way = siphash_avx2::SipHashUint256Extra_4way;
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (((ebx >> 16) & 1) && AVX512Enabled()) {
+        impl.hash8way = siphash_avx512::SipHashUint256_8way;
+        impl.hashExtra8way = siphash_avx512::SipHashUint256Extra_8way;
+    }
+#endif
+#endif
+    return impl;
+}
+
+const BatchImpl &GetBatchImpl() {
+    static const BatchImpl impl = DetectBatchImpl();
+    return impl;
+}
+
+} // namespace
+
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                         uint64_t *out, size_t count) {
+    const BatchImpl &impl = GetBatchImpl();
+
+    size_t i = 0;
+    if (impl.hash8way) {
+        for (; i + 8 <= count; i += 8) {
+            impl.hash8way(k0, k1, vals + i, out + i);
+        }
+    }
+    if (impl.hash4way) {
+        for (; i + 4 <= count; i += 4) {
+            impl.hash4way(k0, k1, vals + i, out + i);
+        }
+    }
+
+    for (; i < count; i++) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
+
+void SipHashUint256ExtraBatch(uint64_t k0, uint64_t k1,
+                              const uint256 *const *vals,
+                              const uint32_t *extras, uint64_t *out,
+                              size_t count) {
+    const BatchImpl &impl = GetBatchImpl();
+
+    size_t i = 0;
+    if (impl.hashExtra8way) {
+        for (; i + 8 <= count; i += 8) {
+            impl.hashExtra8way(k0, k1, vals + i, extras + i, out + i);
+        }
+    }
+    if (impl.hashExtra4way) {
+        for (; i + 4 <= count; i += 4) {
+            impl.hashExtra4way(k0, k1, vals + i, extras + i, out + i);
+        }
+    }
+
+    for (; i < count; i++) {
+        out[i] = SipHashUint256Extra(k0, k1, *vals[i], extras[i]);
+    }
+}
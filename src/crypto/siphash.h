@@ -7,6 +7,7 @@
 
 #include <uint256.h>
 
+#include <cstddef>
 #include <cstdint>
 
 /** SipHash-2-4 */
@@ -48,4 +49,24 @@ uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256 &val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256 &val,
                              uint32_t extra);
 
+/**
+ * Compute SipHashUint256(k0, k1, *vals[i]) into out[i] for i in [0, count).
+ *
+ * When the CPU supports AVX2 or AVX-512, the values are hashed 4 or 8 at a
+ * time, which is about two to four times as fast as hashing them one by one,
+ * e.g. when matching the mempool against the short ids of a compact block. The
+ * values are passed by pointer so they don't need to be contiguous.
+ */
+void SipHashUint256Batch(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                         uint64_t *out, size_t count);
+
+/**
+ * Compute SipHashUint256Extra(k0, k1, *vals[i], extras[i]) into out[i] for i
+ * in [0, count), the same way as SipHashUint256Batch.
+ */
+void SipHashUint256ExtraBatch(uint64_t k0, uint64_t k1,
+                              const uint256 *const *vals,
+                              const uint32_t *extras, uint64_t *out,
+                              size_t count);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
@@ -0,0 +1,125 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <uint256.h>
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace siphash_avx2 {
+namespace {
+
+    __m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+
+    __m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+    __m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+
+    template <int b> __m256i inline Rotl(__m256i x) {
+        return _mm256_or_si256(_mm256_slli_epi64(x, b),
+                               _mm256_srli_epi64(x, 64 - b));
+    }
+
+    /** Rotations by multiples of 16 bits are byte shuffles. */
+    template <> __m256i inline Rotl<16>(__m256i x) {
+        return _mm256_shuffle_epi8(
+            x, _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11,
+                                12, 13, 6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9,
+                                10, 11, 12, 13));
+    }
+    template <> __m256i inline Rotl<32>(__m256i x) {
+        return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    void inline SipRound(__m256i &v0, __m256i &v1, __m256i &v2, __m256i &v3) {
+        v0 = Add(v0, v1);
+        v1 = Rotl<13>(v1);
+        v1 = Xor(v1, v0);
+        v0 = Rotl<32>(v0);
+        v2 = Add(v2, v3);
+        v3 = Rotl<16>(v3);
+        v3 = Xor(v3, v2);
+        v0 = Add(v0, v3);
+        v3 = Rotl<21>(v3);
+        v3 = Xor(v3, v0);
+        v2 = Add(v2, v1);
+        v1 = Rotl<17>(v1);
+        v1 = Xor(v1, v2);
+        v2 = Rotl<32>(v2);
+    }
+
+    void inline Compress(__m256i &v0, __m256i &v1, __m256i &v2, __m256i &v3,
+                         __m256i d) {
+        v3 = Xor(v3, d);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        v0 = Xor(v0, d);
+    }
+
+    __m256i inline Load(const uint256 *val) {
+        return _mm256_loadu_si256((const __m256i *)val->begin());
+    }
+
+    /**
+     * Hash the 4 values, followed by the 4 extra words if any. The final word
+     * holds the message length in its top byte.
+     */
+    void inline Hash(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                     const uint32_t *extras, uint64_t *out) {
+        __m256i v0 = K(0x736f6d6570736575ULL ^ k0);
+        __m256i v1 = K(0x646f72616e646f6dULL ^ k1);
+        __m256i v2 = K(0x6c7967656e657261ULL ^ k0);
+        __m256i v3 = K(0x7465646279746573ULL ^ k1);
+
+        // Transpose the 4 values so that each register holds the same 64-bit
+        // word of all of them. The uint256 words are little endian, as are the
+        // lanes.
+        __m256i r0 = Load(vals[0]);
+        __m256i r1 = Load(vals[1]);
+        __m256i r2 = Load(vals[2]);
+        __m256i r3 = Load(vals[3]);
+        __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+        __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+        __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+        __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+
+        Compress(v0, v1, v2, v3, _mm256_permute2x128_si256(t0, t2, 0x20));
+        Compress(v0, v1, v2, v3, _mm256_permute2x128_si256(t1, t3, 0x20));
+        Compress(v0, v1, v2, v3, _mm256_permute2x128_si256(t0, t2, 0x31));
+        Compress(v0, v1, v2, v3, _mm256_permute2x128_si256(t1, t3, 0x31));
+        if (extras) {
+            Compress(v0, v1, v2, v3,
+                     _mm256_or_si256(K(uint64_t(36) << 56),
+                                     _mm256_cvtepu32_epi64(_mm_loadu_si128(
+                                         (const __m128i *)extras))));
+        } else {
+            Compress(v0, v1, v2, v3, K(uint64_t(4) << 59));
+        }
+
+        v2 = Xor(v2, K(0xFF));
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+
+        _mm256_storeu_si256((__m256i *)out, Xor(Xor(v0, v1), Xor(v2, v3)));
+    }
+
+} // namespace
+
+void SipHashUint256_4way(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                         uint64_t *out) {
+    Hash(k0, k1, vals, nullptr, out);
+}
+
+void SipHashUint256Extra_4way(uint64_t k0, uint64_t k1,
+                              const uint256 *const *vals,
+                              const uint32_t *extras, uint64_t *out) {
+    Hash(k0, k1, vals, extras, out);
+}
+
+} // namespace siphash_avx2
+
+#endif
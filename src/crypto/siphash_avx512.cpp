@@ -0,0 +1,126 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX512
+
+#include <uint256.h>
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace siphash_avx512 {
+namespace {
+
+    __m512i inline K(uint64_t x) { return _mm512_set1_epi64(x); }
+
+    __m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi64(x, y); }
+    __m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+
+    /** The rotations are a single instruction. */
+    template <int b> __m512i inline Rotl(__m512i x) {
+        return _mm512_rol_epi64(x, b);
+    }
+
+    void inline SipRound(__m512i &v0, __m512i &v1, __m512i &v2, __m512i &v3) {
+        v0 = Add(v0, v1);
+        v1 = Rotl<13>(v1);
+        v1 = Xor(v1, v0);
+        v0 = Rotl<32>(v0);
+        v2 = Add(v2, v3);
+        v3 = Rotl<16>(v3);
+        v3 = Xor(v3, v2);
+        v0 = Add(v0, v3);
+        v3 = Rotl<21>(v3);
+        v3 = Xor(v3, v0);
+        v2 = Add(v2, v1);
+        v1 = Rotl<17>(v1);
+        v1 = Xor(v1, v2);
+        v2 = Rotl<32>(v2);
+    }
+
+    void inline Compress(__m512i &v0, __m512i &v1, __m512i &v2, __m512i &v3,
+                         __m512i d) {
+        v3 = Xor(v3, d);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        v0 = Xor(v0, d);
+    }
+
+    __m256i inline Load(const uint256 *val) {
+        return _mm256_loadu_si256((const __m256i *)val->begin());
+    }
+
+    /**
+     * Transpose 4 values so that each of w[0..3] holds the same 64-bit word of
+     * all of them.
+     */
+    void inline Transpose4(const uint256 *const *vals, __m256i *w) {
+        __m256i r0 = Load(vals[0]);
+        __m256i r1 = Load(vals[1]);
+        __m256i r2 = Load(vals[2]);
+        __m256i r3 = Load(vals[3]);
+        __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+        __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+        __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+        __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+        w[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+        w[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+        w[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+        w[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+    }
+
+    /**
+     * Hash the 8 values, followed by the 8 extra words if any. The final word
+     * holds the message length in its top byte.
+     */
+    void inline Hash(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                     const uint32_t *extras, uint64_t *out) {
+        __m512i v0 = K(0x736f6d6570736575ULL ^ k0);
+        __m512i v1 = K(0x646f72616e646f6dULL ^ k1);
+        __m512i v2 = K(0x6c7967656e657261ULL ^ k0);
+        __m512i v3 = K(0x7465646279746573ULL ^ k1);
+
+        // Each half of the registers holds the words of 4 of the values.
+        __m256i lo[4], hi[4];
+        Transpose4(vals, lo);
+        Transpose4(vals + 4, hi);
+        for (int i = 0; i < 4; ++i) {
+            Compress(v0, v1, v2, v3,
+                     _mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i],
+                                        1));
+        }
+        if (extras) {
+            Compress(v0, v1, v2, v3,
+                     _mm512_or_si512(K(uint64_t(36) << 56),
+                                     _mm512_cvtepu32_epi64(_mm256_loadu_si256(
+                                         (const __m256i *)extras))));
+        } else {
+            Compress(v0, v1, v2, v3, K(uint64_t(4) << 59));
+        }
+
+        v2 = Xor(v2, K(0xFF));
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+
+        _mm512_storeu_si512(out, Xor(Xor(v0, v1), Xor(v2, v3)));
+    }
+
+} // namespace
+
+void SipHashUint256_8way(uint64_t k0, uint64_t k1, const uint256 *const *vals,
+                         uint64_t *out) {
+    Hash(k0, k1, vals, nullptr, out);
+}
+
+void SipHashUint256Extra_8way(uint64_t k0, uint64_t k1,
+                              const uint256 *const *vals,
+                              const uint32_t *extras, uint64_t *out) {
+    Hash(k0, k1, vals, extras, out);
+}
+
+} // namespace siphash_avx512
+
+#endif
@@ -205,6 +205,15 @@ private:
      */
     uint8_t depth_limit;
 
+    /**
+     * eviction_count counts the elements evicted without having been erased
+     * by a lookup: the ones aged out by an epoch change (they can still be
+     * found until their slot is reused), and the ones dropped by insert for
+     * lack of space. It is atomic so it can be read without holding the lock
+     * the writers hold.
+     */
+    std::atomic<uint64_t> eviction_count;
+
     /**
      * hash_function is a const instance of the hash function. It cannot be
      * static or initialized at call time as it may have internal state (such as
@@ -335,13 +344,16 @@ private:
         // false) and move all elements in the current epoch to the old epoch
         // but do not call allow_erase on their indices.
         if (epoch_unused_count >= epoch_size) {
+            uint64_t aged_count = 0;
             for (uint32_t i = 0; i < size; ++i) {
                 if (epoch_flags[i]) {
                     epoch_flags[i] = false;
                 } else {
+                    aged_count += !collection_flags.bit_is_set(i);
                     allow_erase(i);
                 }
             }
+            eviction_count.fetch_add(aged_count, std::memory_order_relaxed);
             epoch_heuristic_counter = epoch_size;
         } else {
             // reset the epoch_heuristic_counter to next do a scan when worst
@@ -363,7 +375,7 @@ public:
     cache()
         : table(), size(), collection_flags(0), epoch_flags(),
           epoch_heuristic_counter(), epoch_size(), depth_limit(0),
-          hash_function() {}
+          eviction_count(0), hash_function() {}
 
     /**
      * setup initializes the container to store no more than new_size
@@ -487,6 +499,18 @@ public:
             // Recompute the locs -- unfortunately happens one too many times!
             locs = compute_hashes(e.getKey());
         }
+
+        // The last element swapped out is dropped.
+        eviction_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * evictions returns the number of elements evicted without having been
+     * erased by a lookup, either because they aged out or because insert ran
+     * out of space. Threadsafe.
+     */
+    uint64_t evictions() const {
+        return eviction_count.load(std::memory_order_relaxed);
     }
 
     /**
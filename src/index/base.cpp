@@ -12,17 +12,40 @@
 #include <shutdown.h>
 #include <tinyformat.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <validation.h> // For CChainState
 #include <warnings.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <thread>
 
 constexpr char DB_BEST_BLOCK = 'B';
 
 constexpr int64_t SYNC_LOG_INTERVAL = 30;           // secon
 constexpr int64_t SYNC_LOCATOR_WRITE_INTERVAL = 30; // seconds
 
+/** Number of upcoming blocks an index reads and prepares ahead of time. */
+constexpr size_t SYNC_READAHEAD_BLOCKS = 16;
+/**
+ * An index that is catching up waits for the other indexes that are more than
+ * SYNC_LOCKSTEP_SLACK but at most SYNC_LOCKSTEP_DISTANCE blocks behind it, so
+ * they keep sharing the blocks read from disk. Indexes that are further apart
+ * sync independently.
+ */
+constexpr int SYNC_LOCKSTEP_SLACK = 16;
+constexpr int SYNC_LOCKSTEP_DISTANCE = 1000;
+/** Number of recently read blocks kept around for the other indexes. */
+constexpr size_t SYNC_BLOCK_CACHE_SIZE =
+    2 * SYNC_READAHEAD_BLOCKS + SYNC_LOCKSTEP_SLACK;
+constexpr int MAX_SYNC_WORKERS = 8;
+
 template <typename... Args>
 static void FatalError(const char *fmt, const Args &...args) {
     std::string strMessage = tfm::format(fmt, args...);
@@ -32,6 +55,219 @@ static void FatalError(const char *fmt, const Args &...args) {
     StartShutdown();
 }
 
+namespace {
+
+using SharedBlockFuture = std::shared_future<std::shared_ptr<const CBlock>>;
+
+/**
+ * Worker threads shared by all the indexes that are catching up with the
+ * chain. They read blocks from disk ahead of the sync threads and run the
+ * order-independent PrepareBlock step of the indexes. A block requested by
+ * several indexes is only read once.
+ */
+class SyncWorkers {
+private:
+    Mutex m_mutex;
+    std::condition_variable m_worker_cv;
+    std::condition_variable m_lockstep_cv;
+    std::deque<std::function<void()>> m_tasks GUARDED_BY(m_mutex);
+    bool m_request_stop GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_worker_threads;
+
+    /** Recently requested blocks, the most recent first. */
+    std::list<std::pair<const CBlockIndex *, SharedBlockFuture>>
+        m_blocks GUARDED_BY(m_mutex);
+
+    /** Height each index that is catching up is currently processing. */
+    std::map<const BaseIndex *, int> m_sync_heights GUARDED_BY(m_mutex);
+
+    void Loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                while (m_tasks.empty() && !m_request_stop) {
+                    m_worker_cv.wait(lock);
+                }
+                if (m_request_stop) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    void Enqueue(std::function<void()> task) EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        // Tasks are run in FIFO order. A task waiting for a block is always
+        // queued after the task that reads it, so it cannot deadlock.
+        m_tasks.push_back(std::move(task));
+        m_worker_cv.notify_one();
+    }
+
+public:
+    explicit SyncWorkers(int n_threads) {
+        for (int i = 0; i < n_threads; ++i) {
+            m_worker_threads.emplace_back([this, i]() {
+                util::ThreadRename(strprintf("idxsync.%i", i));
+                Loop();
+            });
+        }
+    }
+
+    ~SyncWorkers() {
+        {
+            LOCK(m_mutex);
+            m_request_stop = true;
+        }
+        m_worker_cv.notify_all();
+        for (std::thread &t : m_worker_threads) {
+            t.join();
+        }
+    }
+
+    /**
+     * Read a block from disk in the background. The result is null if the
+     * block could not be read.
+     */
+    SharedBlockFuture ReadBlock(const CBlockIndex *pindex,
+                                const Consensus::Params &params)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) {
+        LOCK(m_mutex);
+        auto it = std::find_if(m_blocks.begin(), m_blocks.end(),
+                               [pindex](const auto &entry) {
+                                   return entry.first == pindex;
+                               });
+        if (it != m_blocks.end()) {
+            m_blocks.splice(m_blocks.begin(), m_blocks, it);
+            return it->second;
+        }
+
+        auto promise =
+            std::make_shared<std::promise<std::shared_ptr<const CBlock>>>();
+        SharedBlockFuture future = promise->get_future().share();
+        Enqueue([pindex, &params, promise]() {
+            auto block = std::make_shared<CBlock>();
+            if (!ReadBlockFromDisk(*block, pindex, params)) {
+                block.reset();
+            }
+            promise->set_value(std::move(block));
+        });
+
+        m_blocks.emplace_front(pindex, future);
+        if (m_blocks.size() > SYNC_BLOCK_CACHE_SIZE) {
+            m_blocks.pop_back();
+        }
+        return future;
+    }
+
+    /** Run a task in the background. */
+    std::future<bool> Submit(std::function<bool()> func)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) {
+        auto task =
+            std::make_shared<std::packaged_task<bool()>>(std::move(func));
+        std::future<bool> future = task->get_future();
+        LOCK(m_mutex);
+        Enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    /**
+     * Record that the index is about to process the block at the given height
+     * and wait for the other indexes that are close behind it, see
+     * SYNC_LOCKSTEP_DISTANCE.
+     */
+    void WaitForLaggards(const BaseIndex *index, int height,
+                         const CThreadInterrupt &interrupt)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) {
+        WAIT_LOCK(m_mutex, lock);
+        m_sync_heights[index] = height;
+        m_lockstep_cv.notify_all();
+
+        auto has_laggard = [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+            return std::any_of(m_sync_heights.begin(), m_sync_heights.end(),
+                               [&](const auto &entry) {
+                                   const int distance = height - entry.second;
+                                   return distance > SYNC_LOCKSTEP_SLACK &&
+                                          distance <= SYNC_LOCKSTEP_DISTANCE;
+                               });
+        };
+        while (!interrupt && has_laggard()) {
+            m_lockstep_cv.wait_for(lock, std::chrono::milliseconds{100});
+        }
+    }
+
+    /** Record that the index is no longer catching up. */
+    void Release(const BaseIndex *index) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) {
+        LOCK(m_mutex);
+        m_sync_heights.erase(index);
+        m_lockstep_cv.notify_all();
+    }
+};
+
+Mutex g_sync_workers_mutex;
+std::weak_ptr<SyncWorkers> g_sync_workers GUARDED_BY(g_sync_workers_mutex);
+
+/**
+ * Get the sync workers, starting them if no index is currently using them.
+ * They are stopped once the last sync thread releases them.
+ */
+std::shared_ptr<SyncWorkers> AcquireSyncWorkers() {
+    LOCK(g_sync_workers_mutex);
+    std::shared_ptr<SyncWorkers> workers = g_sync_workers.lock();
+    if (!workers) {
+        workers = std::make_shared<SyncWorkers>(
+            std::clamp(GetNumCores(), 2, MAX_SYNC_WORKERS));
+        g_sync_workers = workers;
+    }
+    return workers;
+}
+
+/** A block scheduled to be read and prepared ahead of time. */
+struct PendingBlock {
+    const CBlockIndex *pindex;
+    SharedBlockFuture block;
+    std::future<bool> prepared;
+};
+
+/**
+ * The blocks an index has scheduled ahead of the one it is processing. On
+ * destruction, it waits for the background work to complete since it may
+ * still reference the index.
+ */
+class ReadAhead {
+private:
+    std::deque<PendingBlock> m_pending;
+
+public:
+    ~ReadAhead() { Clear(); }
+
+    bool empty() const { return m_pending.empty(); }
+    size_t size() const { return m_pending.size(); }
+    const CBlockIndex *front() const { return m_pending.front().pindex; }
+    const CBlockIndex *back() const { return m_pending.back().pindex; }
+
+    void push_back(PendingBlock &&pending) {
+        m_pending.push_back(std::move(pending));
+    }
+
+    PendingBlock pop_front() {
+        PendingBlock pending = std::move(m_pending.front());
+        m_pending.pop_front();
+        return pending;
+    }
+
+    void Clear() {
+        for (PendingBlock &pending : m_pending) {
+            pending.prepared.wait();
+        }
+        m_pending.clear();
+    }
+};
+
+} // namespace
+
 BaseIndex::DB::DB(const fs::path &path, size_t n_cache_size, bool f_memory,
                   bool f_wipe, bool f_obfuscate)
     : CDBWrapper(path, n_cache_size, f_memory, f_wipe, f_obfuscate) {}
@@ -138,11 +374,21 @@ void BaseIndex::ThreadSync() {
     const CBlockIndex *pindex = m_best_block_index.load();
     if (!m_synced) {
         auto &consensus_params = GetConfig().GetChainParams().GetConsensus();
+        std::shared_ptr<SyncWorkers> workers = AcquireSyncWorkers();
+        ReadAhead read_ahead;
+
+        auto release_workers = [&]() {
+            // Wait for the background work before releasing the workers, as it
+            // may still reference this index.
+            read_ahead.Clear();
+            workers->Release(this);
+        };
 
         int64_t last_log_time = 0;
         int64_t last_locator_write_time = 0;
         while (true) {
             if (m_interrupt) {
+                release_workers();
                 m_best_block_index = pindex;
                 // No need to handle errors in Commit. If it fails, the error
                 // will be already be logged. The best way to recover is to
@@ -154,9 +400,11 @@ void BaseIndex::ThreadSync() {
 
             {
                 LOCK(cs_main);
+                CChain &active_chain = m_chainstate->m_chain;
                 const CBlockIndex *pindex_next =
-                    NextSyncBlock(pindex, m_chainstate->m_chain);
+                    NextSyncBlock(pindex, active_chain);
                 if (!pindex_next) {
+                    release_workers();
                     m_best_block_index = pindex;
                     m_synced = true;
                     // No need to handle errors in Commit. See rationale above.
@@ -165,12 +413,38 @@ void BaseIndex::ThreadSync() {
                 }
                 if (pindex_next->pprev != pindex &&
                     !Rewind(pindex, pindex_next->pprev)) {
+                    release_workers();
                     FatalError(
                         "%s: Failed to rewind index %s to a previous chain tip",
                         __func__, GetName());
                     return;
                 }
                 pindex = pindex_next;
+
+                // The blocks scheduled so far are only usable if they are
+                // still the next ones on the active chain.
+                if (!read_ahead.empty() &&
+                    (read_ahead.front() != pindex ||
+                     !active_chain.Contains(read_ahead.back()))) {
+                    read_ahead.Clear();
+                }
+                while (read_ahead.size() < SYNC_READAHEAD_BLOCKS) {
+                    const CBlockIndex *pindex_ahead =
+                        read_ahead.empty() ? pindex
+                                           : active_chain.Next(read_ahead.back());
+                    if (!pindex_ahead) {
+                        break;
+                    }
+                    SharedBlockFuture block =
+                        workers->ReadBlock(pindex_ahead, consensus_params);
+                    std::future<bool> prepared =
+                        workers->Submit([this, pindex_ahead, block]() {
+                            std::shared_ptr<const CBlock> pblock = block.get();
+                            return pblock && PrepareBlock(*pblock, pindex_ahead);
+                        });
+                    read_ahead.push_back(
+                        {pindex_ahead, std::move(block), std::move(prepared)});
+                }
             }
 
             int64_t current_time = GetTime();
@@ -188,13 +462,18 @@ void BaseIndex::ThreadSync() {
                 Commit();
             }
 
-            CBlock block;
-            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+            workers->WaitForLaggards(this, pindex->nHeight, m_interrupt);
+
+            PendingBlock pending = read_ahead.pop_front();
+            std::shared_ptr<const CBlock> block = pending.block.get();
+            if (!block) {
+                release_workers();
                 FatalError("%s: Failed to read block %s from disk", __func__,
                            pindex->GetBlockHash().ToString());
                 return;
             }
-            if (!WriteBlock(block, pindex)) {
+            if (!pending.prepared.get() || !WriteBlock(*block, pindex)) {
+                release_workers();
                 FatalError("%s: Failed to write block %s to index database",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
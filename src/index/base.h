@@ -63,6 +63,9 @@ private:
     /// interrupted with m_interrupt. Once the index gets in sync, the m_synced
     /// flag is set and the BlockConnected ValidationInterface callback takes
     /// over and the sync thread exits.
+    /// Blocks are read from disk ahead of time by a pool of workers shared
+    /// with the other indexes that are catching up, so that a block needed by
+    /// several indexes is only read once.
     void ThreadSync();
 
     /// Write the current index state (eg. chain block locator and
@@ -90,6 +93,15 @@ protected:
     /// Initialize internal state from the database and block index.
     virtual bool Init();
 
+    /// Do the part of indexing a block that does not depend on the blocks
+    /// before it. While the index is catching up, this is run ahead of time on
+    /// the shared sync workers, concurrently for several upcoming blocks. The
+    /// WriteBlock call for the same block happens later, in chain order, and
+    /// may never happen if the chain is reorganized in the meantime.
+    virtual bool PrepareBlock(const CBlock &block, const CBlockIndex *pindex) {
+        return true;
+    }
+
     /// Write update index entries for a newly connected block.
     virtual bool WriteBlock(const CBlock &block, const CBlockIndex *pindex) {
         return true;
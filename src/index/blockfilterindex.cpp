@@ -8,7 +8,9 @@
 #include <primitives/blockhash.h>
 #include <util/system.h>
 
+#include <algorithm>
 #include <map>
+#include <optional>
 
 /**
  * The index database stores three items for each block: the disk location of
@@ -48,6 +50,13 @@ constexpr unsigned int FLTR_FILE_CHUNK_SIZE = 0x100000;
  */
 constexpr size_t CF_HEADERS_CACHE_MAX_SZ{2000};
 
+/**
+ * Maximum total size of the encoded filters kept in memory. Basic filters are
+ * a few kB for typical blocks, so this holds well over the 1000 filters of a
+ * full getcfilters response.
+ */
+constexpr size_t FILTER_CACHE_MAX_BYTES{32 << 20};
+
 namespace {
 
 struct DBVal {
@@ -177,6 +186,48 @@ bool BlockFilterIndex::ReadFilterFromDisk(const FlatFilePos &pos,
     return true;
 }
 
+bool BlockFilterIndex::ReadFiltersFromDisk(
+    const std::vector<FlatFilePos> &positions,
+    std::vector<BlockFilter> &filters) const {
+    filters.resize(positions.size());
+
+    std::optional<CAutoFile> filein;
+    FlatFilePos next_pos;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const FlatFilePos &pos = positions[i];
+        if (!filein || pos != next_pos) {
+            filein.emplace(m_filter_fileseq->Open(pos, true), SER_DISK,
+                           CLIENT_VERSION);
+            if (filein->IsNull()) {
+                return false;
+            }
+        }
+
+        BlockHash block_hash;
+        std::vector<uint8_t> encoded_filter;
+        try {
+            *filein >> block_hash >> encoded_filter;
+        } catch (const std::exception &e) {
+            return error("%s: Failed to deserialize block filter from disk: %s",
+                         __func__, e.what());
+        }
+
+        next_pos = pos;
+        next_pos.nPos += GetSerializeSize(block_hash, CLIENT_VERSION) +
+                         GetSerializeSize(encoded_filter, CLIENT_VERSION);
+
+        try {
+            filters[i] = BlockFilter(GetFilterType(), block_hash,
+                                     std::move(encoded_filter));
+        } catch (const std::exception &e) {
+            return error("%s: Failed to deserialize block filter from disk: %s",
+                         __func__, e.what());
+        }
+    }
+
+    return true;
+}
+
 size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos &pos,
                                            const BlockFilter &filter) {
     assert(filter.GetFilterType() == GetFilterType());
@@ -228,16 +279,35 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos &pos,
     return data_size;
 }
 
+bool BlockFilterIndex::ComputeFilter(const CBlock &block,
+                                     const CBlockIndex *pindex,
+                                     BlockFilter &filter) const {
+    CBlockUndo block_undo;
+    if (pindex->nHeight > 0 && !UndoReadFromDisk(block_undo, pindex)) {
+        return false;
+    }
+
+    filter = BlockFilter(m_filter_type, block, block_undo);
+    return true;
+}
+
+bool BlockFilterIndex::PrepareBlock(const CBlock &block,
+                                    const CBlockIndex *pindex) {
+    BlockFilter filter;
+    if (!ComputeFilter(block, pindex, filter)) {
+        return false;
+    }
+
+    LOCK(m_cs_prepared_filters);
+    m_prepared_filters.insert_or_assign(pindex->nHeight, std::move(filter));
+    return true;
+}
+
 bool BlockFilterIndex::WriteBlock(const CBlock &block,
                                   const CBlockIndex *pindex) {
-    CBlockUndo block_undo;
     uint256 prev_header;
 
     if (pindex->nHeight > 0) {
-        if (!UndoReadFromDisk(block_undo, pindex)) {
-            return false;
-        }
-
         std::pair<BlockHash, DBVal> read_out;
         if (!m_db->Read(DBHeightKey(pindex->nHeight - 1), read_out)) {
             return false;
@@ -254,7 +324,25 @@ bool BlockFilterIndex::WriteBlock(const CBlock &block,
         prev_header = read_out.second.header;
     }
 
-    BlockFilter filter(m_filter_type, block, block_undo);
+    BlockFilter filter;
+    bool prepared = false;
+    {
+        LOCK(m_cs_prepared_filters);
+        auto it = m_prepared_filters.find(pindex->nHeight);
+        if (it != m_prepared_filters.end() &&
+            it->second.GetBlockHash() == pindex->GetBlockHash()) {
+            filter = std::move(it->second);
+            prepared = true;
+        }
+        // Blocks are written in chain order, so anything prepared up to this
+        // height is either this block or was reorganized away.
+        m_prepared_filters.erase(
+            m_prepared_filters.begin(),
+            m_prepared_filters.upper_bound(pindex->nHeight));
+    }
+    if (!prepared && !ComputeFilter(block, pindex, filter)) {
+        return false;
+    }
 
     size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
     if (bytes_written == 0) {
@@ -272,6 +360,9 @@ bool BlockFilterIndex::WriteBlock(const CBlock &block,
     }
 
     m_next_filter_pos.nPos += bytes_written;
+
+    // The most recent filters are the ones light clients ask for.
+    AddToFilterCache(value.second.header, std::move(filter));
     return true;
 }
 
@@ -346,9 +437,7 @@ static bool LookupOne(const CDBWrapper &db, const CBlockIndex *block_index,
     return db.Read(DBHashKey(block_index->GetBlockHash()), result);
 }
 
-static bool LookupRange(CDBWrapper &db, const std::string &index_name,
-                        int start_height, const CBlockIndex *stop_index,
-                        std::vector<DBVal> &results) {
+static bool CheckRange(int start_height, const CBlockIndex *stop_index) {
     if (start_height < 0) {
         return error("%s: start height (%d) is negative", __func__,
                      start_height);
@@ -357,6 +446,15 @@ static bool LookupRange(CDBWrapper &db, const std::string &index_name,
         return error("%s: start height (%d) is greater than stop height (%d)",
                      __func__, start_height, stop_index->nHeight);
     }
+    return true;
+}
+
+static bool LookupRange(CDBWrapper &db, const std::string &index_name,
+                        int start_height, const CBlockIndex *stop_index,
+                        std::vector<DBVal> &results) {
+    if (!CheckRange(start_height, stop_index)) {
+        return false;
+    }
 
     size_t results_size =
         static_cast<size_t>(stop_index->nHeight - start_height + 1);
@@ -405,18 +503,79 @@ static bool LookupRange(CDBWrapper &db, const std::string &index_name,
     return true;
 }
 
+const BlockFilterIndex::CachedFilter *
+BlockFilterIndex::LookupFilterCache(const BlockHash &block_hash) const {
+    auto it = m_filter_cache_index.find(block_hash);
+    if (it == m_filter_cache_index.end()) {
+        return nullptr;
+    }
+
+    // Move the entry to the front of the list, it is the most recently used.
+    m_filter_cache.splice(m_filter_cache.begin(), m_filter_cache, it->second);
+    return &it->second->second;
+}
+
+void BlockFilterIndex::AddToFilterCache(const uint256 &header,
+                                        BlockFilter filter) const {
+    const BlockHash block_hash = filter.GetBlockHash();
+    const size_t filter_bytes = filter.GetEncodedFilter().size();
+    if (filter_bytes > FILTER_CACHE_MAX_BYTES) {
+        return;
+    }
+
+    LOCK(m_cs_filter_cache);
+    if (LookupFilterCache(block_hash)) {
+        return;
+    }
+
+    m_filter_cache.emplace_front(block_hash,
+                                 CachedFilter{header, std::move(filter)});
+    m_filter_cache_index.emplace(block_hash, m_filter_cache.begin());
+    m_filter_cache_bytes += filter_bytes;
+
+    while (m_filter_cache_bytes > FILTER_CACHE_MAX_BYTES) {
+        const auto &oldest = m_filter_cache.back();
+        m_filter_cache_bytes -= oldest.second.filter.GetEncodedFilter().size();
+        m_filter_cache_index.erase(oldest.first);
+        m_filter_cache.pop_back();
+    }
+}
+
 bool BlockFilterIndex::LookupFilter(const CBlockIndex *block_index,
                                     BlockFilter &filter_out) const {
+    {
+        LOCK(m_cs_filter_cache);
+        if (const CachedFilter *cached =
+                LookupFilterCache(block_index->GetBlockHash())) {
+            filter_out = cached->filter;
+            return true;
+        }
+    }
+
     DBVal entry;
     if (!LookupOne(*m_db, block_index, entry)) {
         return false;
     }
 
-    return ReadFilterFromDisk(entry.pos, filter_out);
+    if (!ReadFilterFromDisk(entry.pos, filter_out)) {
+        return false;
+    }
+
+    AddToFilterCache(entry.header, filter_out);
+    return true;
 }
 
 bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex *block_index,
                                           uint256 &header_out) {
+    {
+        LOCK(m_cs_filter_cache);
+        if (const CachedFilter *cached =
+                LookupFilterCache(block_index->GetBlockHash())) {
+            header_out = cached->header;
+            return true;
+        }
+    }
+
     LOCK(m_cs_headers_cache);
 
     bool is_checkpoint{block_index->nHeight % CFCHECKPT_INTERVAL == 0};
@@ -448,18 +607,55 @@ bool BlockFilterIndex::LookupFilterHeader(const CBlockIndex *block_index,
 bool BlockFilterIndex::LookupFilterRange(
     int start_height, const CBlockIndex *stop_index,
     std::vector<BlockFilter> &filters_out) const {
+    if (!CheckRange(start_height, stop_index)) {
+        return false;
+    }
+
+    filters_out.resize(stop_index->nHeight - start_height + 1);
+
+    // Serve what we can from the cache and only go to disk for the rest.
+    std::vector<size_t> missing;
+    {
+        LOCK(m_cs_filter_cache);
+        for (const CBlockIndex *block_index = stop_index;
+             block_index && block_index->nHeight >= start_height;
+             block_index = block_index->pprev) {
+            size_t i = static_cast<size_t>(block_index->nHeight - start_height);
+            if (const CachedFilter *cached =
+                    LookupFilterCache(block_index->GetBlockHash())) {
+                filters_out[i] = cached->filter;
+            } else {
+                missing.push_back(i);
+            }
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+
     std::vector<DBVal> entries;
     if (!LookupRange(*m_db, m_name, start_height, stop_index, entries)) {
         return false;
     }
 
-    filters_out.resize(entries.size());
-    auto filter_pos_it = filters_out.begin();
-    for (const auto &entry : entries) {
-        if (!ReadFilterFromDisk(entry.pos, *filter_pos_it)) {
-            return false;
-        }
-        ++filter_pos_it;
+    // The missing filters were collected backwards, read them in chain order
+    // so consecutive filters are read sequentially from the same file.
+    std::reverse(missing.begin(), missing.end());
+    std::vector<FlatFilePos> positions;
+    positions.reserve(missing.size());
+    for (size_t i : missing) {
+        positions.push_back(entries[i].pos);
+    }
+
+    std::vector<BlockFilter> filters;
+    if (!ReadFiltersFromDisk(positions, filters)) {
+        return false;
+    }
+
+    for (size_t j = 0; j < missing.size(); ++j) {
+        const size_t i = missing[j];
+        AddToFilterCache(entries[i].header, filters[j]);
+        filters_out[i] = std::move(filters[j]);
     }
 
     return true;
@@ -10,6 +10,10 @@
 #include <flatfile.h>
 #include <index/base.h>
 
+#include <list>
+#include <map>
+#include <unordered_map>
+
 /** Interval between compact filter checkpoints. See BIP 157. */
 static constexpr int CFCHECKPT_INTERVAL = 1000;
 
@@ -37,6 +41,12 @@ private:
     std::unique_ptr<FlatFileSeq> m_filter_fileseq;
 
     bool ReadFilterFromDisk(const FlatFilePos &pos, BlockFilter &filter) const;
+    /**
+     * Read several filters, reusing the open file while they are stored next
+     * to each other, as is the case for consecutive blocks.
+     */
+    bool ReadFiltersFromDisk(const std::vector<FlatFilePos> &positions,
+                             std::vector<BlockFilter> &filters) const;
     size_t WriteFilterToDisk(FlatFilePos &pos, const BlockFilter &filter);
 
     Mutex m_cs_headers_cache;
@@ -47,11 +57,47 @@ private:
     std::unordered_map<BlockHash, uint256, FilterHeaderHasher>
         m_headers_cache GUARDED_BY(m_cs_headers_cache);
 
+    struct CachedFilter {
+        uint256 header;
+        BlockFilter filter;
+    };
+
+    mutable Mutex m_cs_filter_cache;
+    /**
+     * Recently written or served filters along with their header, the most
+     * recently used first. Light clients mostly request the same recent
+     * ranges, so this avoids reading and decoding them from disk every time.
+     */
+    mutable std::list<std::pair<BlockHash, CachedFilter>>
+        m_filter_cache GUARDED_BY(m_cs_filter_cache);
+    mutable std::unordered_map<
+        BlockHash, std::list<std::pair<BlockHash, CachedFilter>>::iterator,
+        FilterHeaderHasher>
+        m_filter_cache_index GUARDED_BY(m_cs_filter_cache);
+    /** Total size of the encoded filters in m_filter_cache. */
+    mutable size_t m_filter_cache_bytes GUARDED_BY(m_cs_filter_cache){0};
+
+    const CachedFilter *LookupFilterCache(const BlockHash &block_hash) const
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_filter_cache);
+    void AddToFilterCache(const uint256 &header, BlockFilter filter) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_filter_cache);
+
+    Mutex m_cs_prepared_filters;
+    /** Filters computed ahead of time by PrepareBlock, by block height. */
+    std::map<int, BlockFilter>
+        m_prepared_filters GUARDED_BY(m_cs_prepared_filters);
+
+    bool ComputeFilter(const CBlock &block, const CBlockIndex *pindex,
+                       BlockFilter &filter) const;
+
 protected:
     bool Init() override;
 
     bool CommitInternal(CDBBatch &batch) override;
 
+    /** Filters do not depend on other blocks, only their headers do. */
+    bool PrepareBlock(const CBlock &block, const CBlockIndex *pindex) override;
+
     bool WriteBlock(const CBlock &block, const CBlockIndex *pindex) override;
 
     bool Rewind(const CBlockIndex *current_tip,
@@ -11,17 +11,54 @@
 #include <node/blockstorage.h>
 #include <primitives/blockhash.h>
 #include <serialize.h>
+#include <span.h>
+#include <streams.h>
 #include <txdb.h>
 #include <undo.h>
 #include <util/check.h>
 #include <validation.h>
 
+#include <vector>
+
 static constexpr char DB_BLOCK_HASH = 's';
 static constexpr char DB_BLOCK_HEIGHT = 't';
 static constexpr char DB_MUHASH = 'M';
 
 namespace {
 
+/**
+ * Collects the outputs a block adds to and removes from the UTXO set, so they
+ * are applied to the MuHash in one batch each.
+ */
+class MuHashBatch {
+    std::vector<CDataStream> m_inserted;
+    std::vector<CDataStream> m_removed;
+
+    static std::vector<Span<const uint8_t>>
+    ToSpans(const std::vector<CDataStream> &outputs) {
+        std::vector<Span<const uint8_t>> spans;
+        spans.reserve(outputs.size());
+        for (const CDataStream &ss : outputs) {
+            spans.push_back(MakeUCharSpan(ss));
+        }
+        return spans;
+    }
+
+public:
+    void Insert(const COutPoint &outpoint, const Coin &coin) {
+        m_inserted.push_back(TxOutSer(outpoint, coin));
+    }
+
+    void Remove(const COutPoint &outpoint, const Coin &coin) {
+        m_removed.push_back(TxOutSer(outpoint, coin));
+    }
+
+    void Apply(MuHash3072 &muhash) const {
+        muhash.InsertBatch(ToSpans(m_inserted))
+            .RemoveBatch(ToSpans(m_removed));
+    }
+};
+
 struct DBVal {
     uint256 muhash;
     uint64_t transaction_output_count;
@@ -143,6 +180,8 @@ bool CoinStatsIndex::WriteBlock(const CBlock &block,
                  BlockHash{uint256S("0x00000000000af0aed4792b1acee3d966af36cf5d"
                                     "ef14935db8de83d6f9306f2f")})};
 
+        MuHashBatch muhash_batch;
+
         // Add the new utxos created from the block
         for (size_t i = 0; i < block.vtx.size(); ++i) {
             const auto &tx{block.vtx.at(i)};
@@ -167,7 +206,7 @@ bool CoinStatsIndex::WriteBlock(const CBlock &block,
                     continue;
                 }
 
-                m_muhash.Insert(MakeUCharSpan(TxOutSer(outpoint, coin)));
+                muhash_batch.Insert(outpoint, coin);
 
                 if (tx->IsCoinBase()) {
                     m_total_coinbase_amount += coin.GetTxOut().nValue;
@@ -190,7 +229,7 @@ bool CoinStatsIndex::WriteBlock(const CBlock &block,
                     COutPoint outpoint{tx->vin[j].prevout.GetTxId(),
                                        tx->vin[j].prevout.GetN()};
 
-                    m_muhash.Remove(MakeUCharSpan(TxOutSer(outpoint, coin)));
+                    muhash_batch.Remove(outpoint, coin);
 
                     m_total_prevout_spent_amount += coin.GetTxOut().nValue;
 
@@ -200,6 +239,8 @@ bool CoinStatsIndex::WriteBlock(const CBlock &block,
                 }
             }
         }
+
+        muhash_batch.Apply(m_muhash);
     } else {
         // genesis block
         m_total_unspendable_amount += block_subsidy;
@@ -433,6 +474,8 @@ bool CoinStatsIndex::ReverseBlock(const CBlock &block,
         }
     }
 
+    MuHashBatch muhash_batch;
+
     // Remove the new UTXOs that were created from the block
     for (size_t i = 0; i < block.vtx.size(); ++i) {
         const auto &tx{block.vtx.at(i)};
@@ -450,7 +493,7 @@ bool CoinStatsIndex::ReverseBlock(const CBlock &block,
                 continue;
             }
 
-            m_muhash.Remove(MakeUCharSpan(TxOutSer(outpoint, coin)));
+            muhash_batch.Remove(outpoint, coin);
 
             if (tx->IsCoinBase()) {
                 m_total_coinbase_amount -= coin.GetTxOut().nValue;
@@ -473,7 +516,7 @@ bool CoinStatsIndex::ReverseBlock(const CBlock &block,
                 COutPoint outpoint{tx->vin[j].prevout.GetTxId(),
                                    tx->vin[j].prevout.GetN()};
 
-                m_muhash.Insert(MakeUCharSpan(TxOutSer(outpoint, coin)));
+                muhash_batch.Insert(outpoint, coin);
 
                 m_total_prevout_spent_amount -= coin.GetTxOut().nValue;
 
@@ -484,6 +527,8 @@ bool CoinStatsIndex::ReverseBlock(const CBlock &block,
         }
     }
 
+    muhash_batch.Apply(m_muhash);
+
     const Amount unclaimed_rewards{
         (m_total_new_outputs_ex_coinbase_amount + m_total_coinbase_amount +
          m_total_unspendable_amount) -
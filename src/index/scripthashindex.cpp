@@ -0,0 +1,360 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scripthashindex.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/system.h>
+
+#include <algorithm>
+#include <tuple>
+
+/**
+ * The index database stores two kinds of entries.
+ *
+ * The history of each script is made of postings keyed by
+ * [DB_SCRIPT_HISTORY, script hash, height (BE), tx position (BE)], whose value
+ * lists the outputs of the transaction funding the script and the inputs
+ * spending from it. The height and position are big-endian so that the
+ * history of a script is a contiguous range of keys sorted in chain order.
+ *
+ * The txid of every indexed transaction is stored once under
+ * [DB_TXID, height (BE), tx position (BE)], so that the postings do not need
+ * to repeat it for each script the transaction touches.
+ */
+constexpr uint8_t DB_SCRIPT_HISTORY{'h'};
+constexpr uint8_t DB_TXID{'t'};
+
+/**
+ * How far the txid iterator is stepped forward before falling back to a seek
+ * when resolving the txids of a page of history.
+ */
+static constexpr int MAX_TXID_ITERATOR_STEPS{16};
+
+std::unique_ptr<ScriptHashIndex> g_script_hash_index;
+
+namespace {
+
+struct DBHistoryKey {
+    uint256 script_hash;
+    int height;
+    uint32_t tx_position;
+
+    DBHistoryKey() : height(0), tx_position(0) {}
+    DBHistoryKey(const uint256 &script_hash_in, int height_in,
+                 uint32_t tx_position_in)
+        : script_hash(script_hash_in), height(height_in),
+          tx_position(tx_position_in) {}
+
+    template <typename Stream> void Serialize(Stream &s) const {
+        ser_writedata8(s, DB_SCRIPT_HISTORY);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_position);
+    }
+
+    template <typename Stream> void Unserialize(Stream &s) {
+        if (ser_readdata8(s) != DB_SCRIPT_HISTORY) {
+            throw std::ios_base::failure(
+                "Invalid format for script hash index DB history key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        tx_position = ser_readdata32be(s);
+    }
+};
+
+struct DBTxIdKey {
+    int height;
+    uint32_t tx_position;
+
+    DBTxIdKey(int height_in, uint32_t tx_position_in)
+        : height(height_in), tx_position(tx_position_in) {}
+
+    template <typename Stream> void Serialize(Stream &s) const {
+        ser_writedata8(s, DB_TXID);
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_position);
+    }
+
+    template <typename Stream> void Unserialize(Stream &s) {
+        if (ser_readdata8(s) != DB_TXID) {
+            throw std::ios_base::failure(
+                "Invalid format for script hash index DB txid key");
+        }
+        height = ser_readdata32be(s);
+        tx_position = ser_readdata32be(s);
+    }
+
+    bool operator==(const DBTxIdKey &other) const {
+        return height == other.height && tx_position == other.tx_position;
+    }
+    bool operator<(const DBTxIdKey &other) const {
+        return std::tie(height, tx_position) <
+               std::tie(other.height, other.tx_position);
+    }
+};
+
+struct DBPosting {
+    std::vector<uint32_t> funded_outputs;
+    std::vector<uint32_t> spent_inputs;
+
+    SERIALIZE_METHODS(DBPosting, obj) {
+        READWRITE(
+            Using<VectorFormatter<VarIntFormatter<VarIntMode::DEFAULT>>>(
+                obj.funded_outputs),
+            Using<VectorFormatter<VarIntFormatter<VarIntMode::DEFAULT>>>(
+                obj.spent_inputs));
+    }
+};
+
+} // namespace
+
+uint256 ComputeScriptHash(const CScript &script) {
+    uint256 script_hash;
+    CSHA256()
+        .Write(script.data(), script.size())
+        .Finalize(script_hash.begin());
+    return script_hash;
+}
+
+struct ScriptHashIndex::BlockPostings {
+    /// Txids of the block, by position.
+    std::vector<TxId> txids;
+    /// Postings of the block, by script hash and tx position.
+    std::map<std::pair<uint256, uint32_t>, DBPosting> postings;
+};
+
+/** Access to the script hash index database (indexes/scripthashindex/) */
+class ScriptHashIndex::DB : public BaseIndex::DB {
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false,
+                bool f_wipe = false);
+};
+
+ScriptHashIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex::DB(GetDataDir() / "indexes" / "scripthashindex",
+                    n_cache_size, f_memory, f_wipe) {}
+
+ScriptHashIndex::ScriptHashIndex(size_t n_cache_size, bool f_memory,
+                                 bool f_wipe)
+    : m_db(std::make_unique<ScriptHashIndex::DB>(n_cache_size, f_memory,
+                                                 f_wipe)) {}
+
+ScriptHashIndex::~ScriptHashIndex() {}
+
+bool ScriptHashIndex::ComputePostings(const CBlock &block,
+                                      const CBlockIndex *pindex,
+                                      BlockPostings &postings) const {
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (pindex->nHeight == 0) {
+        return true;
+    }
+
+    CBlockUndo block_undo;
+    if (!UndoReadFromDisk(block_undo, pindex)) {
+        return error("%s: Failed to read undo data of block %s", __func__,
+                     pindex->GetBlockHash().ToString());
+    }
+    if (block_undo.vtxundo.size() + 1 != block.vtx.size()) {
+        return error("%s: Undo data of block %s does not match its "
+                     "transactions",
+                     __func__, pindex->GetBlockHash().ToString());
+    }
+
+    postings.txids.reserve(block.vtx.size());
+    for (uint32_t tx_pos = 0; tx_pos < block.vtx.size(); ++tx_pos) {
+        const CTransaction &tx = *block.vtx[tx_pos];
+        postings.txids.push_back(tx.GetId());
+
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+            const CScript &script = tx.vout[n].scriptPubKey;
+            // These outputs can never be spent, don't bloat the index with
+            // them.
+            if (script.IsUnspendable()) {
+                continue;
+            }
+            postings.postings[{ComputeScriptHash(script), tx_pos}]
+                .funded_outputs.push_back(n);
+        }
+
+        if (tx.IsCoinBase()) {
+            continue;
+        }
+
+        const CTxUndo &tx_undo = block_undo.vtxundo[tx_pos - 1];
+        for (uint32_t n = 0; n < tx_undo.vprevout.size(); ++n) {
+            const CScript &script = tx_undo.vprevout[n].GetTxOut().scriptPubKey;
+            postings.postings[{ComputeScriptHash(script), tx_pos}]
+                .spent_inputs.push_back(n);
+        }
+    }
+
+    return true;
+}
+
+bool ScriptHashIndex::PrepareBlock(const CBlock &block,
+                                   const CBlockIndex *pindex) {
+    auto postings = std::make_shared<BlockPostings>();
+    if (!ComputePostings(block, pindex, *postings)) {
+        return false;
+    }
+
+    LOCK(m_prepared_mutex);
+    m_prepared_postings[pindex->nHeight] = {pindex->GetBlockHash(),
+                                            std::move(postings)};
+    return true;
+}
+
+bool ScriptHashIndex::WriteBlock(const CBlock &block,
+                                 const CBlockIndex *pindex) {
+    std::shared_ptr<BlockPostings> postings;
+    {
+        LOCK(m_prepared_mutex);
+        auto it = m_prepared_postings.find(pindex->nHeight);
+        if (it != m_prepared_postings.end() &&
+            it->second.first == pindex->GetBlockHash()) {
+            postings = std::move(it->second.second);
+        }
+        // Blocks are written in chain order, so anything prepared up to this
+        // height is either this block or was reorganized away.
+        m_prepared_postings.erase(
+            m_prepared_postings.begin(),
+            m_prepared_postings.upper_bound(pindex->nHeight));
+    }
+
+    if (!postings) {
+        postings = std::make_shared<BlockPostings>();
+        if (!ComputePostings(block, pindex, *postings)) {
+            return false;
+        }
+    }
+
+    CDBBatch batch(*m_db);
+    for (uint32_t tx_pos = 0; tx_pos < postings->txids.size(); ++tx_pos) {
+        batch.Write(DBTxIdKey(pindex->nHeight, tx_pos),
+                    postings->txids[tx_pos]);
+    }
+    for (const auto &[key, posting] : postings->postings) {
+        batch.Write(DBHistoryKey(key.first, pindex->nHeight, key.second),
+                    posting);
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool ScriptHashIndex::Rewind(const CBlockIndex *current_tip,
+                             const CBlockIndex *new_tip) {
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    // The postings are keyed by height, so the entries of the disconnected
+    // blocks would otherwise be mixed with those of the blocks replacing them.
+    CDBBatch batch(*m_db);
+    const auto &consensus_params = Params().GetConsensus();
+    for (const CBlockIndex *pindex = current_tip; pindex != new_tip;
+         pindex = pindex->pprev) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+            return error("%s: Failed to read block %s from disk", __func__,
+                         pindex->GetBlockHash().ToString());
+        }
+
+        BlockPostings postings;
+        if (!ComputePostings(block, pindex, postings)) {
+            return false;
+        }
+
+        for (uint32_t tx_pos = 0; tx_pos < postings.txids.size(); ++tx_pos) {
+            batch.Erase(DBTxIdKey(pindex->nHeight, tx_pos));
+        }
+        for (const auto &entry : postings.postings) {
+            batch.Erase(DBHistoryKey(entry.first.first, pindex->nHeight,
+                                     entry.first.second));
+        }
+    }
+
+    if (!m_db->WriteBatch(batch)) {
+        return false;
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+BaseIndex::DB &ScriptHashIndex::GetDB() const {
+    return *m_db;
+}
+
+bool ScriptHashIndex::LookupHistory(const uint256 &script_hash,
+                                    int from_height, uint32_t from_position,
+                                    size_t max_entries,
+                                    std::vector<ScriptHistoryEntry> &entries,
+                                    bool &more) const {
+    entries.clear();
+    more = false;
+
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    db_it->Seek(DBHistoryKey(script_hash, std::max(from_height, 0),
+                             from_height < 0 ? 0 : from_position));
+
+    for (; db_it->Valid(); db_it->Next()) {
+        DBHistoryKey key;
+        if (!db_it->GetKey(key) || key.script_hash != script_hash) {
+            break;
+        }
+
+        if (entries.size() == max_entries) {
+            more = true;
+            break;
+        }
+
+        DBPosting posting;
+        if (!db_it->GetValue(posting)) {
+            return error("%s: Unable to read posting of script hash %s at "
+                         "height %d",
+                         __func__, script_hash.ToString(), key.height);
+        }
+
+        ScriptHistoryEntry &entry = entries.emplace_back();
+        entry.height = key.height;
+        entry.tx_position = key.tx_position;
+        entry.funded_outputs = std::move(posting.funded_outputs);
+        entry.spent_inputs = std::move(posting.spent_inputs);
+    }
+
+    // The entries are sorted like the txid keys, so they are resolved with a
+    // single forward moving iterator. Entries of a busy script are often close
+    // to each other, in which case stepping the iterator is a lot cheaper than
+    // seeking it.
+    bool positioned = false;
+    for (ScriptHistoryEntry &entry : entries) {
+        const DBTxIdKey expected_key(entry.height, entry.tx_position);
+        DBTxIdKey key(-1, 0);
+        for (int steps = 0; positioned && steps < MAX_TXID_ITERATOR_STEPS;
+             ++steps) {
+            if (!db_it->Valid() || !db_it->GetKey(key) ||
+                !(key < expected_key)) {
+                break;
+            }
+            db_it->Next();
+        }
+        if (!positioned || !(key == expected_key)) {
+            db_it->Seek(expected_key);
+            positioned = true;
+        }
+        if (!db_it->Valid() || !db_it->GetKey(key) || !(key == expected_key) ||
+            !db_it->GetValue(entry.txid)) {
+            return error("%s: Unable to read txid at height %d position %u",
+                         __func__, entry.height, entry.tx_position);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTHASHINDEX_H
+#define BITCOIN_INDEX_SCRIPTHASHINDEX_H
+
+#include <index/base.h>
+#include <primitives/txid.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTHASHINDEX{false};
+/** Number of history entries returned by a lookup when not specified. */
+static constexpr int DEFAULT_SCRIPT_HISTORY_PAGE_SIZE{1000};
+
+/**
+ * Hash identifying a scriptPubKey in the script hash index. This is the
+ * single SHA256 of the script, so that its hex representation matches the
+ * script hashes used by Electrum servers.
+ */
+uint256 ComputeScriptHash(const CScript &script);
+
+/** One transaction in the history of a script. */
+struct ScriptHistoryEntry {
+    int height{0};
+    /// Position of the transaction in its block.
+    uint32_t tx_position{0};
+    TxId txid;
+    /// Indexes of the outputs of this transaction paying to the script.
+    std::vector<uint32_t> funded_outputs;
+    /// Indexes of the inputs of this transaction spending from the script.
+    std::vector<uint32_t> spent_inputs;
+};
+
+/**
+ * ScriptHashIndex maps the hash of a scriptPubKey to the confirmed
+ * transactions that pay to or spend from it.
+ *
+ * Each posting is keyed by (script hash, height, tx position) so the history
+ * of a script is a single contiguous range of the database, ordered the same
+ * way as the chain and cheap to page through. The txid of a posting is stored
+ * once per transaction rather than once per script it touches.
+ */
+class ScriptHashIndex final : public BaseIndex {
+protected:
+    class DB;
+
+private:
+    /// Everything that is written to the database for one block.
+    struct BlockPostings;
+
+    const std::unique_ptr<DB> m_db;
+
+    Mutex m_prepared_mutex;
+    /// Postings computed ahead of time by PrepareBlock, by height.
+    std::map<int, std::pair<BlockHash, std::shared_ptr<BlockPostings>>>
+        m_prepared_postings GUARDED_BY(m_prepared_mutex);
+
+    bool ComputePostings(const CBlock &block, const CBlockIndex *pindex,
+                         BlockPostings &postings) const;
+
+protected:
+    /// Reading the undo data and hashing the scripts of a block does not
+    /// depend on other blocks, so it is done ahead of time while the index is
+    /// catching up. The database writes are still done in chain order.
+    bool PrepareBlock(const CBlock &block, const CBlockIndex *pindex) override;
+
+    bool WriteBlock(const CBlock &block, const CBlockIndex *pindex) override;
+
+    bool Rewind(const CBlockIndex *current_tip,
+                const CBlockIndex *new_tip) override;
+
+    BaseIndex::DB &GetDB() const override;
+
+    const char *GetName() const override { return "scripthashindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptHashIndex(size_t n_cache_size, bool f_memory = false,
+                             bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an
+    // incomplete type.
+    virtual ~ScriptHashIndex() override;
+
+    /**
+     * Look up the history of a script, in chain order.
+     *
+     * @param[in]   script_hash    The script hash to look up.
+     * @param[in]   from_height    Skip the transactions below this height.
+     * @param[in]   from_position  Skip the transactions at from_height that
+     *                             are before this position in their block.
+     * @param[in]   max_entries    Maximum number of entries to return.
+     * @param[out]  entries        The history, starting at the cursor.
+     * @param[out]  more           Whether there are entries after the last
+     *                             returned one.
+     * @return  false on database error.
+     */
+    bool LookupHistory(const uint256 &script_hash, int from_height,
+                       uint32_t from_position, size_t max_entries,
+                       std::vector<ScriptHistoryEntry> &entries,
+                       bool &more) const;
+};
+
+/// The global script hash index. May be null.
+extern std::unique_ptr<ScriptHashIndex> g_script_hash_index;
+
+#endif // BITCOIN_INDEX_SCRIPTHASHINDEX_H
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/spentindex.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <dbwrapper.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <util/system.h>
+
+constexpr uint8_t DB_SPENT{'s'};
+
+std::unique_ptr<SpentIndex> g_spent_index;
+
+namespace {
+
+struct DBSpentKey {
+    COutPoint outpoint;
+
+    explicit DBSpentKey(const COutPoint &outpoint_in) : outpoint(outpoint_in) {}
+
+    SERIALIZE_METHODS(DBSpentKey, obj) {
+        uint8_t prefix{DB_SPENT};
+        READWRITE(prefix);
+        if (prefix != DB_SPENT) {
+            throw std::ios_base::failure(
+                "Invalid format for spent index DB key");
+        }
+        READWRITE(obj.outpoint);
+    }
+};
+
+} // namespace
+
+/** Access to the spent index database (indexes/spentindex/) */
+class SpentIndex::DB : public BaseIndex::DB {
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false,
+                bool f_wipe = false);
+};
+
+SpentIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex::DB(GetDataDir() / "indexes" / "spentindex", n_cache_size,
+                    f_memory, f_wipe) {}
+
+SpentIndex::SpentIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(std::make_unique<SpentIndex::DB>(n_cache_size, f_memory, f_wipe)) {
+}
+
+SpentIndex::~SpentIndex() {}
+
+bool SpentIndex::WriteBlock(const CBlock &block, const CBlockIndex *pindex) {
+    CDBBatch batch(*m_db);
+    for (const auto &tx : block.vtx) {
+        if (tx->IsCoinBase()) {
+            continue;
+        }
+
+        SpendingInput spender;
+        spender.txid = tx->GetId();
+        spender.height = pindex->nHeight;
+        for (uint32_t n = 0; n < tx->vin.size(); ++n) {
+            spender.input_index = n;
+            batch.Write(DBSpentKey(tx->vin[n].prevout), spender);
+        }
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool SpentIndex::Rewind(const CBlockIndex *current_tip,
+                        const CBlockIndex *new_tip) {
+    assert(current_tip->GetAncestor(new_tip->nHeight) == new_tip);
+
+    // The outpoints spent by the disconnected blocks are unspent again, or
+    // will be overwritten if the new chain spends them too.
+    CDBBatch batch(*m_db);
+    const auto &consensus_params = Params().GetConsensus();
+    for (const CBlockIndex *pindex = current_tip; pindex != new_tip;
+         pindex = pindex->pprev) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+            return error("%s: Failed to read block %s from disk", __func__,
+                         pindex->GetBlockHash().ToString());
+        }
+
+        for (const auto &tx : block.vtx) {
+            if (tx->IsCoinBase()) {
+                continue;
+            }
+            for (const CTxIn &txin : tx->vin) {
+                batch.Erase(DBSpentKey(txin.prevout));
+            }
+        }
+    }
+
+    if (!m_db->WriteBatch(batch)) {
+        return false;
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+BaseIndex::DB &SpentIndex::GetDB() const {
+    return *m_db;
+}
+
+bool SpentIndex::FindSpender(const COutPoint &outpoint,
+                             SpendingInput &spender) const {
+    return m_db->Read(DBSpentKey(outpoint), spender);
+}
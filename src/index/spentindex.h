@@ -0,0 +1,74 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SPENTINDEX_H
+#define BITCOIN_INDEX_SPENTINDEX_H
+
+#include <index/base.h>
+#include <primitives/txid.h>
+#include <serialize.h>
+
+#include <cstdint>
+#include <memory>
+
+class COutPoint;
+
+static constexpr bool DEFAULT_SPENTINDEX{false};
+
+/** The confirmed transaction input spending an outpoint. */
+struct SpendingInput {
+    TxId txid;
+    uint32_t input_index{0};
+    int height{0};
+
+    SERIALIZE_METHODS(SpendingInput, obj) {
+        READWRITE(obj.txid, VARINT(obj.input_index),
+                  VARINT_MODE(obj.height, VarIntMode::NONNEGATIVE_SIGNED));
+    }
+};
+
+/**
+ * SpentIndex maps each outpoint spent in the active chain to the input
+ * spending it, so that the spender of an outpoint can be found without
+ * scanning the blocks that followed its creation.
+ */
+class SpentIndex final : public BaseIndex {
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+protected:
+    bool WriteBlock(const CBlock &block, const CBlockIndex *pindex) override;
+
+    bool Rewind(const CBlockIndex *current_tip,
+                const CBlockIndex *new_tip) override;
+
+    BaseIndex::DB &GetDB() const override;
+
+    const char *GetName() const override { return "spentindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit SpentIndex(size_t n_cache_size, bool f_memory = false,
+                        bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an
+    // incomplete type.
+    virtual ~SpentIndex() override;
+
+    /// Look up the input spending an outpoint.
+    ///
+    /// @param[in]   outpoint  The outpoint to look up.
+    /// @param[out]  spender   The input spending the outpoint.
+    /// @return  true if the outpoint was spent in the indexed chain, false
+    /// otherwise
+    bool FindSpender(const COutPoint &outpoint, SpendingInput &spender) const;
+};
+
+/// The global spent index. May be null.
+extern std::unique_ptr<SpentIndex> g_spent_index;
+
+#endif // BITCOIN_INDEX_SPENTINDEX_H
@@ -216,7 +216,8 @@ bool TxIndex::Init() {
     return BaseIndex::Init();
 }
 
-bool TxIndex::WriteBlock(const CBlock &block, const CBlockIndex *pindex) {
+bool TxIndex::WriteTxPositions(const CBlock &block,
+                               const CBlockIndex *pindex) {
     // Exclude genesis block transaction because outputs are not spendable.
     if (pindex->nHeight == 0) {
         return true;
@@ -233,6 +234,34 @@ bool TxIndex::WriteBlock(const CBlock &block, const CBlockIndex *pindex) {
     return m_db->WriteTxs(vPos);
 }
 
+bool TxIndex::PrepareBlock(const CBlock &block, const CBlockIndex *pindex) {
+    if (!WriteTxPositions(block, pindex)) {
+        return false;
+    }
+
+    LOCK(m_prepared_mutex);
+    m_prepared_blocks[pindex->nHeight] = pindex->GetBlockHash();
+    return true;
+}
+
+bool TxIndex::WriteBlock(const CBlock &block, const CBlockIndex *pindex) {
+    {
+        LOCK(m_prepared_mutex);
+        auto it = m_prepared_blocks.find(pindex->nHeight);
+        const bool prepared = it != m_prepared_blocks.end() &&
+                              it->second == pindex->GetBlockHash();
+        // Blocks are written in chain order, so anything prepared up to this
+        // height is either this block or was reorganized away.
+        m_prepared_blocks.erase(m_prepared_blocks.begin(),
+                                m_prepared_blocks.upper_bound(pindex->nHeight));
+        if (prepared) {
+            return true;
+        }
+    }
+
+    return WriteTxPositions(block, pindex);
+}
+
 BaseIndex::DB &TxIndex::GetDB() const {
     return *m_db;
 }
@@ -6,8 +6,10 @@
 #define BITCOIN_INDEX_TXINDEX_H
 
 #include <index/base.h>
+#include <sync.h>
 #include <txdb.h>
 
+#include <map>
 #include <memory>
 
 /**
@@ -22,10 +24,21 @@ protected:
 private:
     const std::unique_ptr<DB> m_db;
 
+    Mutex m_prepared_mutex;
+    /// Blocks whose transactions were already written by PrepareBlock, by
+    /// height.
+    std::map<int, BlockHash> m_prepared_blocks GUARDED_BY(m_prepared_mutex);
+
+    bool WriteTxPositions(const CBlock &block, const CBlockIndex *pindex);
+
 protected:
     /// Override base class init to migrate from old database.
     bool Init() override;
 
+    /// The transaction positions do not depend on other blocks, so they are
+    /// written ahead of time while the index is catching up.
+    bool PrepareBlock(const CBlock &block, const CBlockIndex *pindex) override;
+
     bool WriteBlock(const CBlock &block, const CBlockIndex *pindex) override;
 
     BaseIndex::DB &GetDB() const override;
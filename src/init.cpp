@@ -12,6 +12,7 @@
 #include <addrman.h>
 #include <amount.h>
 #include <avalanche/avalanche.h>
+#include <avalanche/peermanager.h> // For DEFAULT_PERSIST_AVAPEERS
 #include <avalanche/processor.h>
 #include <avalanche/proof.h> // For AVALANCHE_LEGACY_PROOF_DEFAULT
 #include <avalanche/validation.h>
@@ -30,6 +31,8 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scripthashindex.h>
+#include <index/spentindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/node.h>
@@ -179,6 +182,12 @@ void Interrupt(NodeContext &node) {
     if (g_coin_stats_index) {
         g_coin_stats_index->Interrupt();
     }
+    if (g_script_hash_index) {
+        g_script_hash_index->Interrupt();
+    }
+    if (g_spent_index) {
+        g_spent_index->Interrupt();
+    }
 }
 
 void Shutdown(NodeContext &node) {
@@ -243,6 +252,14 @@ void Shutdown(NodeContext &node) {
     // stopped, destruct and reset all to nullptr.
     node.peerman.reset();
 
+    if (g_avalanche &&
+        node.args->GetBoolArg("-persistavapeers",
+                              avalanche::DEFAULT_PERSIST_AVAPEERS)) {
+        g_avalanche->withPeerManager([](avalanche::PeerManager &pm) {
+            pm.dumpPeersToFile(GetDataDir() / "avapeers.dat");
+        });
+    }
+
     // Destroy various global instances
     g_avalanche.reset();
     node.connman.reset();
@@ -277,6 +294,14 @@ void Shutdown(NodeContext &node) {
         g_coin_stats_index->Stop();
         g_coin_stats_index.reset();
     }
+    if (g_script_hash_index) {
+        g_script_hash_index->Stop();
+        g_script_hash_index.reset();
+    }
+    if (g_spent_index) {
+        g_spent_index->Stop();
+        g_spent_index.reset();
+    }
     ForEachBlockFilterIndex([](BlockFilterIndex &index) { index.Stop(); });
     DestroyAllBlockFilterIndexes();
 
@@ -580,12 +605,12 @@ void SetupServerArgs(NodeContext &node) {
                   "of old blocks. This allows the pruneblockchain RPC to be "
                   "called to delete specific blocks, and enables automatic "
                   "pruning of old blocks if a target size in MiB is provided. "
-                  "This mode is incompatible with -txindex, -coinstatsindex "
-                  "and -rescan. Warning: Reverting this setting requires "
-                  "re-downloading the entire blockchain. (default: 0 = disable "
-                  "pruning blocks, 1 = allow manual pruning via RPC, >=%u = "
-                  "automatically prune block files to stay under the specified "
-                  "target size in MiB)",
+                  "This mode is incompatible with -txindex, -coinstatsindex, "
+                  "-scripthashindex, -spentindex and -rescan. Warning: "
+                  "Reverting this setting requires re-downloading the entire "
+                  "blockchain. (default: 0 = disable pruning blocks, 1 = allow "
+                  "manual pruning via RPC, >=%u = automatically prune block "
+                  "files to stay under the specified target size in MiB)",
                   MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024),
         ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg(
@@ -625,6 +650,18 @@ void SetupServerArgs(NodeContext &node) {
                              "getrawtransaction rpc call (default: %d)",
                              DEFAULT_TXINDEX),
                    ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-scripthashindex",
+                   strprintf("Maintain an index of the transactions paying to "
+                             "or spending from each script, used by the "
+                             "getscripthistory rpc call (default: %d)",
+                             DEFAULT_SCRIPTHASHINDEX),
+                   ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-spentindex",
+                   strprintf("Maintain an index of the input spending each "
+                             "spent outpoint, used by the getspendingtx rpc "
+                             "call (default: %d)",
+                             DEFAULT_SPENTINDEX),
+                   ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg(
         "-blockfilterindex=<type>",
         strprintf("Maintain an index of compact filters by block "
@@ -1336,6 +1373,11 @@ void SetupServerArgs(NodeContext &node) {
                    strprintf("Enable avalanche proof replacement (default: %u)",
                              AVALANCHE_DEFAULT_PROOF_REPLACEMENT_ENABLED),
                    ArgsManager::ALLOW_BOOL, OptionsCategory::AVALANCHE);
+    argsman.AddArg("-avalanchepreconsensus",
+                   strprintf("Enable the avalanche pre-consensus on the "
+                             "mempool transactions (default: %u)",
+                             AVALANCHE_DEFAULT_PRECONSENSUS),
+                   ArgsManager::ALLOW_BOOL, OptionsCategory::AVALANCHE);
     argsman.AddArg(
         "-avaminquorumstake",
         strprintf(
@@ -1406,6 +1448,11 @@ void SetupServerArgs(NodeContext &node) {
                    ArgsManager::ALLOW_ANY, OptionsCategory::AVALANCHE);
     argsman.AddArg("-avasessionkey", "Avalanche session key (default: random)",
                    ArgsManager::ALLOW_ANY, OptionsCategory::AVALANCHE);
+    argsman.AddArg("-persistavapeers",
+                   strprintf("Whether to save the avalanche peers on shutdown "
+                             "and load them on restart (default: %u)",
+                             avalanche::DEFAULT_PERSIST_AVAPEERS),
+                   ArgsManager::ALLOW_BOOL, OptionsCategory::AVALANCHE);
     argsman.AddArg(
         "-maxavalancheoutbound",
         "Set the maximum number of avalanche outbound peers to connect to. "
@@ -1872,7 +1919,8 @@ bool AppInitParameterInteraction(Config &config, const ArgsManager &args) {
         nLocalServices = ServiceFlags(nLocalServices | NODE_COMPACT_FILTERS);
     }
 
-    // if using block pruning, then disallow txindex and coinstatsindex
+    // if using block pruning, then disallow txindex, coinstatsindex,
+    // scripthashindex and spentindex
     if (args.GetArg("-prune", 0)) {
         if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
             return InitError(_("Prune mode is incompatible with -txindex."));
@@ -1881,6 +1929,13 @@ bool AppInitParameterInteraction(Config &config, const ArgsManager &args) {
             return InitError(
                 _("Prune mode is incompatible with -coinstatsindex."));
         }
+        if (args.GetBoolArg("-scripthashindex", DEFAULT_SCRIPTHASHINDEX)) {
+            return InitError(
+                _("Prune mode is incompatible with -scripthashindex."));
+        }
+        if (args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+            return InitError(_("Prune mode is incompatible with -spentindex."));
+        }
     }
 
     // -bind and -whitebind can't be set when not listening
@@ -2573,8 +2628,8 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
     // Step 6.5 (I guess ?): Initialize Avalanche.
     bilingual_str avalancheError;
     g_avalanche = avalanche::Processor::MakeProcessor(
-        args, *node.chain, node.connman.get(), chainman, *node.scheduler,
-        avalancheError);
+        args, *node.chain, node.connman.get(), chainman, node.mempool.get(),
+        *node.scheduler, avalancheError);
     if (!g_avalanche) {
         InitError(avalancheError);
         return false;
@@ -2604,6 +2659,17 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
                                       ? MAX_TX_INDEX_CACHE_MB << 20
                                       : 0);
     nTotalCache -= nTxIndexCache;
+    int64_t nScriptHashIndexCache = std::min(
+        nTotalCache / 8,
+        args.GetBoolArg("-scripthashindex", DEFAULT_SCRIPTHASHINDEX)
+            ? MAX_SCRIPT_HASH_INDEX_CACHE_MB << 20
+            : 0);
+    nTotalCache -= nScriptHashIndexCache;
+    int64_t nSpentIndexCache = std::min(
+        nTotalCache / 8, args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)
+                             ? MAX_SPENT_INDEX_CACHE_MB << 20
+                             : 0);
+    nTotalCache -= nSpentIndexCache;
     int64_t filter_index_cache = 0;
     if (!g_enabled_filter_types.empty()) {
         size_t n_indexes = g_enabled_filter_types.size();
@@ -2629,6 +2695,14 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
         LogPrintf("* Using %.1f MiB for transaction index database\n",
                   nTxIndexCache * (1.0 / 1024 / 1024));
     }
+    if (args.GetBoolArg("-scripthashindex", DEFAULT_SCRIPTHASHINDEX)) {
+        LogPrintf("* Using %.1f MiB for script hash index database\n",
+                  nScriptHashIndexCache * (1.0 / 1024 / 1024));
+    }
+    if (args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+        LogPrintf("* Using %.1f MiB for spent index database\n",
+                  nSpentIndexCache * (1.0 / 1024 / 1024));
+    }
     for (BlockFilterType filter_type : g_enabled_filter_types) {
         LogPrintf("* Using %.1f MiB for %s block filter index database\n",
                   filter_index_cache * (1.0 / 1024 / 1024),
@@ -2908,6 +2982,18 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
             /* cache size */ 0, false, fReindex);
         g_coin_stats_index->Start(chainman.ActiveChainstate());
     }
+
+    if (args.GetBoolArg("-scripthashindex", DEFAULT_SCRIPTHASHINDEX)) {
+        g_script_hash_index = std::make_unique<ScriptHashIndex>(
+            nScriptHashIndexCache, false, fReindex);
+        g_script_hash_index->Start(chainman.ActiveChainstate());
+    }
+
+    if (args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX)) {
+        g_spent_index = std::make_unique<SpentIndex>(nSpentIndexCache, false,
+                                                     fReindex);
+        g_spent_index->Start(chainman.ActiveChainstate());
+    }
     // Step 9: load wallet
     for (const auto &client : node.chain_clients) {
         if (!client->load()) {
@@ -3176,6 +3262,21 @@ bool AppInitMain(Config &config, RPCServer &rpcServer,
         },
         DUMP_BANS_INTERVAL);
 
+    // Reload the avalanche peers from the previous run, so the quorum can be
+    // established without waiting for all the proofs to be relayed again.
+    if (args.GetBoolArg("-persistavapeers",
+                        avalanche::DEFAULT_PERSIST_AVAPEERS)) {
+        std::unordered_set<avalanche::ProofRef, avalanche::SaltedProofHasher>
+            registeredProofs;
+        g_avalanche->withPeerManager([&](avalanche::PeerManager &pm) {
+            pm.loadPeersFromFile(GetDataDir() / "avapeers.dat",
+                                 registeredProofs);
+        });
+        for (const avalanche::ProofRef &proof : registeredProofs) {
+            g_avalanche->addProofToReconcile(proof);
+        }
+    }
+
     // Start Avalanche's event loop.
     g_avalanche->startEventLoop(*node.scheduler);
 
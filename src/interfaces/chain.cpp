@@ -365,7 +365,10 @@ namespace {
                 return true;
             }
             LockPoints lp;
-            CTxMemPoolEntry entry(tx, Amount(), 0, 0, false, 0, lp);
+            // The entry is only used to compute the ancestors, it doesn't
+            // need the sighash midstates.
+            CTxMemPoolEntry entry(tx, Amount(), 0, 0, false, 0, lp,
+                                  PrecomputedTransactionData());
             CTxMemPool::setEntries ancestors;
             auto limit_ancestor_count =
                 gArgs.GetArg("-limitancestorcount", DEFAULT_ANCESTOR_LIMIT);
@@ -22,11 +22,13 @@
 #include <pow/pow.h>
 #include <primitives/transaction.h>
 #include <timedata.h>
+#include <util/check.h>
 #include <util/moneystr.h>
 #include <util/system.h>
 #include <validation.h>
 
 #include <algorithm>
+#include <limits>
 #include <utility>
 
 int64_t UpdateTime(CBlockHeader *pblock, const CChainParams &chainParams,
@@ -157,6 +159,8 @@ BlockAssembler::CreateNewBlock(const CScript &scriptPubKeyIn) {
             ? nMedianTimePast
             : pblock->GetBlockTime();
 
+    addFinalizedTxs();
+
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
     addPackageTxs(nPackagesSelected, nDescendantsUpdated);
@@ -373,6 +377,44 @@ void BlockAssembler::SortForBlock(
               CompareTxIterByAncestorCount());
 }
 
+void BlockAssembler::addFinalizedTxs() {
+    uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+    std::string dummy;
+    std::vector<CTxMemPool::txiter> sortedEntries;
+
+    for (const TxId &txid : m_mempool.GetAvalancheFinalizedTxs()) {
+        // The finalized transactions are forgotten as they leave the mempool.
+        CTxMemPool::txiter it = *Assert(m_mempool.GetIter(txid));
+        if (inBlock.count(it)) {
+            // Already added as the ancestor of another finalized transaction.
+            continue;
+        }
+
+        CTxMemPool::setEntries package;
+        m_mempool.CalculateMemPoolAncestors(*it, package, nNoLimit, nNoLimit,
+                                            nNoLimit, nNoLimit, dummy, false);
+        onlyUnconfirmed(package);
+        package.insert(it);
+
+        uint64_t packageSize = 0;
+        int64_t packageSigOps = 0;
+        for (CTxMemPool::txiter entry : package) {
+            packageSize += entry->GetTxSize();
+            packageSigOps += entry->GetSigOpCount();
+        }
+
+        if (!TestPackage(packageSize, packageSigOps) ||
+            !TestPackageTransactions(package)) {
+            continue;
+        }
+
+        SortForBlock(package, sortedEntries);
+        for (CTxMemPool::txiter entry : sortedEntries) {
+            AddToBlock(entry);
+        }
+    }
+}
+
 /**
  * addPackageTx includes transactions paying a fee by ensuring that
  * the partial ordering of transactions is maintained.  That is to say
@@ -193,6 +193,12 @@ private:
      */
     void addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated)
         EXCLUSIVE_LOCKS_REQUIRED(m_mempool.cs);
+    /**
+     * Add the transactions finalized by avalanche, along with their
+     * unconfirmed ancestors, regardless of their feerate. They go in first so
+     * the package selection accounts for them.
+     */
+    void addFinalizedTxs() EXCLUSIVE_LOCKS_REQUIRED(m_mempool.cs);
 
     // helper functions for addPackageTxs()
     /** Remove confirmed (inBlock) entries from given set */
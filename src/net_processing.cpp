@@ -45,6 +45,7 @@
 #include <validation.h>
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <memory>
 #include <typeinfo>
@@ -935,6 +936,15 @@ private:
     uint32_t GetAvalancheVoteForBlock(const BlockHash &hash)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Decide a response for an Avalanche poll about the given transaction.
+     *
+     * @param[in]   id              The id of the transaction being polled for
+     * @return                      Our current vote for the transaction
+     */
+    uint32_t GetAvalancheVoteForTx(const TxId &id)
+        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /**
      * Checks if address relay is permitted with peer. If needed, initializes
      * the m_addr_known bloom filter and sets m_addr_relay_enabled to true.
@@ -3362,19 +3372,29 @@ uint32_t PeerManagerImpl::GetAvalancheVoteForBlock(const BlockHash &hash) {
     return -3;
 };
 
-/**
- * Decide a response for an Avalanche poll about the given transaction.
- *
- * FIXME This function should be expanded to return different vote responses
- * based on inspection of mempool.
- *
- * @param[in] mempool  The mempool to base our votes on
- * @param[in] id       The id of the transaction being polled for
- * @return             Our current vote for the proof
- */
-static uint32_t getAvalancheVoteForTx(CTxMemPool &mempool, const TxId &id) {
+uint32_t PeerManagerImpl::GetAvalancheVoteForTx(const TxId &id) {
+    AssertLockHeld(cs_main);
+
+    // Accepted in our mempool, or in a recent block.
+    if (m_mempool.exists(id) ||
+        WITH_LOCK(m_recent_confirmed_transactions_mutex,
+                  return m_recent_confirmed_transactions->contains(id))) {
+        return 0;
+    }
+
+    // Invalid, or conflicting with a transaction we have.
+    if (recentRejects->contains(id)) {
+        return 1;
+    }
+
+    // Missing inputs.
+    if (m_orphanage.HaveTx(id)) {
+        return -2;
+    }
+
+    // Unknown transaction.
     return -1;
-};
+}
 
 /**
  * Decide a response for an Avalanche poll about the given proof.
@@ -5034,7 +5054,8 @@ void PeerManagerImpl::ProcessMessage(
             // If inv's type is known, get a vote for its hash
             switch (inv.type) {
                 case MSG_TX: {
-                    vote = getAvalancheVoteForTx(m_mempool, TxId(inv.hash));
+                    vote = WITH_LOCK(cs_main, return GetAvalancheVoteForTx(
+                                                  TxId(inv.hash)));
                 } break;
                 case MSG_BLOCK: {
                     vote = WITH_LOCK(cs_main, return GetAvalancheVoteForBlock(
@@ -5078,10 +5099,12 @@ void PeerManagerImpl::ProcessMessage(
 
         std::vector<avalanche::BlockUpdate> blockUpdates;
         std::vector<avalanche::ProofUpdate> proofUpdates;
+        std::vector<avalanche::TxUpdate> txUpdates;
         int banscore;
         std::string error;
         if (!g_avalanche->registerVotes(pfrom.GetId(), response, blockUpdates,
-                                        proofUpdates, banscore, error)) {
+                                        proofUpdates, txUpdates, banscore,
+                                        error)) {
             Misbehaving(pfrom, banscore, error);
             return;
         }
@@ -5176,6 +5199,34 @@ void PeerManagerImpl::ProcessMessage(
             }
         }
 
+        for (avalanche::TxUpdate &u : txUpdates) {
+            const CTransactionRef tx = u.getVoteItem();
+            const TxId &txid = tx->GetId();
+
+            logVoteUpdate(u, "tx", txid);
+
+            switch (u.getStatus()) {
+                case avalanche::VoteStatus::Invalid: {
+                    // The network settled on a conflicting transaction, vote
+                    // against this one from now on.
+                    LOCK2(cs_main, m_mempool.cs);
+                    m_mempool.removeRecursive(*tx,
+                                              MemPoolRemovalReason::CONFLICT);
+                    recentRejects->insert(txid);
+                } break;
+                case avalanche::VoteStatus::Finalized:
+                    // Get the transaction in the next blocks we mine.
+                    m_mempool.SetAvalancheFinalized(txid);
+                    break;
+                case avalanche::VoteStatus::Rejected:
+                case avalanche::VoteStatus::Accepted:
+                case avalanche::VoteStatus::Stale:
+                    // Until it is finalized, the transaction is left to the
+                    // mempool policy.
+                    break;
+            }
+        }
+
         if (blockUpdates.size()) {
             for (avalanche::BlockUpdate &u : blockUpdates) {
                 CBlockIndex *pindex = u.getVoteItem();
@@ -5324,17 +5375,37 @@ void PeerManagerImpl::ProcessMessage(
                 return pm.getShareableProofsSnapshot();
             });
 
+        // The short ids of the known proofs are computed a batch at a time.
+        constexpr size_t SHORTID_BATCH_SIZE = 64;
+        std::array<avalanche::ProofRef, SHORTID_BATCH_SIZE> batch;
+        std::array<const uint256 *, SHORTID_BATCH_SIZE> proofids;
+        std::array<uint64_t, SHORTID_BATCH_SIZE> shortids;
+        size_t batchSize = 0;
         size_t proofCount = 0;
-        proofs.forEachLeaf([&](const avalanche::ProofRef &proof) {
-            uint64_t shortid = compactProofs.getShortID(proof->getId());
 
-            proofCount += shortIdProcessor.matchKnownItem(shortid, proof);
+        // Though ideally we'd continue scanning for the
+        // two-proofs-match-shortid case, the performance win of an early exit
+        // here is too good to pass up and worth the extra risk.
+        auto matchBatch = [&]() {
+            compactProofs.getShortIDs(proofids.data(), shortids.data(),
+                                      batchSize);
+            const bool done = shortIdProcessor.matchKnownItemsLazy(
+                shortids.data(), batchSize, proofCount,
+                [&](size_t i) { return batch[i]; });
+            batchSize = 0;
+            return done;
+        };
 
-            // Though ideally we'd continue scanning for the
-            // two-proofs-match-shortid case, the performance win of an early
-            // exit here is too good to pass up and worth the extra risk.
-            return proofCount != shortIdProcessor.getShortIdCount();
-        });
+        const bool stopped =
+            !proofs.forEachLeaf([&](const avalanche::ProofRef &proof) {
+                batch[batchSize] = proof;
+                proofids[batchSize] = &proof->getId();
+                batchSize++;
+                return batchSize < SHORTID_BATCH_SIZE || !matchBatch();
+            });
+        if (!stopped && batchSize > 0) {
+            matchBatch();
+        }
 
         avalanche::ProofsRequest req;
         for (size_t i = 0; i < compactProofs.size(); i++) {
@@ -67,9 +67,17 @@ public:
         *(static_cast<CBlockHeader *>(this)) = header;
     }
 
-    SERIALIZE_METHODS(CBlock, obj) {
-        READWRITEAS(CBlockHeader, obj);
-        READWRITE(obj.vtx);
+    template <typename Stream> void Serialize(Stream &s) const {
+        s << static_cast<const CBlockHeader &>(*this);
+        s << vtx;
+    }
+
+    template <typename Stream> void Unserialize(Stream &s) {
+        s >> static_cast<CBlockHeader &>(*this);
+        // Compute the ids of the transactions several at a time.
+        std::vector<CMutableTransaction> txs;
+        s >> txs;
+        vtx = MakeTransactionRefs(std::move(txs));
     }
 
     void SetNull() {
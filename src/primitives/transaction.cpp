@@ -5,10 +5,13 @@
 
 #include <primitives/transaction.h>
 
+#include <crypto/sha256.h>
 #include <hash.h>
+#include <streams.h>
 #include <tinyformat.h>
 #include <util/strencodings.h>
 
+#include <algorithm>
 #include <cassert>
 
 std::string COutPoint::ToString() const {
@@ -72,6 +75,54 @@ CTransaction::CTransaction(const CMutableTransaction &tx)
 CTransaction::CTransaction(CMutableTransaction &&tx)
     : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion),
       nLockTime(tx.nLockTime), hash(ComputeHash()) {}
+CTransaction::CTransaction(CMutableTransaction &&tx, const uint256 &hashIn)
+    : vin(std::move(tx.vin)), vout(std::move(tx.vout)), nVersion(tx.nVersion),
+      nLockTime(tx.nLockTime), hash(hashIn) {}
+
+std::vector<CTransactionRef>
+MakeTransactionRefs(std::vector<CMutableTransaction> &&txs) {
+    // The transactions are serialized and hashed by batches, so the memory
+    // used by the serialized transactions remains bounded.
+    static constexpr size_t BATCH_SIZE = 64;
+
+    std::vector<CTransactionRef> ret;
+    ret.reserve(txs.size());
+
+    std::vector<uint8_t> serialized;
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+    std::vector<const uint8_t *> inputs;
+    std::vector<uint256> ids;
+    for (size_t begin = 0; begin < txs.size(); begin += BATCH_SIZE) {
+        const size_t count = std::min(BATCH_SIZE, txs.size() - begin);
+
+        serialized.clear();
+        offsets.clear();
+        sizes.clear();
+        CVectorWriter writer(SER_GETHASH, 0, serialized, 0);
+        for (size_t i = begin; i < begin + count; i++) {
+            offsets.push_back(serialized.size());
+            writer << txs[i];
+            sizes.push_back(serialized.size() - offsets.back());
+        }
+
+        // The buffer is not reallocated anymore, the pointers remain valid.
+        inputs.clear();
+        for (size_t offset : offsets) {
+            inputs.push_back(serialized.data() + offset);
+        }
+
+        ids.resize(count);
+        SHA256DMulti(ids[0].begin(), inputs.data(), sizes.data(), count);
+
+        for (size_t i = 0; i < count; i++) {
+            ret.emplace_back(
+                new CTransaction(std::move(txs[begin + i]), ids[i]));
+        }
+    }
+
+    return ret;
+}
 
 Amount CTransaction::GetValueOut() const {
     Amount nValueOut = Amount::zero();
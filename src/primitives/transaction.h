@@ -218,6 +218,12 @@ private:
 
     uint256 ComputeHash() const;
 
+    /** Convert a CMutableTransaction whose id was computed beforehand. */
+    CTransaction(CMutableTransaction &&tx, const uint256 &hashIn);
+
+    friend std::vector<std::shared_ptr<const CTransaction>>
+    MakeTransactionRefs(std::vector<CMutableTransaction> &&txs);
+
 public:
     /** Construct a CTransaction that qualifies as IsNull() */
     CTransaction();
@@ -325,6 +331,13 @@ static inline CTransactionRef MakeTransactionRef(Tx &&txIn) {
     return std::make_shared<const CTransaction>(std::forward<Tx>(txIn));
 }
 
+/**
+ * Convert many transactions at once, e.g. the transactions of a block. Their
+ * ids are computed several at a time, which is faster than one by one.
+ */
+std::vector<CTransactionRef>
+MakeTransactionRefs(std::vector<CMutableTransaction> &&txs);
+
 /** Precompute sighash midstate to avoid quadratic hashing */
 struct PrecomputedTransactionData {
     uint256 hashPrevouts, hashSequence, hashOutputs;
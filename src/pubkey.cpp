@@ -225,6 +225,53 @@ bool CPubKey::VerifySchnorr(const uint256 &hash,
     return VerifySchnorr(hash, sig);
 }
 
+/**
+ * The scratch space is large enough for a few hundred signatures to be
+ * verified in a single multi-multiplication. Larger batches are split.
+ */
+static constexpr size_t SCHNORR_BATCH_SCRATCH_SIZE = 1 << 20;
+
+bool SchnorrBatchVerifier::Verify() const {
+    if (entries.empty()) {
+        return true;
+    }
+
+    assert(secp256k1_context_verify &&
+           "secp256k1_context_verify must be initialized to use CPubKey.");
+
+    std::vector<secp256k1_pubkey> pubkeys(entries.size());
+    std::vector<const secp256k1_pubkey *> pubkeyPtrs(entries.size());
+    std::vector<const uint8_t *> hashPtrs(entries.size());
+    std::vector<const uint8_t *> sigPtrs(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Entry &e = entries[i];
+        if (!e.pubkey.IsValid() ||
+            !secp256k1_ec_pubkey_parse(secp256k1_context_verify, &pubkeys[i],
+                                       e.pubkey.data(), e.pubkey.size())) {
+            return false;
+        }
+
+        pubkeyPtrs[i] = &pubkeys[i];
+        hashPtrs[i] = e.hash.begin();
+        sigPtrs[i] = e.sig.data();
+    }
+
+    // A single signature doesn't benefit from the scratch space.
+    secp256k1_scratch_space *scratch =
+        entries.size() > 1
+            ? secp256k1_scratch_space_create(secp256k1_context_verify,
+                                             SCHNORR_BATCH_SCRATCH_SIZE)
+            : nullptr;
+    const int ret = secp256k1_schnorr_verify_batch(
+        secp256k1_context_verify, scratch, sigPtrs.data(), hashPtrs.data(),
+        pubkeyPtrs.data(), entries.size());
+    if (scratch) {
+        secp256k1_scratch_space_destroy(secp256k1_context_verify, scratch);
+    }
+
+    return ret;
+}
+
 bool CPubKey::RecoverCompact(const uint256 &hash,
                              const std::vector<uint8_t> &vchSig) {
     if (vchSig.size() != COMPACT_SIGNATURE_SIZE) {
@@ -195,6 +195,37 @@ public:
                 const ChainCode &cc) const;
 };
 
+/**
+ * Accumulate Schnorr signatures to verify them all at once, which is
+ * significantly faster than verifying them one by one. If the batch doesn't
+ * verify, at least one of the signatures is invalid but there is no way to
+ * tell which one, so the caller has to fall back to CPubKey::VerifySchnorr.
+ */
+class SchnorrBatchVerifier {
+    struct Entry {
+        CPubKey pubkey;
+        uint256 hash;
+        std::array<uint8_t, CPubKey::SCHNORR_SIZE> sig;
+    };
+
+    std::vector<Entry> entries;
+
+public:
+    void Add(const CPubKey &pubkey, const uint256 &hash,
+             const std::array<uint8_t, CPubKey::SCHNORR_SIZE> &sig) {
+        entries.push_back({pubkey, hash, sig});
+    }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void clear() { entries.clear(); }
+
+    /**
+     * Return true if all the signatures are valid, or if there is none.
+     */
+    bool Verify() const;
+};
+
 struct CExtPubKey {
     uint8_t nDepth;
     uint8_t vchFingerprint[4];
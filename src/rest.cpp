@@ -9,6 +9,8 @@
 #include <config.h>
 #include <core_io.h>
 #include <httpserver.h>
+#include <index/scripthashindex.h>
+#include <index/spentindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
@@ -814,6 +816,119 @@ static bool rest_blockhash_by_height(Config &config, const std::any &context,
     }
 }
 
+static bool rest_script_history(Config &config, const std::any &context,
+                                HTTPRequest *req,
+                                const std::string &str_uri_part) {
+    if (!CheckWarmup(req)) {
+        return false;
+    }
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, str_uri_part);
+
+    // Path is <scripthash>[/<fromheight>/<fromposition>]
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+    if (path.size() != 1 && path.size() != 3) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "Invalid URI format. Expected "
+                       "/rest/scripthistory/<scripthash>[/<fromheight>/"
+                       "<fromposition>].<ext>");
+    }
+
+    uint256 script_hash;
+    if (!ParseHashStr(path[0], script_hash)) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "Invalid hash: " + SanitizeString(path[0]));
+    }
+
+    int32_t from_height = 0;
+    int32_t from_position = 0;
+    if (path.size() == 3 &&
+        (!ParseInt32(path[1], &from_height) || from_height < 0 ||
+         !ParseInt32(path[2], &from_position) || from_position < 0)) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "Invalid cursor: " + SanitizeString(path[1]) + "/" +
+                           SanitizeString(path[2]));
+    }
+
+    if (!g_script_hash_index) {
+        return RESTERR(req, HTTP_NOT_FOUND, "Script hash index is disabled");
+    }
+    g_script_hash_index->BlockUntilSyncedToCurrentChain();
+
+    std::vector<ScriptHistoryEntry> entries;
+    bool more;
+    if (!g_script_hash_index->LookupHistory(
+            script_hash, from_height, from_position,
+            DEFAULT_SCRIPT_HISTORY_PAGE_SIZE, entries, more)) {
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR,
+                       "Unable to read the script history");
+    }
+
+    switch (rf) {
+        case RetFormat::JSON: {
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK,
+                            ScriptHistoryToJSON(entries, more).write() + "\n");
+            return true;
+        }
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,
+                           "output format not found (available: json)");
+        }
+    }
+}
+
+static bool rest_spending_tx(Config &config, const std::any &context,
+                             HTTPRequest *req,
+                             const std::string &str_uri_part) {
+    if (!CheckWarmup(req)) {
+        return false;
+    }
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, str_uri_part);
+
+    // Path is <txid>-<n>
+    const size_t separator = param.find('-');
+    int32_t output_index;
+    if (separator == std::string::npos ||
+        !IsHex(param.substr(0, separator)) ||
+        !ParseInt32(param.substr(separator + 1), &output_index) ||
+        output_index < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST,
+                       "Invalid outpoint: " + SanitizeString(param));
+    }
+    TxId txid;
+    txid.SetHex(param.substr(0, separator));
+
+    if (!g_spent_index) {
+        return RESTERR(req, HTTP_NOT_FOUND, "Spent index is disabled");
+    }
+    g_spent_index->BlockUntilSyncedToCurrentChain();
+
+    const CTxMemPool *mempool = GetMemPool(context, req);
+    if (!mempool) {
+        return false;
+    }
+    const UniValue spender =
+        SpendingInputToJSON(mempool, COutPoint(txid, output_index));
+    if (spender.isNull()) {
+        return RESTERR(req, HTTP_NOT_FOUND, param + " is not spent");
+    }
+
+    switch (rf) {
+        case RetFormat::JSON: {
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, spender.write() + "\n");
+            return true;
+        }
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,
+                           "output format not found (available: json)");
+        }
+    }
+}
+
 static const struct {
     const char *prefix;
     bool (*handler)(Config &config, const std::any &context, HTTPRequest *req,
@@ -828,6 +943,8 @@ static const struct {
     {"/rest/headers/", rest_headers},
     {"/rest/getutxos", rest_getutxos},
     {"/rest/blockhashbyheight/", rest_blockhash_by_height},
+    {"/rest/scripthistory/", rest_script_history},
+    {"/rest/spendingtx/", rest_spending_tx},
 };
 
 void StartREST(const std::any &context) {
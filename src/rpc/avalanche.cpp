@@ -693,6 +693,17 @@ static RPCHelpMan getavalancheinfo() {
                      {RPCResult::Type::NUM, "pending_node_count",
                       "The number of avalanche nodes pending for a proof."},
                  }},
+                {RPCResult::Type::OBJ,
+                 "delegation_cache",
+                 "",
+                 {
+                     {RPCResult::Type::NUM, "hits",
+                      "The number of delegation levels which signature was "
+                      "found valid in the cache."},
+                     {RPCResult::Type::NUM, "misses",
+                      "The number of delegation levels which signature had to "
+                      "be verified."},
+                 }},
             },
         },
         RPCExamples{HelpExampleCli("getavalancheinfo", "") +
@@ -788,6 +799,13 @@ static RPCHelpMan getavalancheinfo() {
                 ret.pushKV("network", network);
             });
 
+            const avalanche::DelegationCacheStats delegationCacheStats =
+                avalanche::GetDelegationCacheStats();
+            UniValue delegationCache(UniValue::VOBJ);
+            delegationCache.pushKV("hits", delegationCacheStats.hits);
+            delegationCache.pushKV("misses", delegationCacheStats.misses);
+            ret.pushKV("delegation_cache", delegationCache);
+
             return ret;
         },
     };
@@ -826,6 +844,27 @@ static RPCHelpMan getavalanchepeerinfo() {
                          {RPCResult::Type::NUM, "nodeid",
                           "Node id, as returned by getpeerinfo"},
                      }},
+                    {RPCResult::Type::ARR,
+                     "node_stats",
+                     "The polling statistics of the nodes of this peer",
+                     {{
+                         RPCResult::Type::OBJ,
+                         "",
+                         "",
+                         {{
+                             {RPCResult::Type::NUM, "nodeid",
+                              "Node id, as returned by getpeerinfo"},
+                             {RPCResult::Type::NUM, "avg_response_time",
+                              "The moving average of the time it took the "
+                              "node to respond to our polls, in seconds. A "
+                              "poll that timed out accounts for the timeout "
+                              "duration."},
+                             {RPCResult::Type::NUM, "response_count",
+                              "The number of polls the node responded to"},
+                             {RPCResult::Type::NUM, "timeout_count",
+                              "The number of polls that timed out"},
+                         }},
+                     }}},
                 }},
             }},
         },
@@ -851,12 +890,24 @@ static RPCHelpMan getavalanchepeerinfo() {
                 obj.pushKV("proof", peer.proof->ToHex());
 
                 UniValue nodes(UniValue::VARR);
+                UniValue nodeStats(UniValue::VARR);
                 pm.forEachNode(peer, [&](const avalanche::Node &n) {
                     nodes.push_back(n.nodeid);
+
+                    UniValue stats(UniValue::VOBJ);
+                    stats.pushKV("nodeid", n.nodeid);
+                    stats.pushKV(
+                        "avg_response_time",
+                        std::chrono::duration<double>(n.avgResponseTime)
+                            .count());
+                    stats.pushKV("response_count", uint64_t(n.responseCount));
+                    stats.pushKV("timeout_count", uint64_t(n.timeoutCount));
+                    nodeStats.push_back(stats);
                 });
 
                 obj.pushKV("nodecount", uint64_t(peer.node_count));
                 obj.pushKV("node_list", nodes);
+                obj.pushKV("node_stats", nodeStats);
 
                 return obj;
             };
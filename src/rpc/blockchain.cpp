@@ -17,6 +17,8 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scripthashindex.h>
+#include <index/spentindex.h>
 #include <node/blockstorage.h>
 #include <node/coinstats.h>
 #include <node/context.h>
@@ -26,6 +28,8 @@
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
+#include <script/scriptcache.h>
+#include <script/sigcache.h>
 #include <streams.h>
 #include <txdb.h>
 #include <txmempool.h>
@@ -2067,6 +2071,55 @@ static RPCHelpMan getmempoolinfo() {
     };
 }
 
+static UniValue ValidationCacheStatsToJSON(const ValidationCacheStats &stats) {
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("hits", stats.hits);
+    obj.pushKV("misses", stats.misses);
+    obj.pushKV("evictions", stats.evictions);
+    return obj;
+}
+
+static RPCHelpMan getvalidationcacheinfo() {
+    const std::vector<RPCResult> cacheStatsResult{
+        {RPCResult::Type::NUM, "hits", "Number of lookups that found an entry"},
+        {RPCResult::Type::NUM, "misses",
+         "Number of lookups that found no entry"},
+        {RPCResult::Type::NUM, "evictions",
+         "Number of entries evicted, because they aged out or there was no "
+         "room left, before being used by a lookup"},
+    };
+
+    return RPCHelpMan{
+        "getvalidationcacheinfo",
+        "Returns the usage statistics of the caches that save the "
+        "verification of signatures and scripts already validated, since "
+        "startup.\n",
+        {},
+        RPCResult{RPCResult::Type::OBJ,
+                  "",
+                  "",
+                  {
+                      {RPCResult::Type::OBJ, "signature_cache",
+                       "The signature cache (see -maxsigcachesize)",
+                       cacheStatsResult},
+                      {RPCResult::Type::OBJ, "script_cache",
+                       "The script execution cache (see -maxscriptcachesize)",
+                       cacheStatsResult},
+                  }},
+        RPCExamples{HelpExampleCli("getvalidationcacheinfo", "") +
+                    HelpExampleRpc("getvalidationcacheinfo", "")},
+        [&](const RPCHelpMan &self, const Config &config,
+            const JSONRPCRequest &request) -> UniValue {
+            UniValue ret(UniValue::VOBJ);
+            ret.pushKV("signature_cache",
+                       ValidationCacheStatsToJSON(GetSignatureCacheStats()));
+            ret.pushKV("script_cache", ValidationCacheStatsToJSON(
+                                           GetScriptExecutionCacheStats()));
+            return ret;
+        },
+    };
+}
+
 static RPCHelpMan preciousblock() {
     return RPCHelpMan{
         "preciousblock",
@@ -3149,6 +3202,238 @@ static RPCHelpMan getblockfilter() {
     };
 }
 
+UniValue ScriptHistoryToJSON(const std::vector<ScriptHistoryEntry> &entries,
+                             bool more) {
+    UniValue history(UniValue::VARR);
+    for (const ScriptHistoryEntry &entry : entries) {
+        UniValue funded(UniValue::VARR);
+        for (uint32_t n : entry.funded_outputs) {
+            funded.push_back(uint64_t(n));
+        }
+        UniValue spent(UniValue::VARR);
+        for (uint32_t n : entry.spent_inputs) {
+            spent.push_back(uint64_t(n));
+        }
+
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.txid.GetHex());
+        obj.pushKV("height", entry.height);
+        obj.pushKV("position", uint64_t(entry.tx_position));
+        obj.pushKV("funded", funded);
+        obj.pushKV("spent", spent);
+        history.push_back(obj);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("history", history);
+    if (more) {
+        // Resume right after the last returned transaction.
+        UniValue next(UniValue::VOBJ);
+        next.pushKV("height", entries.back().height);
+        next.pushKV("position", uint64_t(entries.back().tx_position) + 1);
+        ret.pushKV("next", next);
+    }
+    return ret;
+}
+
+static RPCHelpMan getscripthistory() {
+    return RPCHelpMan{
+        "getscripthistory",
+        "Returns the confirmed transactions paying to or spending from a "
+        "script, in chain order.\n"
+        "Requires -scripthashindex. Long histories are returned one page at a "
+        "time, use the returned \"next\" cursor to get the next page.\n",
+        {
+            {"scripthash", RPCArg::Type::STR_HEX, RPCArg::Optional::NO,
+             "The SHA256 of the scriptPubKey, in the byte order used by "
+             "Electrum servers"},
+            {"fromheight", RPCArg::Type::NUM, /* default */ "0",
+             "Skip the transactions below this height"},
+            {"fromposition", RPCArg::Type::NUM, /* default */ "0",
+             "Skip the transactions of block fromheight before this position"},
+            {"count", RPCArg::Type::NUM,
+             /* default */ ToString(DEFAULT_SCRIPT_HISTORY_PAGE_SIZE),
+             "Maximum number of transactions to return"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ,
+            "",
+            "",
+            {
+                {RPCResult::Type::ARR,
+                 "history",
+                 "",
+                 {
+                     {RPCResult::Type::OBJ,
+                      "",
+                      "",
+                      {
+                          {RPCResult::Type::STR_HEX, "txid",
+                           "The transaction id"},
+                          {RPCResult::Type::NUM, "height",
+                           "The height of the block containing the "
+                           "transaction"},
+                          {RPCResult::Type::NUM, "position",
+                           "The position of the transaction in its block"},
+                          {RPCResult::Type::ARR,
+                           "funded",
+                           "The outputs paying to the script",
+                           {{RPCResult::Type::NUM, "", "The output index"}}},
+                          {RPCResult::Type::ARR,
+                           "spent",
+                           "The inputs spending from the script",
+                           {{RPCResult::Type::NUM, "", "The input index"}}},
+                      }},
+                 }},
+                {RPCResult::Type::OBJ,
+                 "next",
+                 /* optional */ true,
+                 "Cursor of the next page, only present if there are more "
+                 "transactions",
+                 {
+                     {RPCResult::Type::NUM, "height", "The fromheight to use"},
+                     {RPCResult::Type::NUM, "position",
+                      "The fromposition to use"},
+                 }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getscripthistory",
+                           "\"8b01df4e368ea28f8dc0423bcf7a4923e3a12d307c875e4"
+                           "7a0cfbf90b5c39161\"") +
+            HelpExampleRpc("getscripthistory",
+                           "\"8b01df4e368ea28f8dc0423bcf7a4923e3a12d307c875e4"
+                           "7a0cfbf90b5c39161\", 600000, 0, 100")},
+        [&](const RPCHelpMan &self, const Config &config,
+            const JSONRPCRequest &request) -> UniValue {
+            if (!g_script_hash_index) {
+                throw JSONRPCError(RPC_MISC_ERROR,
+                                   "Requires -scripthashindex to be enabled");
+            }
+
+            const uint256 script_hash =
+                ParseHashV(request.params[0], "scripthash");
+            const int from_height =
+                request.params[1].isNull() ? 0 : request.params[1].get_int();
+            const int from_position =
+                request.params[2].isNull() ? 0 : request.params[2].get_int();
+            const int count = request.params[3].isNull()
+                                  ? DEFAULT_SCRIPT_HISTORY_PAGE_SIZE
+                                  : request.params[3].get_int();
+            if (from_height < 0 || from_position < 0) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER,
+                                   "Negative cursor position");
+            }
+            if (count <= 0) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER,
+                                   "Count must be positive");
+            }
+
+            g_script_hash_index->BlockUntilSyncedToCurrentChain();
+
+            std::vector<ScriptHistoryEntry> entries;
+            bool more;
+            if (!g_script_hash_index->LookupHistory(script_hash, from_height,
+                                                    from_position, count,
+                                                    entries, more)) {
+                throw JSONRPCError(RPC_INTERNAL_ERROR,
+                                   "Unable to read the script history");
+            }
+
+            return ScriptHistoryToJSON(entries, more);
+        },
+    };
+}
+
+UniValue SpendingInputToJSON(const CTxMemPool *mempool,
+                             const COutPoint &outpoint) {
+    UniValue ret(UniValue::VOBJ);
+    if (mempool) {
+        LOCK(mempool->cs);
+        const CTransaction *tx = mempool->GetConflictTx(outpoint);
+        if (tx) {
+            for (size_t n = 0; n < tx->vin.size(); ++n) {
+                if (tx->vin[n].prevout == outpoint) {
+                    ret.pushKV("txid", tx->GetId().GetHex());
+                    ret.pushKV("vin", uint64_t(n));
+                    ret.pushKV("confirmed", false);
+                    return ret;
+                }
+            }
+        }
+    }
+
+    SpendingInput spender;
+    if (!g_spent_index || !g_spent_index->FindSpender(outpoint, spender)) {
+        return NullUniValue;
+    }
+    ret.pushKV("txid", spender.txid.GetHex());
+    ret.pushKV("vin", uint64_t(spender.input_index));
+    ret.pushKV("confirmed", true);
+    ret.pushKV("height", spender.height);
+    return ret;
+}
+
+static RPCHelpMan getspendingtx() {
+    return RPCHelpMan{
+        "getspendingtx",
+        "Returns the transaction input spending an outpoint.\n"
+        "Requires -spentindex. Returns null if the outpoint is unspent or "
+        "unknown.\n",
+        {
+            {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::NO,
+             "The transaction id"},
+            {"n", RPCArg::Type::NUM, RPCArg::Optional::NO, "vout number"},
+            {"include_mempool", RPCArg::Type::BOOL, /* default */ "true",
+             "Whether to look for a spender in the mempool as well"},
+        },
+        {
+            RPCResult{"If the outpoint is not known to be spent",
+                      RPCResult::Type::NONE, "", ""},
+            RPCResult{
+                "Otherwise",
+                RPCResult::Type::OBJ,
+                "",
+                "",
+                {
+                    {RPCResult::Type::STR_HEX, "txid",
+                     "The id of the spending transaction"},
+                    {RPCResult::Type::NUM, "vin",
+                     "The index of the spending input"},
+                    {RPCResult::Type::BOOL, "confirmed",
+                     "Whether the spending transaction is in the active "
+                     "chain, as opposed to the mempool"},
+                    {RPCResult::Type::NUM, "height", /* optional */ true,
+                     "The height of the block containing the spending "
+                     "transaction, only present if it is confirmed"},
+                }},
+        },
+        RPCExamples{HelpExampleCli("getspendingtx", "\"mytxid\" 1") +
+                    HelpExampleRpc("getspendingtx", "\"mytxid\", 1")},
+        [&](const RPCHelpMan &self, const Config &config,
+            const JSONRPCRequest &request) -> UniValue {
+            if (!g_spent_index) {
+                throw JSONRPCError(RPC_MISC_ERROR,
+                                   "Requires -spentindex to be enabled");
+            }
+
+            const TxId txid(ParseHashV(request.params[0], "txid"));
+            const int n = request.params[1].get_int();
+            if (n < 0) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER,
+                                   "Invalid output index");
+            }
+            const bool include_mempool =
+                request.params[2].isNull() || request.params[2].get_bool();
+
+            g_spent_index->BlockUntilSyncedToCurrentChain();
+
+            return SpendingInputToJSON(
+                include_mempool ? &EnsureAnyMemPool(request.context) : nullptr,
+                COutPoint(txid, n));
+        },
+    };
+}
+
 /**
  * Serialize the UTXO set to a file for loading elsewhere.
  *
@@ -3302,6 +3587,9 @@ void RegisterBlockchainRPCCommands(CRPCTable &t) {
         { "blockchain",         preciousblock,                     },
         { "blockchain",         scantxoutset,                      },
         { "blockchain",         getblockfilter,                    },
+        { "blockchain",         getscripthistory,                  },
+        { "blockchain",         getspendingtx,                     },
+        { "blockchain",         getvalidationcacheinfo,            },
 
         /* Not shown in help */
         { "hidden",             getfinalizedblockhash,             },
@@ -11,14 +11,17 @@
 #include <univalue.h>
 
 #include <any>
+#include <vector>
 
 class CBlock;
 class CBlockIndex;
 class CChainState;
+class COutPoint;
 class ChainstateManager;
 class CTxMemPool;
 class RPCHelpMan;
 struct NodeContext;
+struct ScriptHistoryEntry;
 
 extern RecursiveMutex cs_main;
 
@@ -52,6 +55,18 @@ UniValue blockheaderToJSON(const CBlockIndex *tip,
                            const CBlockIndex *blockindex)
     LOCKS_EXCLUDED(cs_main);
 
+/**
+ * Find the input spending an outpoint, in the mempool when one is given then
+ * in the spent index, and describe it as JSON. Returns null if the outpoint is
+ * not known to be spent.
+ */
+UniValue SpendingInputToJSON(const CTxMemPool *mempool,
+                             const COutPoint &outpoint);
+
+/** Page of the history of a script to JSON */
+UniValue ScriptHistoryToJSON(const std::vector<ScriptHistoryEntry> &entries,
+                             bool more);
+
 NodeContext &EnsureAnyNodeContext(const std::any &context);
 CTxMemPool &EnsureMemPool(const NodeContext &node);
 CTxMemPool &EnsureAnyMemPool(const std::any &context);
@@ -113,6 +113,11 @@ static const CRPCConvertParam vRPCConvertParams[] = {
     {"gettxoutproof", 0, "txids"},
     {"gettxoutsetinfo", 1, "hash_or_height"},
     {"gettxoutsetinfo", 2, "use_index"},
+    {"getscripthistory", 1, "fromheight"},
+    {"getscripthistory", 2, "fromposition"},
+    {"getscripthistory", 3, "count"},
+    {"getspendingtx", 1, "n"},
+    {"getspendingtx", 2, "include_mempool"},
     {"lockunspent", 0, "unlock"},
     {"lockunspent", 1, "transactions"},
     {"send", 0, "outputs"},
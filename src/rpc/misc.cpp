@@ -9,6 +9,8 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scripthashindex.h>
+#include <index/spentindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <key_io.h>
@@ -881,6 +883,16 @@ static RPCHelpMan getindexinfo() {
                                              index_name));
             }
 
+            if (g_script_hash_index) {
+                result.pushKVs(SummaryToJSON(
+                    g_script_hash_index->GetSummary(), index_name));
+            }
+
+            if (g_spent_index) {
+                result.pushKVs(
+                    SummaryToJSON(g_spent_index->GetSummary(), index_name));
+            }
+
             ForEachBlockFilterIndex([&result, &index_name](
                                         const BlockFilterIndex &index) {
                 result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
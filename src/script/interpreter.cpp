@@ -16,6 +16,9 @@
 #include <uint256.h>
 #include <util/bitmanip.h>
 
+#include <algorithm>
+#include <array>
+
 bool CastToBool(const valtype &vch) {
     for (size_t i = 0; i < vch.size(); i++) {
         if (vch[i] != 0) {
@@ -212,7 +215,7 @@ bool EvalScript(std::vector<valtype> &stack, const CScript &script,
     CScript::const_iterator pend = script.end();
     CScript::const_iterator pbegincodehash = script.begin();
     opcodetype opcode;
-    valtype vchPushValue;
+    Span<const uint8_t> pushData;
     ConditionStack vfExec;
     std::vector<valtype> altstack;
     set_error(serror, ScriptError::UNKNOWN);
@@ -229,10 +232,12 @@ bool EvalScript(std::vector<valtype> &stack, const CScript &script,
             //
             // Read instruction
             //
-            if (!script.GetOp(pc, opcode, vchPushValue)) {
+            // The pushed data is read in place and only copied once, when it
+            // is pushed onto the stack.
+            if (!script.GetOp(pc, opcode, pushData)) {
                 return set_error(serror, ScriptError::BAD_OPCODE);
             }
-            if (vchPushValue.size() > MAX_SCRIPT_ELEMENT_SIZE) {
+            if (pushData.size() > MAX_SCRIPT_ELEMENT_SIZE) {
                 return set_error(serror, ScriptError::PUSH_SIZE);
             }
 
@@ -248,10 +253,10 @@ bool EvalScript(std::vector<valtype> &stack, const CScript &script,
 
             if (fExec && 0 <= opcode && opcode <= OP_PUSHDATA4) {
                 if (fRequireMinimal &&
-                    !CheckMinimalPush(vchPushValue, opcode)) {
+                    !CheckMinimalPush(pushData, opcode)) {
                     return set_error(serror, ScriptError::MINIMALDATA);
                 }
-                stack.push_back(vchPushValue);
+                stack.emplace_back(pushData.begin(), pushData.end());
             } else if (fExec || (OP_IF <= opcode && opcode <= OP_ENDIF)) {
                 switch (opcode) {
                     //
@@ -1774,20 +1779,67 @@ bool GenericTransactionSignatureChecker<T>::CheckSequence(
 template class GenericTransactionSignatureChecker<CTransaction>;
 template class GenericTransactionSignatureChecker<CMutableTransaction>;
 
-bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey,
-                  uint32_t flags, const BaseSignatureChecker &checker,
-                  ScriptExecutionMetrics &metricsOut, ScriptError *serror) {
-    set_error(serror, ScriptError::UNKNOWN);
-
-    // If FORKID is enabled, we also ensure strict encoding.
-    if (flags & SCRIPT_ENABLE_SIGHASH_FORKID) {
-        flags |= SCRIPT_VERIFY_STRICTENC;
+/**
+ * Checks performed once the scripts have been evaluated successfully, with
+ * stackSize elements left on the stack.
+ */
+static bool VerifyFinalState(const CScript &scriptSig, size_t stackSize,
+                             uint32_t flags,
+                             const ScriptExecutionMetrics &metrics,
+                             ScriptExecutionMetrics &metricsOut,
+                             ScriptError *serror) {
+    // The CLEANSTACK check is only performed after potential P2SH evaluation,
+    // as the non-P2SH evaluation of a P2SH script will obviously not result in
+    // a clean stack (the P2SH inputs remain). The same holds for witness
+    // evaluation.
+    if ((flags & SCRIPT_VERIFY_CLEANSTACK) != 0) {
+        // Disallow CLEANSTACK without P2SH, as otherwise a switch
+        // CLEANSTACK->P2SH+CLEANSTACK would be possible, which is not a
+        // softfork (and P2SH should be one).
+        assert((flags & SCRIPT_VERIFY_P2SH) != 0);
+        if (stackSize != 1) {
+            return set_error(serror, ScriptError::CLEANSTACK);
+        }
     }
 
-    if ((flags & SCRIPT_VERIFY_SIGPUSHONLY) != 0 && !scriptSig.IsPushOnly()) {
-        return set_error(serror, ScriptError::SIG_PUSHONLY);
+    if (flags & SCRIPT_VERIFY_INPUT_SIGCHECKS) {
+        // This limit is intended for standard use, and is based on an
+        // examination of typical and historical standard uses.
+        // - allowing P2SH ECDSA multisig with compressed keys, which at an
+        // extreme (1-of-15) may have 15 SigChecks in ~590 bytes of scriptSig.
+        // - allowing Bare ECDSA multisig, which at an extreme (1-of-3) may have
+        // 3 sigchecks in ~72 bytes of scriptSig.
+        // - Since the size of an input is 41 bytes + length of scriptSig, then
+        // the most dense possible inputs satisfying this rule would be:
+        //   2 sigchecks and 26 bytes: 1/33.50 sigchecks/byte.
+        //   3 sigchecks and 69 bytes: 1/36.66 sigchecks/byte.
+        // The latter can be readily done with 1-of-3 bare multisignatures,
+        // however the former is not practically doable with standard scripts,
+        // so the practical density limit is 1/36.66.
+        static_assert(INT_MAX > MAX_SCRIPT_SIZE,
+                      "overflow sanity check on max script size");
+        static_assert(INT_MAX / 43 / 3 > MAX_OPS_PER_SCRIPT,
+                      "overflow sanity check on maximum possible sigchecks "
+                      "from sig+redeem+pub scripts");
+        if (int(scriptSig.size()) < metrics.nSigChecks * 43 - 60) {
+            return set_error(serror, ScriptError::INPUT_SIGCHECKS);
+        }
     }
 
+    metricsOut = metrics;
+    return set_success(serror);
+}
+
+/**
+ * Evaluate the scripts with the interpreter. The flags are expected to have
+ * been adjusted and the scriptSig checked for SIGPUSHONLY by the caller.
+ */
+static bool EvalScriptsWithInterpreter(const CScript &scriptSig,
+                                       const CScript &scriptPubKey,
+                                       uint32_t flags,
+                                       const BaseSignatureChecker &checker,
+                                       ScriptExecutionMetrics &metricsOut,
+                                       ScriptError *serror) {
     ScriptExecutionMetrics metrics = {};
 
     // scriptSig and scriptPubKey must be evaluated sequentially on the same
@@ -1852,44 +1904,214 @@ bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey,
         }
     }
 
-    // The CLEANSTACK check is only performed after potential P2SH evaluation,
-    // as the non-P2SH evaluation of a P2SH script will obviously not result in
-    // a clean stack (the P2SH inputs remain). The same holds for witness
-    // evaluation.
-    if ((flags & SCRIPT_VERIFY_CLEANSTACK) != 0) {
-        // Disallow CLEANSTACK without P2SH, as otherwise a switch
-        // CLEANSTACK->P2SH+CLEANSTACK would be possible, which is not a
-        // softfork (and P2SH should be one).
-        assert((flags & SCRIPT_VERIFY_P2SH) != 0);
-        if (stack.size() != 1) {
-            return set_error(serror, ScriptError::CLEANSTACK);
+    return VerifyFinalState(scriptSig, stack.size(), flags, metrics,
+                            metricsOut, serror);
+}
+
+/**
+ * Read the data pushed by a scriptSig made only of data pushes, calling fn
+ * on each of them. Returns false as soon as the scriptSig contains anything
+ * that could make EvalScript fail or push something else than the data as
+ * is, or if fn returns false.
+ */
+template <typename Fn>
+static bool ReadScriptSigPushes(const CScript &scriptSig, uint32_t flags,
+                                Fn &&fn) {
+    if (scriptSig.size() > MAX_SCRIPT_SIZE) {
+        return false;
+    }
+
+    const bool fRequireMinimal = (flags & SCRIPT_VERIFY_MINIMALDATA) != 0;
+    size_t count = 0;
+    CScript::const_iterator pc = scriptSig.begin();
+    while (pc < scriptSig.end()) {
+        opcodetype opcode;
+        Span<const uint8_t> data;
+        if (!scriptSig.GetOp(pc, opcode, data) || opcode > OP_PUSHDATA4 ||
+            data.size() > MAX_SCRIPT_ELEMENT_SIZE ||
+            (fRequireMinimal && !CheckMinimalPush(data, opcode)) ||
+            ++count > MAX_STACK_SIZE || !fn(data)) {
+            return false;
         }
     }
 
-    if (flags & SCRIPT_VERIFY_INPUT_SIGCHECKS) {
-        // This limit is intended for standard use, and is based on an
-        // examination of typical and historical standard uses.
-        // - allowing P2SH ECDSA multisig with compressed keys, which at an
-        // extreme (1-of-15) may have 15 SigChecks in ~590 bytes of scriptSig.
-        // - allowing Bare ECDSA multisig, which at an extreme (1-of-3) may have
-        // 3 sigchecks in ~72 bytes of scriptSig.
-        // - Since the size of an input is 41 bytes + length of scriptSig, then
-        // the most dense possible inputs satisfying this rule would be:
-        //   2 sigchecks and 26 bytes: 1/33.50 sigchecks/byte.
-        //   3 sigchecks and 69 bytes: 1/36.66 sigchecks/byte.
-        // The latter can be readily done with 1-of-3 bare multisignatures,
-        // however the former is not practically doable with standard scripts,
-        // so the practical density limit is 1/36.66.
-        static_assert(INT_MAX > MAX_SCRIPT_SIZE,
-                      "overflow sanity check on max script size");
-        static_assert(INT_MAX / 43 / 3 > MAX_OPS_PER_SCRIPT,
-                      "overflow sanity check on maximum possible sigchecks "
-                      "from sig+redeem+pub scripts");
-        if (int(scriptSig.size()) < metrics.nSigChecks * 43 - 60) {
-            return set_error(serror, ScriptError::INPUT_SIGCHECKS);
+    return true;
+}
+
+static bool Hash160Equals(Span<const uint8_t> data,
+                          CScript::const_iterator expected) {
+    uint160 hash;
+    CHash160().Write(data).Finalize(hash);
+    return std::equal(hash.begin(), hash.end(), expected);
+}
+
+/**
+ * Spend of a P2PKH output, with a scriptSig pushing a signature and a public
+ * key which hashes to the expected one. This is what the interpreter ends up
+ * doing for such a spend, without maintaining a stack. The spends which are
+ * not in this form are left to the interpreter, which is signaled by setting
+ * handled to false.
+ */
+static bool VerifyP2PKHSpend(const CScript &scriptSig,
+                             const CScript &scriptPubKey, uint32_t flags,
+                             const BaseSignatureChecker &checker,
+                             ScriptExecutionMetrics &metricsOut,
+                             ScriptError *serror, bool &handled) {
+    std::array<Span<const uint8_t>, 2> pushes;
+    size_t numPushes = 0;
+    handled = ReadScriptSigPushes(scriptSig, flags,
+                                  [&](Span<const uint8_t> data) {
+                                      if (numPushes >= pushes.size()) {
+                                          return false;
+                                      }
+                                      pushes[numPushes++] = data;
+                                      return true;
+                                  }) &&
+              numPushes == pushes.size() &&
+              Hash160Equals(pushes[1], scriptPubKey.begin() + 3);
+    if (!handled) {
+        return false;
+    }
+
+    const valtype vchSig(pushes[0].begin(), pushes[0].end());
+    const valtype vchPubKey(pushes[1].begin(), pushes[1].end());
+
+    ScriptExecutionMetrics metrics = {};
+    bool fSuccess = false;
+    if (!EvalChecksig(vchSig, vchPubKey, scriptPubKey.begin(),
+                      scriptPubKey.end(), flags, checker, metrics, serror,
+                      fSuccess)) {
+        // serror is set
+        return false;
+    }
+    if (!fSuccess) {
+        return set_error(serror, ScriptError::EVAL_FALSE);
+    }
+
+    // The stack is left with the result of the signature check only.
+    return VerifyFinalState(scriptSig, 1, flags, metrics, metricsOut, serror);
+}
+
+/**
+ * Spend of a P2SH output, with a scriptSig pushing the redeem script which
+ * hashes to the expected one. The stack the redeem script is evaluated on is
+ * built directly from the scriptSig, instead of evaluating both the scriptSig
+ * and the scriptPubKey first. The spends which are not in this form are left
+ * to the interpreter, which is signaled by setting handled to false.
+ */
+static bool VerifyP2SHSpend(const CScript &scriptSig,
+                            const CScript &scriptPubKey, uint32_t flags,
+                            const BaseSignatureChecker &checker,
+                            ScriptExecutionMetrics &metricsOut,
+                            ScriptError *serror, bool &handled) {
+    size_t numPushes = 0;
+    Span<const uint8_t> redeemScriptData;
+    handled = ReadScriptSigPushes(scriptSig, flags,
+                                  [&](Span<const uint8_t> data) {
+                                      numPushes++;
+                                      redeemScriptData = data;
+                                      return true;
+                                  }) &&
+              numPushes > 0 &&
+              Hash160Equals(redeemScriptData, scriptPubKey.begin() + 2);
+    if (!handled) {
+        return false;
+    }
+
+    const CScript redeemScript(redeemScriptData.begin(),
+                               redeemScriptData.end());
+
+    // The segwit recovery exemption is left to the interpreter.
+    if ((flags & SCRIPT_DISALLOW_SEGWIT_RECOVERY) == 0 &&
+        redeemScript.IsWitnessProgram()) {
+        handled = false;
+        return false;
+    }
+
+    // Read the scriptSig again to build the stack, all but the redeem script.
+    // This can't fail as it succeeded above.
+    std::vector<valtype> stack;
+    stack.reserve(numPushes - 1);
+    ReadScriptSigPushes(scriptSig, flags, [&](Span<const uint8_t> data) {
+        if (stack.size() + 1 < numPushes) {
+            stack.emplace_back(data.begin(), data.end());
         }
+        return true;
+    });
+
+    ScriptExecutionMetrics metrics = {};
+    if (!EvalScript(stack, redeemScript, flags, checker, metrics, serror)) {
+        // serror is set
+        return false;
+    }
+    if (stack.empty()) {
+        return set_error(serror, ScriptError::EVAL_FALSE);
+    }
+    if (!CastToBool(stack.back())) {
+        return set_error(serror, ScriptError::EVAL_FALSE);
     }
 
-    metricsOut = metrics;
-    return set_success(serror);
+    return VerifyFinalState(scriptSig, stack.size(), flags, metrics,
+                            metricsOut, serror);
+}
+
+/**
+ * Flags adjustments and checks common to all the ways of evaluating the
+ * scripts.
+ */
+static bool PrepareVerifyScript(const CScript &scriptSig, uint32_t &flags,
+                                ScriptError *serror) {
+    set_error(serror, ScriptError::UNKNOWN);
+
+    // If FORKID is enabled, we also ensure strict encoding.
+    if (flags & SCRIPT_ENABLE_SIGHASH_FORKID) {
+        flags |= SCRIPT_VERIFY_STRICTENC;
+    }
+
+    if ((flags & SCRIPT_VERIFY_SIGPUSHONLY) != 0 && !scriptSig.IsPushOnly()) {
+        return set_error(serror, ScriptError::SIG_PUSHONLY);
+    }
+
+    return true;
+}
+
+bool VerifyScript(const CScript &scriptSig, const CScript &scriptPubKey,
+                  uint32_t flags, const BaseSignatureChecker &checker,
+                  ScriptExecutionMetrics &metricsOut, ScriptError *serror) {
+    if (!PrepareVerifyScript(scriptSig, flags, serror)) {
+        return false;
+    }
+
+    // Most of the spends are of the standard templates, which are evaluated
+    // without going through the generic interpreter when possible. This gives
+    // the same results, including the errors and the sigchecks count.
+    bool handled = false;
+    bool ret = false;
+    if (scriptPubKey.IsPayToPubKeyHash()) {
+        ret = VerifyP2PKHSpend(scriptSig, scriptPubKey, flags, checker,
+                               metricsOut, serror, handled);
+    } else if ((flags & SCRIPT_VERIFY_P2SH) &&
+               scriptPubKey.IsPayToScriptHash()) {
+        ret = VerifyP2SHSpend(scriptSig, scriptPubKey, flags, checker,
+                              metricsOut, serror, handled);
+    }
+    if (handled) {
+        return ret;
+    }
+
+    return EvalScriptsWithInterpreter(scriptSig, scriptPubKey, flags, checker,
+                                      metricsOut, serror);
+}
+
+bool VerifyScriptWithInterpreter(const CScript &scriptSig,
+                                 const CScript &scriptPubKey, uint32_t flags,
+                                 const BaseSignatureChecker &checker,
+                                 ScriptExecutionMetrics &metricsOut,
+                                 ScriptError *serror) {
+    if (!PrepareVerifyScript(scriptSig, flags, serror)) {
+        return false;
+    }
+
+    return EvalScriptsWithInterpreter(scriptSig, scriptPubKey, flags, checker,
+                                      metricsOut, serror);
 }
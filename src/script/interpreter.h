@@ -112,6 +112,18 @@ static inline bool VerifyScript(const CScript &scriptSig,
                         serror);
 }
 
+/**
+ * Same as VerifyScript, but always evaluates the scripts with the
+ * interpreter, including when they match one of the standard templates that
+ * VerifyScript evaluates directly. The results are the same, this is the
+ * reference the template evaluation is tested against.
+ */
+bool VerifyScriptWithInterpreter(const CScript &scriptSig,
+                                 const CScript &scriptPubKey, uint32_t flags,
+                                 const BaseSignatureChecker &checker,
+                                 ScriptExecutionMetrics &metricsOut,
+                                 ScriptError *serror = nullptr);
+
 int FindAndDelete(CScript &script, const CScript &b);
 
 #endif // BITCOIN_SCRIPT_INTERPRETER_H
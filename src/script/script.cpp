@@ -265,7 +265,7 @@ std::string GetOpName(opcodetype opcode) {
     }
 }
 
-bool CheckMinimalPush(const std::vector<uint8_t> &data, opcodetype opcode) {
+bool CheckMinimalPush(Span<const uint8_t> data, opcodetype opcode) {
     // Excludes OP_1NEGATE, OP_1-16 since they are by definition minimal
     assert(0 <= opcode && opcode <= OP_PUSHDATA4);
     if (data.size() == 0) {
@@ -370,6 +370,13 @@ bool CScriptNum::MinimallyEncode(std::vector<uint8_t> &data) {
     return true;
 }
 
+bool CScript::IsPayToPubKeyHash() const {
+    // Extra-fast test for pay-to-pubkey-hash CScripts:
+    return (this->size() == 25 && (*this)[0] == OP_DUP &&
+            (*this)[1] == OP_HASH160 && (*this)[2] == 0x14 &&
+            (*this)[23] == OP_EQUALVERIFY && (*this)[24] == OP_CHECKSIG);
+}
+
 bool CScript::IsPayToScriptHash() const {
     // Extra-fast test for pay-to-script-hash CScripts:
     return (this->size() == 23 && (*this)[0] == OP_HASH160 &&
@@ -446,11 +453,9 @@ bool CScript::IsPushOnly() const {
 
 bool GetScriptOp(CScriptBase::const_iterator &pc,
                  CScriptBase::const_iterator end, opcodetype &opcodeRet,
-                 std::vector<uint8_t> *pvchRet) {
+                 Span<const uint8_t> &dataRet) {
     opcodeRet = OP_INVALIDOPCODE;
-    if (pvchRet) {
-        pvchRet->clear();
-    }
+    dataRet = {};
     if (pc >= end) {
         return false;
     }
@@ -488,8 +493,8 @@ bool GetScriptOp(CScriptBase::const_iterator &pc,
         if (end - pc < 0 || uint32_t(end - pc) < nSize) {
             return false;
         }
-        if (pvchRet) {
-            pvchRet->assign(pc, pc + nSize);
+        if (nSize > 0) {
+            dataRet = Span<const uint8_t>(&pc[0], nSize);
         }
         pc += nSize;
     }
@@ -498,6 +503,24 @@ bool GetScriptOp(CScriptBase::const_iterator &pc,
     return true;
 }
 
+bool GetScriptOp(CScriptBase::const_iterator &pc,
+                 CScriptBase::const_iterator end, opcodetype &opcodeRet,
+                 std::vector<uint8_t> *pvchRet) {
+    if (pvchRet) {
+        pvchRet->clear();
+    }
+
+    Span<const uint8_t> data;
+    if (!GetScriptOp(pc, end, opcodeRet, data)) {
+        return false;
+    }
+
+    if (pvchRet) {
+        pvchRet->assign(data.begin(), data.end());
+    }
+    return true;
+}
+
 bool CScript::HasValidOps() const {
     CScript::const_iterator it = begin();
     while (it < end()) {
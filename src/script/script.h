@@ -9,6 +9,7 @@
 #include <crypto/common.h>
 #include <prevector.h>
 #include <serialize.h>
+#include <span.h>
 
 #include <cassert>
 #include <climits>
@@ -204,7 +205,7 @@ std::string GetOpName(opcodetype opcode);
  * Check whether the given stack element data would be minimally pushed using
  * the given opcode.
  */
-bool CheckMinimalPush(const std::vector<uint8_t> &data, opcodetype opcode);
+bool CheckMinimalPush(Span<const uint8_t> data, opcodetype opcode);
 
 class scriptnum_error : public std::runtime_error {
 public:
@@ -425,6 +426,14 @@ typedef prevector<28, uint8_t> CScriptBase;
 bool GetScriptOp(CScriptBase::const_iterator &pc,
                  CScriptBase::const_iterator end, opcodetype &opcodeRet,
                  std::vector<uint8_t> *pvchRet);
+/**
+ * Same as above, but the pushed data is returned as a span over the script
+ * instead of being copied. It is only valid as long as the script is not
+ * modified.
+ */
+bool GetScriptOp(CScriptBase::const_iterator &pc,
+                 CScriptBase::const_iterator end, opcodetype &opcodeRet,
+                 Span<const uint8_t> &dataRet);
 
 /** Serialized script, used inside transaction inputs and outputs */
 class CScript : public CScriptBase {
@@ -503,6 +512,11 @@ public:
         return GetScriptOp(pc, end(), opcodeRet, &vchRet);
     }
 
+    bool GetOp(const_iterator &pc, opcodetype &opcodeRet,
+               Span<const uint8_t> &dataRet) const {
+        return GetScriptOp(pc, end(), opcodeRet, dataRet);
+    }
+
     bool GetOp(const_iterator &pc, opcodetype &opcodeRet) const {
         return GetScriptOp(pc, end(), opcodeRet, nullptr);
     }
@@ -525,6 +539,7 @@ public:
         return (opcodetype)(OP_1 + n - 1);
     }
 
+    bool IsPayToPubKeyHash() const;
     bool IsPayToScriptHash() const;
     bool IsCommitment(const std::vector<uint8_t> &data) const;
     bool IsWitnessProgram(int &version, std::vector<uint8_t> &program) const;
@@ -13,6 +13,8 @@
 #include <util/system.h>
 #include <validation.h>
 
+#include <atomic>
+
 /**
  * In future if many more values are added, it should be considered to
  * expand the element size to 64 bytes (with padding the spare space as
@@ -72,6 +74,8 @@ public:
 static CuckooCache::cache<ScriptCacheElement, ScriptCacheHasher>
     g_scriptExecutionCache;
 static CSHA256 g_scriptExecutionCacheHasher;
+static std::atomic<uint64_t> g_scriptExecutionCacheHits{0};
+static std::atomic<uint64_t> g_scriptExecutionCacheMisses{0};
 
 void InitScriptExecutionCache() {
     // Setup the salted hasher
@@ -114,6 +118,8 @@ bool IsKeyInScriptCache(ScriptCacheKey key, bool erase, int &nSigChecksOut) {
     ScriptCacheElement elem(key, 0);
     bool ret = g_scriptExecutionCache.get(elem, erase);
     nSigChecksOut = elem.nSigChecks;
+    (ret ? g_scriptExecutionCacheHits : g_scriptExecutionCacheMisses)
+        .fetch_add(1, std::memory_order_relaxed);
     return ret;
 }
 
@@ -125,3 +131,9 @@ void AddKeyInScriptCache(ScriptCacheKey key, int nSigChecks) {
     ScriptCacheElement elem(key, nSigChecks);
     g_scriptExecutionCache.insert(elem);
 }
+
+ValidationCacheStats GetScriptExecutionCacheStats() {
+    return {g_scriptExecutionCacheHits.load(std::memory_order_relaxed),
+            g_scriptExecutionCacheMisses.load(std::memory_order_relaxed),
+            g_scriptExecutionCache.evictions()};
+}
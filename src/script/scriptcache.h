@@ -8,6 +8,7 @@
 #include <array>
 #include <cstdint>
 
+#include <script/sigcache.h>
 #include <sync.h>
 
 // Actually declared in validation.cpp; can't include because of circular
@@ -65,4 +66,6 @@ bool IsKeyInScriptCache(ScriptCacheKey key, bool erase, int &nSigChecksOut)
 void AddKeyInScriptCache(ScriptCacheKey key, int nSigChecks)
     EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+ValidationCacheStats GetScriptExecutionCacheStats();
+
 #endif // BITCOIN_SCRIPT_SCRIPTCACHE_H
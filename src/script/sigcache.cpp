@@ -11,11 +11,20 @@
 #include <uint256.h>
 #include <util/system.h>
 
+#include <array>
+#include <atomic>
+
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
 namespace {
 
+/**
+ * The entries are spread over independently locked shards, so the script check
+ * threads and the mempool acceptance don't all contend on the same lock.
+ */
+static constexpr size_t SIGNATURE_CACHE_SHARDS = 16;
+
 /**
  * Valid signature cache, to avoid doing expensive ECDSA signature checking
  * twice for every transaction (once when accepted into memory pool, and
@@ -28,8 +37,22 @@ private:
     typedef CuckooCache::cache<CuckooCache::KeyOnly<uint256>,
                                SignatureCacheHasher>
         map_type;
-    map_type setValid;
-    boost::shared_mutex cs_sigcache;
+
+    // Aligned so the locks and counters of the shards don't share cache lines.
+    struct alignas(64) Shard {
+        map_type setValid;
+        boost::shared_mutex cs_sigcache;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+    };
+    std::array<Shard, SIGNATURE_CACHE_SHARDS> m_shards;
+
+    Shard &GetShard(const uint256 &entry) {
+        // The entries are salted hashes, so any of their bits can select the
+        // shard. The low bits of the last word only have a marginal effect on
+        // the location of the entry within the shard.
+        return m_shards[entry.begin()[28] % m_shards.size()];
+    }
 
 public:
     CSignatureCache() {
@@ -52,15 +75,38 @@ public:
     }
 
     bool Get(const uint256 &entry, const bool erase) {
-        boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
-        return setValid.contains(entry, erase);
+        Shard &shard = GetShard(entry);
+        boost::shared_lock<boost::shared_mutex> lock(shard.cs_sigcache);
+        const bool found = shard.setValid.contains(entry, erase);
+        (found ? shard.hits : shard.misses)
+            .fetch_add(1, std::memory_order_relaxed);
+        return found;
     }
 
     void Set(const uint256 &entry) {
-        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
-        setValid.insert(entry);
+        Shard &shard = GetShard(entry);
+        boost::unique_lock<boost::shared_mutex> lock(shard.cs_sigcache);
+        shard.setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n) {
+        uint32_t nElems = 0;
+        for (Shard &shard : m_shards) {
+            boost::unique_lock<boost::shared_mutex> lock(shard.cs_sigcache);
+            nElems += shard.setValid.setup_bytes(n / m_shards.size());
+        }
+        return nElems;
+    }
+
+    ValidationCacheStats GetStats() const {
+        ValidationCacheStats stats{};
+        for (const Shard &shard : m_shards) {
+            stats.hits += shard.hits.load(std::memory_order_relaxed);
+            stats.misses += shard.misses.load(std::memory_order_relaxed);
+            stats.evictions += shard.setValid.evictions();
+        }
+        return stats;
     }
-    uint32_t setup_bytes(size_t n) { return setValid.setup_bytes(n); }
 };
 
 /**
@@ -89,6 +135,10 @@ void InitSignatureCache() {
               (nElems * sizeof(uint256)) >> 20, nMaxCacheSize >> 20, nElems);
 }
 
+ValidationCacheStats GetSignatureCacheStats() {
+    return signatureCache.GetStats();
+}
+
 template <typename F>
 bool RunMemoizedCheck(const std::vector<uint8_t> &vchSig, const CPubKey &pubkey,
                       const uint256 &sighash, bool storeOrErase, const F &fun) {
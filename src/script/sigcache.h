@@ -8,6 +8,7 @@
 
 #include <script/interpreter.h>
 
+#include <cstdint>
 #include <vector>
 
 // DoS prevention: limit cache size to 32MB (over 1000000 entries on 64-bit
@@ -63,4 +64,14 @@ public:
 
 void InitSignatureCache();
 
+/** Usage statistics of a validation cache since startup. */
+struct ValidationCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    /** Entries evicted without having been used, see CuckooCache::cache. */
+    uint64_t evictions;
+};
+
+ValidationCacheStats GetSignatureCacheStats();
+
 #endif // BITCOIN_SCRIPT_SIGCACHE_H
@@ -28,6 +28,34 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorr_verify(
   const secp256k1_pubkey *pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/**
+ * Verify a batch of signatures created by secp256k1_schnorr_sign at once,
+ * which is faster than verifying them one by one.
+ * Returns: 1: all the signatures are correct, or the batch is empty
+ *          0: at least one signature is incorrect. The signatures need to be
+ *             verified one by one to figure out which ones.
+ * Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *          scratch:   scratch space used for the multi-multiplication. If
+ *                     NULL, the signatures are still verified together but the
+ *                     speedup is much lower.
+ * In:      sig64:     array of n_sigs pointers to the 64-byte signatures being
+ *                     verified (can only be NULL if n_sigs is 0)
+ *          msghash32: array of n_sigs pointers to the 32-byte message hashes
+ *                     being verified (can only be NULL if n_sigs is 0). The
+ *                     same caveat as for secp256k1_schnorr_verify applies.
+ *          pubkeys:   array of n_sigs pointers to the public keys to verify
+ *                     with (can only be NULL if n_sigs is 0)
+ *          n_sigs:    the number of signatures in the batch
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorr_verify_batch(
+  const secp256k1_context* ctx,
+  secp256k1_scratch_space *scratch,
+  const unsigned char *const *sig64,
+  const unsigned char *const *msghash32,
+  const secp256k1_pubkey *const *pubkeys,
+  size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 /**
  * Create a signature using a custom EC-Schnorr-SHA256 construction. It
  * produces non-malleable 64-byte signatures which support batch validation,
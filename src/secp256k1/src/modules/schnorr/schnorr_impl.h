@@ -98,6 +98,158 @@ static int secp256k1_schnorr_sig_verify(
     return 1;
 }
 
+typedef struct {
+    const secp256k1_context *ctx;
+    const unsigned char *seed32;
+    const unsigned char *const *sig64;
+    const unsigned char *const *msg32;
+    const secp256k1_pubkey *const *pubkeys;
+} secp256k1_schnorr_verify_batch_data;
+
+/**
+ * Compute the randomizer a_i the i-th equation of a batch is multiplied by.
+ * The first one is 1, the others are derived from a seed committing to the
+ * whole batch so they can't be predicted by whoever crafted the signatures.
+ */
+static void secp256k1_schnorr_batch_randomizer(
+    secp256k1_scalar *a,
+    const unsigned char *seed32,
+    size_t i
+) {
+    secp256k1_sha256 sha;
+    unsigned char buf[32];
+    int j;
+
+    if (i == 0) {
+        secp256k1_scalar_set_int(a, 1);
+        return;
+    }
+
+    for (j = 0; j < 8; j++) {
+        buf[j] = (i >> (56 - 8 * j)) & 0xff;
+    }
+
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, seed32, 32);
+    secp256k1_sha256_write(&sha, buf, 8);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_set_b32(a, buf, NULL);
+}
+
+/**
+ * Provide the points of the batch equation to the multi-multiplication:
+ * R_i with a_i for even indices and P_i with a_i * e_i for odd ones.
+ */
+static int secp256k1_schnorr_verify_batch_ecmult_callback(
+    secp256k1_scalar *sc,
+    secp256k1_ge *pt,
+    size_t idx,
+    void *cbdata
+) {
+    const secp256k1_schnorr_verify_batch_data *data = (const secp256k1_schnorr_verify_batch_data *)cbdata;
+    size_t i = idx / 2;
+    secp256k1_scalar e;
+    secp256k1_fe Rx;
+
+    secp256k1_schnorr_batch_randomizer(sc, data->seed32, i);
+
+    if (idx % 2 == 0) {
+        /* Decompress R with a quadratic residue y. */
+        if (!secp256k1_fe_set_b32(&Rx, data->sig64[i])) {
+            return 0;
+        }
+
+        return secp256k1_ge_set_xquad(pt, &Rx);
+    }
+
+    if (!secp256k1_pubkey_load(data->ctx, pt, data->pubkeys[i])) {
+        return 0;
+    }
+
+    secp256k1_schnorr_compute_e(&e, data->sig64[i], pt, data->msg32[i]);
+    secp256k1_scalar_mul(sc, sc, &e);
+    return 1;
+}
+
+/**
+ * Batch verification, using option 2 above for all the signatures at once:
+ * the batch is valid if sum(a_i * R_i + (a_i * e_i) * P_i)
+ * - sum(a_i * s_i) * G == 0, with a_i pseudo random scalars derived from all
+ * the inputs. If any signature is invalid, the sum is not zero but with
+ * negligible probability.
+ */
+static int secp256k1_schnorr_sig_verify_batch(
+    const secp256k1_context* ctx,
+    secp256k1_scratch *scratch,
+    const unsigned char *const *sig64,
+    const unsigned char *const *msg32,
+    const secp256k1_pubkey *const *pubkeys,
+    size_t n_sigs
+) {
+    secp256k1_schnorr_verify_batch_data data;
+    secp256k1_sha256 sha;
+    unsigned char seed32[32];
+    unsigned char buf[33];
+    size_t size;
+    secp256k1_scalar sum, a, s;
+    secp256k1_ge P;
+    secp256k1_gej Rj;
+    int overflow;
+    size_t i;
+
+    if (n_sigs == 0) {
+        return 1;
+    }
+
+    /* There are 2 points per signature. */
+    if (n_sigs > SIZE_MAX / 2) {
+        return 0;
+    }
+
+    /* Derive the seed for the randomizers from the whole batch. */
+    secp256k1_sha256_initialize(&sha);
+    for (i = 0; i < n_sigs; i++) {
+        if (!secp256k1_pubkey_load(ctx, &P, pubkeys[i])) {
+            return 0;
+        }
+
+        secp256k1_sha256_write(&sha, sig64[i], 64);
+        secp256k1_sha256_write(&sha, msg32[i], 32);
+        size = 0;
+        secp256k1_eckey_pubkey_serialize(&P, buf, &size, 1);
+        VERIFY_CHECK(size == 33);
+        secp256k1_sha256_write(&sha, buf, 33);
+    }
+    secp256k1_sha256_finalize(&sha, seed32);
+
+    /* Compute -sum(a_i * s_i), the scalar to multiply G by. */
+    secp256k1_scalar_set_int(&sum, 0);
+    for (i = 0; i < n_sigs; i++) {
+        overflow = 0;
+        secp256k1_scalar_set_b32(&s, sig64[i] + 32, &overflow);
+        if (overflow) {
+            return 0;
+        }
+
+        secp256k1_schnorr_batch_randomizer(&a, seed32, i);
+        secp256k1_scalar_mul(&s, &s, &a);
+        secp256k1_scalar_add(&sum, &sum, &s);
+    }
+    secp256k1_scalar_negate(&sum, &sum);
+
+    data.ctx = ctx;
+    data.seed32 = seed32;
+    data.sig64 = sig64;
+    data.msg32 = msg32;
+    data.pubkeys = pubkeys;
+    if (!secp256k1_ecmult_multi_var(&ctx->error_callback, &ctx->ecmult_ctx, scratch, &Rj, &sum,
+                                    secp256k1_schnorr_verify_batch_ecmult_callback, (void *)&data, 2 * n_sigs)) {
+        return 0;
+    }
+
+    return secp256k1_gej_is_infinity(&Rj);
+}
+
 static int secp256k1_schnorr_compute_e(
     secp256k1_scalar* e,
     const unsigned char *r,
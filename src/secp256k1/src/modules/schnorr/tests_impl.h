@@ -78,6 +78,79 @@ void test_schnorr_sign_verify(void) {
 
 #undef SIG_COUNT
 
+#define BATCH_SIZE 64
+
+void test_schnorr_verify_batch(void) {
+    unsigned char privkey[32];
+    unsigned char msg32[BATCH_SIZE][32];
+    unsigned char sig64[BATCH_SIZE][64];
+    secp256k1_pubkey pubkey[BATCH_SIZE];
+    const unsigned char *sig_ptr[BATCH_SIZE];
+    const unsigned char *msg_ptr[BATCH_SIZE];
+    const secp256k1_pubkey *pubkey_ptr[BATCH_SIZE];
+    secp256k1_scratch_space *scratch;
+    size_t n, i;
+
+    for (i = 0; i < BATCH_SIZE; i++) {
+        secp256k1_scalar key;
+        random_scalar_order_test(&key);
+        secp256k1_scalar_get_b32(privkey, &key);
+        secp256k1_testrand256_test(msg32[i]);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey[i], privkey) == 1);
+        CHECK(secp256k1_schnorr_sign(ctx, sig64[i], msg32[i], privkey, NULL, NULL) == 1);
+        sig_ptr[i] = sig64[i];
+        msg_ptr[i] = msg32[i];
+        pubkey_ptr[i] = &pubkey[i];
+    }
+
+    /* Large enough for Pippenger, and too small for a single Strauss batch
+     * so that several batches get summed up. */
+    scratch = secp256k1_scratch_space_create(ctx, 8192);
+    CHECK(scratch != NULL);
+
+    /* Empty batches are valid. */
+    CHECK(secp256k1_schnorr_verify_batch(ctx, scratch, NULL, NULL, NULL, 0) == 1);
+
+    for (n = 1; n <= BATCH_SIZE; n *= 2) {
+        size_t pos;
+        int mod;
+
+        CHECK(secp256k1_schnorr_verify_batch(ctx, scratch, sig_ptr, msg_ptr, pubkey_ptr, n) == 1);
+        CHECK(secp256k1_schnorr_verify_batch(ctx, NULL, sig_ptr, msg_ptr, pubkey_ptr, n) == 1);
+
+        /* Tampering with any signature invalidates the whole batch. */
+        i = secp256k1_testrand_int(n);
+        pos = secp256k1_testrand_bits(6);
+        mod = 1 + secp256k1_testrand_int(255);
+        sig64[i][pos] ^= mod;
+        CHECK(secp256k1_schnorr_verify_batch(ctx, scratch, sig_ptr, msg_ptr, pubkey_ptr, n) == 0);
+        CHECK(secp256k1_schnorr_verify_batch(ctx, NULL, sig_ptr, msg_ptr, pubkey_ptr, n) == 0);
+        sig64[i][pos] ^= mod;
+
+        /* So does verifying a signature against the wrong message. */
+        msg_ptr[i] = msg32[(i + 1) % BATCH_SIZE];
+        CHECK(secp256k1_schnorr_verify_batch(ctx, scratch, sig_ptr, msg_ptr, pubkey_ptr, n) == 0);
+        msg_ptr[i] = msg32[i];
+
+        /* Two invalid signatures can't cancel each other out. */
+        if (n > 1) {
+            sig_ptr[0] = sig64[1];
+            sig_ptr[1] = sig64[0];
+            CHECK(secp256k1_schnorr_verify_batch(ctx, scratch, sig_ptr, msg_ptr, pubkey_ptr, n) == 0);
+            sig_ptr[0] = sig64[0];
+            sig_ptr[1] = sig64[1];
+        }
+    }
+
+    /* s must be lower than the group order. */
+    memset(sig64[0] + 32, 0xff, 32);
+    CHECK(secp256k1_schnorr_verify_batch(ctx, scratch, sig_ptr, msg_ptr, pubkey_ptr, BATCH_SIZE) == 0);
+
+    secp256k1_scratch_space_destroy(ctx, scratch);
+}
+
+#undef BATCH_SIZE
+
 void run_schnorr_compact_test(void) {
     {
         /* Test vector 1 */
@@ -516,6 +589,7 @@ void run_schnorr_tests(void) {
     }
 
     test_schnorr_sign_verify();
+    test_schnorr_verify_batch();
     run_schnorr_compact_test();
 }
 
@@ -115,6 +115,48 @@ public:
         return addItem(idit->second, item);
     }
 
+    /**
+     * Same as matchKnownItem, but the item is only built by calling getItem()
+     * if its shortid matches. This avoids building the items that are not part
+     * of the message when matching against a large set of known items.
+     */
+    template <typename GetItem>
+    int matchKnownItemLazy(uint64_t shortid, GetItem &&getItem) {
+        auto idit = shortIdIndexMap.find(shortid);
+        if (idit == shortIdIndexMap.end()) {
+            return 0;
+        }
+
+        return addItem(idit->second, getItem());
+    }
+
+    /**
+     * Match a batch of known items whose shortids were computed together, e.g.
+     * with SipHashUint256Batch, until all the shortids are matched.
+     * getItem(i) builds the i-th item of the batch and is only called if its
+     * shortid matches.
+     *
+     * @param[in]     shortids     The shortids of the items of the batch
+     * @param[in]     count        The number of items in the batch
+     * @param[in,out] matchedCount The number of items matched so far, which is
+     *                             updated as per matchKnownItem
+     *
+     * @return bool True if all the shortids are matched.
+     */
+    template <typename GetItem>
+    bool matchKnownItemsLazy(const uint64_t *shortids, size_t count,
+                             size_t &matchedCount, GetItem &&getItem) {
+        for (size_t i = 0; i < count; i++) {
+            matchedCount +=
+                matchKnownItemLazy(shortids[i], [&] { return getItem(i); });
+            if (matchedCount == getShortIdCount()) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     const ItemType &getItem(size_t index) const {
         assert(index < itemsAvailable.size());
 
@@ -7,6 +7,7 @@
 #include <config.h>
 #include <consensus/validation.h>
 #include <index/blockfilterindex.h>
+#include <index/txindex.h>
 #include <miner.h>
 #include <pow/pow.h>
 #include <script/standard.h>
@@ -298,6 +299,103 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync,
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_shared_sync, TestChain100Setup) {
+    // Both indexes catch up at the same time and share the block reads.
+    BlockFilterIndex filter_index(BlockFilterType::BASIC, 1 << 20, true);
+    TxIndex txindex(1 << 20, true);
+
+    filter_index.Start(m_node.chainman->ActiveChainstate());
+    txindex.Start(m_node.chainman->ActiveChainstate());
+
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!filter_index.BlockUntilSyncedToCurrentChain() ||
+           !txindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+
+    {
+        LOCK(cs_main);
+        uint256 last_header;
+        for (const CBlockIndex *block_index =
+                 m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header);
+        }
+    }
+
+    for (const auto &txn : m_coinbase_txns) {
+        CTransactionRef tx_disk;
+        BlockHash block_hash;
+        BOOST_CHECK(txindex.FindTx(txn->GetId(), block_hash, tx_disk));
+    }
+
+    filter_index.Interrupt();
+    txindex.Interrupt();
+    filter_index.Stop();
+    txindex.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_range_from_disk,
+                        TestChain100Setup) {
+    {
+        BlockFilterIndex filter_index(BlockFilterType::BASIC, 1 << 20,
+                                      /* f_memory */ false, /* f_wipe */ true);
+        filter_index.Start(m_node.chainman->ActiveChainstate());
+
+        constexpr int64_t timeout_ms = 10 * 1000;
+        int64_t time_start = GetTimeMillis();
+        while (!filter_index.BlockUntilSyncedToCurrentChain()) {
+            BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+            UninterruptibleSleep(std::chrono::milliseconds{100});
+        }
+
+        filter_index.Interrupt();
+        filter_index.Stop();
+        SyncWithValidationInterfaceQueue();
+    }
+
+    // A reopened index has nothing cached, so the filters are read back from
+    // the flat files.
+    BlockFilterIndex filter_index(BlockFilterType::BASIC, 1 << 20);
+    filter_index.Start(m_node.chainman->ActiveChainstate());
+    BOOST_CHECK(filter_index.BlockUntilSyncedToCurrentChain());
+
+    const CBlockIndex *tip =
+        WITH_LOCK(cs_main, return m_node.chainman->ActiveTip());
+    for (int start_height : {tip->nHeight, 50, 0}) {
+        std::vector<BlockFilter> filters;
+        BOOST_CHECK(filter_index.LookupFilterRange(start_height, tip, filters));
+        BOOST_REQUIRE_EQUAL(filters.size(), tip->nHeight - start_height + 1U);
+
+        for (const BlockFilter &filter : filters) {
+            const CBlockIndex *block_index = WITH_LOCK(
+                cs_main, return m_node.chainman->m_blockman.LookupBlockIndex(
+                             filter.GetBlockHash()));
+            BOOST_REQUIRE(block_index);
+            BOOST_CHECK_EQUAL(block_index->nHeight,
+                              start_height + (&filter - filters.data()));
+
+            BlockFilter expected_filter;
+            BOOST_CHECK(ComputeFilter(BlockFilterType::BASIC, block_index,
+                                      expected_filter));
+            BOOST_CHECK(filter.GetEncodedFilter() ==
+                        expected_filter.GetEncodedFilter());
+        }
+    }
+
+    std::vector<BlockFilter> filters;
+    BOOST_CHECK(!filter_index.LookupFilterRange(tip->nHeight + 1, tip, filters));
+    BOOST_CHECK(!filter_index.LookupFilterRange(-1, tip, filters));
+
+    filter_index.Interrupt();
+    filter_index.Stop();
+    SyncWithValidationInterfaceQueue();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup) {
     BlockFilterIndex *filter_index;
 
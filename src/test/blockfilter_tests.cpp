@@ -7,6 +7,7 @@
 #include <core_io.h>
 #include <serialize.h>
 #include <streams.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <test/data/blockfilters.json.h>
@@ -40,6 +41,98 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(golombrice_coder_test) {
+    for (uint8_t P : {0, 1, 7, 19, 20, 32}) {
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 1000; ++i) {
+            // Mostly small quotients, with a few very large ones.
+            uint64_t value = InsecureRandBits(P + 3);
+            if (InsecureRandRange(50) == 0) {
+                value += InsecureRandRange(300) << P;
+            }
+            values.push_back(value);
+        }
+
+        std::vector<uint8_t> expected;
+        {
+            CVectorWriter stream(SER_NETWORK, 0, expected, 0);
+            BitStreamWriter<CVectorWriter> bitwriter(stream);
+            for (uint64_t value : values) {
+                GolombRiceEncode(bitwriter, P, value);
+            }
+        }
+
+        std::vector<uint8_t> encoded;
+        {
+            GolombRiceEncoder encoder(encoded);
+            for (uint64_t value : values) {
+                encoder.Encode(P, value);
+            }
+        }
+        BOOST_CHECK(encoded == expected);
+
+        GolombRiceDecoder decoder(encoded);
+        for (uint64_t value : values) {
+            BOOST_CHECK_EQUAL(decoder.Decode(P), value);
+        }
+        BOOST_CHECK_EQUAL(decoder.GetBytesRead(), encoded.size());
+
+        // Decoding past the end of the data fails.
+        GolombRiceDecoder truncated(
+            Span<const uint8_t>(encoded).first(encoded.size() / 2));
+        BOOST_CHECK_THROW(
+            {
+                for (size_t i = 0; i < values.size(); ++i) {
+                    truncated.Decode(P);
+                }
+            },
+            std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(gcsfilter_large_set_test) {
+    // Large enough for the hashed set to be radix sorted.
+    GCSFilter::ElementSet elements;
+    for (int i = 0; i < 5000; ++i) {
+        GCSFilter::Element element(32);
+        element[0] = i;
+        element[1] = i >> 8;
+        elements.insert(std::move(element));
+    }
+
+    const GCSFilter::Params params(InsecureRandBits(64), InsecureRandBits(64),
+                                   BASIC_FILTER_P, BASIC_FILTER_M);
+    GCSFilter filter(params, elements);
+
+    // Decode the filter with the bit stream coder and encode it back.
+    std::vector<uint8_t> expected;
+    {
+        VectorReader reader(SER_NETWORK, 0, filter.GetEncoded(), 0);
+        BOOST_CHECK_EQUAL(ReadCompactSize(reader), elements.size());
+        BitStreamReader<VectorReader> bitreader(reader);
+
+        CVectorWriter stream(SER_NETWORK, 0, expected, 0);
+        WriteCompactSize(stream, elements.size());
+        BitStreamWriter<CVectorWriter> bitwriter(stream);
+        for (size_t i = 0; i < elements.size(); ++i) {
+            GolombRiceEncode(bitwriter, params.m_P,
+                             GolombRiceDecode(bitreader, params.m_P));
+        }
+    }
+    BOOST_CHECK(filter.GetEncoded() == expected);
+
+    // Matching relies on the hashed set being sorted.
+    for (const auto &element : elements) {
+        BOOST_CHECK(filter.Match(element));
+    }
+    BOOST_CHECK(filter.MatchAny(elements));
+
+    // The encoding must round trip, and excess data is rejected.
+    BOOST_CHECK(GCSFilter(params, expected).GetEncoded() == expected);
+    expected.push_back(0);
+    BOOST_CHECK_THROW(GCSFilter(params, expected), std::ios_base::failure);
+}
+
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor) {
     GCSFilter filter;
     BOOST_CHECK_EQUAL(filter.GetN(), 0U);
@@ -1073,6 +1073,39 @@ BOOST_AUTO_TEST_CASE(sha256d64) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256_multi) {
+    for (int count = 0; count <= 40; ++count) {
+        std::vector<std::vector<uint8_t>> messages(count);
+        std::vector<const uint8_t *> inputs;
+        std::vector<size_t> sizes;
+        for (std::vector<uint8_t> &message : messages) {
+            // Cover the sizes around the chunk and padding boundaries, and
+            // messages of very different sizes hashed together.
+            const size_t size = InsecureRandBool() ? InsecureRandRange(130)
+                                                   : InsecureRandRange(1000);
+            message = g_insecure_rand_ctx.randbytes(size);
+            inputs.push_back(message.data());
+            sizes.push_back(message.size());
+        }
+
+        std::vector<uint8_t> expected(32 * count), expectedDouble(32 * count);
+        for (int i = 0; i < count; ++i) {
+            CSHA256()
+                .Write(messages[i].data(), messages[i].size())
+                .Finalize(expected.data() + 32 * i);
+            CHash256()
+                .Write(messages[i])
+                .Finalize({expectedDouble.data() + 32 * i, 32});
+        }
+
+        std::vector<uint8_t> out(32 * count);
+        SHA256Multi(out.data(), inputs.data(), sizes.data(), count);
+        BOOST_CHECK(out == expected);
+        SHA256DMulti(out.data(), inputs.data(), sizes.data(), count);
+        BOOST_CHECK(out == expectedDouble);
+    }
+}
+
 static void TestSHA3_256(const std::string &input, const std::string &output) {
     const auto in_bytes = ParseHex(input);
     const auto out_bytes = ParseHex(output);
@@ -1912,4 +1945,45 @@ BOOST_AUTO_TEST_CASE(muhash_tests) {
         "3a31e6903aff0de9f62f9a9f7f8b861de76ce2cda09822b90014319ae5dc2271");
 }
 
+BOOST_AUTO_TEST_CASE(muhash_batch_tests) {
+    std::vector<std::vector<uint8_t>> elements;
+    for (size_t i = 0; i < 100; ++i) {
+        elements.push_back(
+            g_insecure_rand_ctx.randbytes(1 + InsecureRandRange(100)));
+    }
+    const std::vector<Span<const uint8_t>> spans(elements.begin(),
+                                                 elements.end());
+
+    // Insert all the elements, then remove the first half of them.
+    MuHash3072 one_by_one;
+    for (const std::vector<uint8_t> &element : elements) {
+        one_by_one.Insert(element);
+    }
+    for (size_t i = 0; i < elements.size() / 2; ++i) {
+        one_by_one.Remove(elements[i]);
+    }
+
+    MuHash3072 batched;
+    batched.InsertBatch(spans).RemoveBatch(
+        MakeSpan(spans).first(elements.size() / 2));
+
+    uint256 out1, out2;
+    one_by_one.Finalize(out1);
+    batched.Finalize(out2);
+    BOOST_CHECK_EQUAL(out1, out2);
+
+    // Same as inserting the second half only.
+    MuHash3072 second_half;
+    second_half.InsertBatch(MakeSpan(spans).subspan(elements.size() / 2));
+    second_half.Finalize(out2);
+    BOOST_CHECK_EQUAL(out1, out2);
+
+    // An empty batch leaves the set unchanged.
+    MuHash3072 empty;
+    empty.InsertBatch({}).RemoveBatch({});
+    empty.Finalize(out1);
+    MuHash3072().Finalize(out2);
+    BOOST_CHECK_EQUAL(out1, out2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
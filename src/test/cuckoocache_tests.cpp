@@ -477,6 +477,37 @@ BOOST_AUTO_TEST_CASE(cuckoocache_generations) {
     test_cache_generations<CuckooCacheMap>();
 }
 
+template <typename Cache> static void test_cache_evictions() {
+    SeedInsecureRand(SeedRand::ZEROS);
+
+    // 4k cache.
+    Cache set{};
+    const uint32_t size = set.setup_bytes(4 * 1024);
+    BOOST_CHECK_EQUAL(set.evictions(), 0);
+
+    // The entries which are erased by a lookup are not evicted.
+    for (uint32_t i = 0; i < 10 * size; ++i) {
+        const uint256 h = InsecureRand256();
+        set.insert(h);
+        BOOST_CHECK(set.contains(h, true));
+    }
+    BOOST_CHECK_EQUAL(set.evictions(), 0);
+
+    // Filling the cache way over its capacity evicts at least the entries
+    // that don't fit, and at most all of them.
+    const uint32_t n_insert = 10 * size;
+    for (uint32_t i = 0; i < n_insert; ++i) {
+        set.insert(InsecureRand256());
+    }
+    BOOST_CHECK_GE(set.evictions(), n_insert - size);
+    BOOST_CHECK_LE(set.evictions(), n_insert);
+}
+
+BOOST_AUTO_TEST_CASE(cuckoocache_evictions) {
+    test_cache_evictions<CuckooCacheSet>();
+    test_cache_evictions<CuckooCacheMap>();
+}
+
 BOOST_AUTO_TEST_CASE(cuckoocache_map_element) {
     // Check the hash is parsed properly.
     uint256 hash = uint256S(
@@ -3,10 +3,12 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <script/script.h>
+#include <span.h>
 #include <test/fuzz/FuzzedDataProvider.h>
 #include <test/fuzz/fuzz.h>
 #include <test/fuzz/util.h>
 
+#include <cassert>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -60,6 +62,30 @@ void test_one_input(const std::vector<uint8_t> &buffer) {
                     std::vector<uint8_t> program;
                     (void)script.IsWitnessProgram(version, program);
                 }
+                {
+                    // Reading the pushed data in place must match copying
+                    // it, as the interpreter relies on the former.
+                    CScript::const_iterator pc = script.begin();
+                    CScript::const_iterator pc_span = script.begin();
+                    while (true) {
+                        opcodetype opcode;
+                        std::vector<uint8_t> data;
+                        const bool ret = script.GetOp(pc, opcode, data);
+
+                        opcodetype opcode_span;
+                        Span<const uint8_t> data_span;
+                        const bool ret_span =
+                            script.GetOp(pc_span, opcode_span, data_span);
+
+                        assert(ret == ret_span);
+                        assert(pc == pc_span);
+                        assert(opcode == opcode_span);
+                        assert(Span<const uint8_t>(data) == data_span);
+                        if (!ret) {
+                            break;
+                        }
+                    }
+                }
                 break;
             }
         }
@@ -0,0 +1,136 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <hash.h>
+#include <pubkey.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <script/script_error.h>
+
+#include <test/fuzz/FuzzedDataProvider.h>
+#include <test/fuzz/fuzz.h>
+#include <test/fuzz/util.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+void initialize() {
+    static const ECCVerifyHandle verify_handle;
+}
+
+namespace {
+/**
+ * The signature checks succeed depending on the signature and public key
+ * only, so both evaluations of the same scripts see the same results.
+ */
+class DeterministicSignatureChecker : public BaseSignatureChecker {
+    const uint8_t m_salt;
+
+public:
+    explicit DeterministicSignatureChecker(uint8_t salt) : m_salt(salt) {}
+
+    bool CheckSig(const std::vector<uint8_t> &vchSigIn,
+                  const std::vector<uint8_t> &vchPubKey,
+                  const CScript &scriptCode, uint32_t flags) const override {
+        uint8_t acc = m_salt;
+        for (uint8_t b : vchSigIn) {
+            acc ^= b;
+        }
+        for (uint8_t b : vchPubKey) {
+            acc += b;
+        }
+        return acc & 1;
+    }
+};
+} // namespace
+
+static CScript ConsumeP2SHRedeemScript(FuzzedDataProvider &provider) {
+    if (provider.ConsumeBool()) {
+        return ConsumeScript(provider);
+    }
+
+    // Multisig, with keys of any size.
+    const int nKeys = provider.ConsumeIntegralInRange<int>(0, 16);
+    const int nRequired = provider.ConsumeIntegralInRange<int>(0, nKeys);
+    CScript redeemScript;
+    redeemScript << nRequired;
+    for (int i = 0; i < nKeys; i++) {
+        redeemScript << ConsumeRandomLengthByteVector(provider, 65);
+    }
+    redeemScript << nKeys << OP_CHECKMULTISIG;
+    return redeemScript;
+}
+
+void test_one_input(const std::vector<uint8_t> &buffer) {
+    FuzzedDataProvider provider(buffer.data(), buffer.size());
+
+    uint32_t flags = provider.ConsumeIntegral<uint32_t>();
+    // If the CLEANSTACK flag is set, then P2SH should also be set.
+    if (flags & SCRIPT_VERIFY_CLEANSTACK) {
+        flags |= SCRIPT_VERIFY_P2SH;
+    }
+
+    const DeterministicSignatureChecker checker(
+        provider.ConsumeIntegral<uint8_t>());
+
+    // Build spends of the standard templates, which may or may not be valid.
+    CScript scriptSig;
+    CScript scriptPubKey;
+    if (provider.ConsumeBool()) {
+        const std::vector<uint8_t> pubkey =
+            ConsumeRandomLengthByteVector(provider, 65);
+        uint160 hash;
+        CHash160().Write(pubkey).Finalize(hash);
+        if (provider.ConsumeBool()) {
+            hash = ConsumeUInt160(provider);
+        }
+        scriptPubKey << OP_DUP << OP_HASH160 << ToByteVector(hash)
+                     << OP_EQUALVERIFY << OP_CHECKSIG;
+        scriptSig << ConsumeRandomLengthByteVector(provider, 73) << pubkey;
+    } else {
+        const CScript redeemScript = ConsumeP2SHRedeemScript(provider);
+        uint160 hash;
+        CHash160()
+            .Write({redeemScript.data(), redeemScript.size()})
+            .Finalize(hash);
+        if (provider.ConsumeBool()) {
+            hash = ConsumeUInt160(provider);
+        }
+        scriptPubKey << OP_HASH160 << ToByteVector(hash) << OP_EQUAL;
+
+        const size_t numPushes = provider.ConsumeIntegralInRange<size_t>(0, 16);
+        for (size_t i = 0; i < numPushes; i++) {
+            scriptSig << ConsumeRandomLengthByteVector(provider, 73);
+        }
+        scriptSig << std::vector<uint8_t>(redeemScript.begin(),
+                                          redeemScript.end());
+    }
+
+    // Also exercise the scriptSigs that don't match the template.
+    if (provider.ConsumeBool()) {
+        const CScript extra = ConsumeScript(provider);
+        if (provider.ConsumeBool()) {
+            scriptSig.clear();
+        }
+        scriptSig.insert(scriptSig.end(), extra.begin(), extra.end());
+    }
+
+    ScriptExecutionMetrics metrics;
+    ScriptError serror;
+    const bool ret =
+        VerifyScript(scriptSig, scriptPubKey, flags, checker, metrics, &serror);
+
+    ScriptExecutionMetrics metricsInterpreter;
+    ScriptError serrorInterpreter;
+    const bool retInterpreter =
+        VerifyScriptWithInterpreter(scriptSig, scriptPubKey, flags, checker,
+                                    metricsInterpreter, &serrorInterpreter);
+
+    assert(ret == retInterpreter);
+    assert(serror == serrorInterpreter);
+    if (ret) {
+        assert(metrics.nSigChecks == metricsInterpreter.nSigChecks);
+    }
+}
@@ -13,6 +13,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(hash_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(murmurhash3) {
@@ -131,6 +133,17 @@ BOOST_AUTO_TEST_CASE(siphash) {
                       (uint64_t(x + 6) << 48) | (uint64_t(x + 7) << 56));
     }
 
+    // Check test vectors from spec, writing the whole message at once
+    uint8_t message[std::size(siphash_4_2_testvec)];
+    for (uint8_t x = 0; x < std::size(siphash_4_2_testvec); ++x) {
+        message[x] = x;
+    }
+    for (uint8_t x = 0; x < std::size(siphash_4_2_testvec); ++x) {
+        CSipHasher hasher4(0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL);
+        hasher4.Write(message, x);
+        BOOST_CHECK_EQUAL(hasher4.Finalize(), siphash_4_2_testvec[x]);
+    }
+
     CHashWriter ss(SER_DISK, CLIENT_VERSION);
     CMutableTransaction tx;
     // Note these tests were originally written with tx.nVersion=1
@@ -156,6 +169,41 @@ BOOST_AUTO_TEST_CASE(siphash) {
         BOOST_CHECK_EQUAL(SipHashUint256(k1, k2, x), sip256.Finalize());
         BOOST_CHECK_EQUAL(SipHashUint256Extra(k1, k2, x, n), sip288.Finalize());
     }
+
+    // Check consistency between SipHashUint256 and SipHashUint256Batch, for
+    // batches that are not a multiple of the lane count as well.
+    std::vector<uint256> vals(37);
+    std::vector<const uint256 *> pvals;
+    for (uint256 &val : vals) {
+        val = InsecureRand256();
+        pvals.push_back(&val);
+    }
+    for (size_t count = 0; count <= vals.size(); count++) {
+        uint64_t k1 = ctx.rand64();
+        uint64_t k2 = ctx.rand64();
+        std::vector<uint64_t> hashes(count);
+        SipHashUint256Batch(k1, k2, pvals.data(), hashes.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            BOOST_CHECK_EQUAL(hashes[i], SipHashUint256(k1, k2, vals[i]));
+        }
+    }
+
+    // Same for SipHashUint256Extra and SipHashUint256ExtraBatch.
+    std::vector<uint32_t> extras(vals.size());
+    for (uint32_t &extra : extras) {
+        extra = ctx.rand32();
+    }
+    for (size_t count = 0; count <= vals.size(); count++) {
+        uint64_t k1 = ctx.rand64();
+        uint64_t k2 = ctx.rand64();
+        std::vector<uint64_t> hashes(count);
+        SipHashUint256ExtraBatch(k1, k2, pvals.data(), extras.data(),
+                                 hashes.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            BOOST_CHECK_EQUAL(hashes[i],
+                              SipHashUint256Extra(k1, k2, vals[i], extras[i]));
+        }
+    }
 }
 
 namespace {
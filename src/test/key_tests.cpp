@@ -405,6 +405,53 @@ BOOST_AUTO_TEST_CASE(key_key_negation) {
     BOOST_CHECK(key.GetPubKey().data()[0] == 0x03);
 }
 
+BOOST_AUTO_TEST_CASE(schnorr_batch_verify) {
+    SchnorrBatchVerifier batch;
+    BOOST_CHECK(batch.empty());
+    BOOST_CHECK(batch.Verify());
+
+    std::vector<CKey> keys;
+    std::vector<uint256> hashes;
+    std::vector<SchnorrSig> sigs;
+    for (int i = 0; i < 20; i++) {
+        keys.push_back(CKey::MakeCompressedKey());
+        hashes.push_back(InsecureRand256());
+        sigs.emplace_back();
+        BOOST_CHECK(keys.back().SignSchnorr(hashes.back(), sigs.back()));
+        batch.Add(keys.back().GetPubKey(), hashes.back(), sigs.back());
+    }
+    BOOST_CHECK_EQUAL(batch.size(), 20);
+    BOOST_CHECK(batch.Verify());
+
+    // Any invalid signature, message or public key invalidates the batch.
+    SchnorrBatchVerifier invalidSig = batch;
+    SchnorrSig badSig = sigs[0];
+    badSig[InsecureRandRange(badSig.size())] ^= 1;
+    invalidSig.Add(keys[0].GetPubKey(), hashes[0], badSig);
+    BOOST_CHECK(!invalidSig.Verify());
+
+    SchnorrBatchVerifier invalidHash = batch;
+    invalidHash.Add(keys[0].GetPubKey(), hashes[1], sigs[0]);
+    BOOST_CHECK(!invalidHash.Verify());
+
+    SchnorrBatchVerifier invalidPubkey = batch;
+    invalidPubkey.Add(CPubKey(), hashes[0], sigs[0]);
+    BOOST_CHECK(!invalidPubkey.Verify());
+
+    // Uncompressed keys are supported.
+    SchnorrBatchVerifier uncompressed;
+    CKey key;
+    key.MakeNewKey(false);
+    SchnorrSig sig;
+    BOOST_CHECK(key.SignSchnorr(hashes[0], sig));
+    uncompressed.Add(key.GetPubKey(), hashes[0], sig);
+    BOOST_CHECK(uncompressed.Verify());
+
+    batch.clear();
+    BOOST_CHECK(batch.empty());
+    BOOST_CHECK(batch.Verify());
+}
+
 static CPubKey UnserializePubkey(const std::vector<uint8_t> &data) {
     CDataStream stream{SER_NETWORK, INIT_PROTO_VERSION};
     stream << data;
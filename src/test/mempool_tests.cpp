@@ -305,6 +305,35 @@ BOOST_AUTO_TEST_CASE(MempoolClearTest) {
     BOOST_CHECK_EQUAL(testPool.vTxHashes.size(), 0UL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolPrecomputedTxDataTest) {
+    TestMemPoolEntryHelper entry;
+    CMutableTransaction tx;
+    tx.vin.resize(2);
+    tx.vin[0].prevout = COutPoint(TxId(InsecureRand256()), 0);
+    tx.vin[1].prevout = COutPoint(TxId(InsecureRand256()), 1);
+    tx.vin[1].nSequence = 42;
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    tx.vout[0].nValue = 33000 * SATOSHI;
+    const PrecomputedTransactionData expected(tx);
+
+    CTxMemPool testPool;
+    LOCK2(cs_main, testPool.cs);
+
+    PrecomputedTransactionData txdata;
+    BOOST_CHECK(!testPool.GetPrecomputedTxData(tx.GetId(), txdata));
+
+    // The midstates computed when the transaction was accepted are returned.
+    testPool.addUnchecked(entry.FromTx(tx));
+    BOOST_CHECK(testPool.GetPrecomputedTxData(tx.GetId(), txdata));
+    BOOST_CHECK_EQUAL(txdata.hashPrevouts, expected.hashPrevouts);
+    BOOST_CHECK_EQUAL(txdata.hashSequence, expected.hashSequence);
+    BOOST_CHECK_EQUAL(txdata.hashOutputs, expected.hashOutputs);
+
+    testPool.clear();
+    BOOST_CHECK(!testPool.GetPrecomputedTxData(tx.GetId(), txdata));
+}
+
 template <typename name>
 static void CheckSort(CTxMemPool &pool, std::vector<std::string> &sortedOrder,
                       const std::string &testcase)
@@ -27,6 +27,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <memory>
 
 namespace miner_tests {
@@ -220,6 +221,41 @@ void MinerTestingSetup::TestPackageSelection(
     m_node.mempool->addUnchecked(entry.Fee(10000 * SATOSHI).FromTx(tx));
     pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
     BOOST_CHECK(pblocktemplate->block.vtx[8]->GetId() == lowFeeTxId2);
+
+    // Test that a transaction finalized by avalanche is selected along with its
+    // ancestors, even though the package pays no fee.
+    tx.vin[0].prevout = COutPoint(txFirst[3]->GetId(), 0);
+    tx.vout[0].nValue = int64_t(5000000000LL) * SATOSHI;
+    TxId freeParentTxId = tx.GetId();
+    m_node.mempool->addUnchecked(
+        entry.Fee(Amount::zero()).SpendsCoinbase(true).FromTx(tx));
+
+    tx.vin[0].prevout = COutPoint(freeParentTxId, 0);
+    TxId freeChildTxId = tx.GetId();
+    m_node.mempool->addUnchecked(
+        entry.Fee(Amount::zero()).SpendsCoinbase(false).FromTx(tx));
+
+    auto countTxs = [&](const CBlock &block) {
+        return std::count_if(block.vtx.begin(), block.vtx.end(),
+                             [&](const CTransactionRef &txn) {
+                                 return txn->GetId() == freeParentTxId ||
+                                        txn->GetId() == freeChildTxId;
+                             });
+    };
+
+    pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(countTxs(pblocktemplate->block), 0);
+
+    m_node.mempool->SetAvalancheFinalized(freeChildTxId);
+    BOOST_CHECK(m_node.mempool->IsAvalancheFinalized(freeChildTxId));
+    pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_CHECK_EQUAL(countTxs(pblocktemplate->block), 2);
+
+    // The finalized transactions are forgotten as they leave the mempool.
+    m_node.mempool->removeRecursive(CTransaction(tx),
+                                    MemPoolRemovalReason::CONFLICT);
+    BOOST_CHECK(!m_node.mempool->IsAvalancheFinalized(freeChildTxId));
+    BOOST_CHECK(m_node.mempool->GetAvalancheFinalizedTxs().empty());
 }
 
 static void TestCoinbaseMessageEB(uint64_t eb, std::string cbmsg,
@@ -142,6 +142,19 @@ static void DoTest(const CScript &scriptPubKey, const CScript &scriptSig,
                                                 FormatScriptError(scriptError) +
                                                 " expected: " + message);
 
+    // The scripts give the same results when they are not evaluated as one of
+    // the standard templates.
+    ScriptExecutionMetrics metricsInterpreter;
+    BOOST_CHECK_MESSAGE(VerifyScriptWithInterpreter(
+                            scriptSig, scriptPubKey, flags,
+                            MutableTransactionSignatureChecker(
+                                &tx, 0, txCredit.vout[0].nValue),
+                            metricsInterpreter, &err) == expect,
+                        message);
+    BOOST_CHECK_MESSAGE(err == scriptError, FormatScriptError(err) + " where " +
+                                                FormatScriptError(scriptError) +
+                                                " expected: " + message);
+
     // Verify that removing flags from a passing test or adding flags to a
     // failing test does not change the result, except for some special flags.
     for (int i = 0; i < 16; ++i) {
@@ -3207,6 +3220,40 @@ BOOST_AUTO_TEST_CASE(script_HasValidOps) {
     BOOST_CHECK(!script.HasValidOps());
 }
 
+BOOST_AUTO_TEST_CASE(script_GetOp_span) {
+    // The pushed data is returned in place, and matches the copied data.
+    const std::vector<uint8_t> data(300, 0x5a);
+    const CScript script = CScript() << OP_0 << std::vector<uint8_t>(1, 0x42)
+                                     << data << OP_DUP;
+
+    CScript::const_iterator pc = script.begin();
+    CScript::const_iterator pc_vector = script.begin();
+    opcodetype opcode;
+    Span<const uint8_t> span;
+    std::vector<uint8_t> vch;
+
+    std::vector<opcodetype> opcodes;
+    while (script.GetOp(pc, opcode, span)) {
+        opcodes.push_back(opcode);
+        BOOST_CHECK(script.GetOp(pc_vector, opcode, vch));
+        BOOST_CHECK(pc == pc_vector);
+        BOOST_CHECK(Span<const uint8_t>(vch) == span);
+        BOOST_CHECK(span.empty() || (span.data() >= &*script.begin() &&
+                                     span.data() < &*script.end()));
+    }
+    BOOST_CHECK(pc == script.end());
+    BOOST_CHECK(opcodes == std::vector<opcodetype>(
+                               {OP_0, opcodetype(1), OP_PUSHDATA2, OP_DUP}));
+
+    // Truncated pushes fail and return no data.
+    const std::vector<uint8_t> truncated{OP_PUSHDATA1, 2, 0x42};
+    const CScript truncatedScript(truncated.begin(), truncated.end());
+    pc = truncatedScript.begin();
+    BOOST_CHECK(!truncatedScript.GetOp(pc, opcode, span));
+    BOOST_CHECK_EQUAL(opcode, OP_INVALIDOPCODE);
+    BOOST_CHECK(span.empty());
+}
+
 #if defined(HAVE_CONSENSUS_LIB)
 
 /* Test simple (successful) usage of bitcoinconsensus_verify_script */
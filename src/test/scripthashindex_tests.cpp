@@ -0,0 +1,196 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <config.h>
+#include <consensus/consensus.h>
+#include <consensus/validation.h>
+#include <index/scripthashindex.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <util/strencodings.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+BOOST_AUTO_TEST_SUITE(scripthashindex_tests)
+
+static void WaitForIndexSync(ScriptHashIndex &index) {
+    const auto timeout = GetTime<std::chrono::seconds>() + 120s;
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(timeout > GetTime<std::chrono::milliseconds>());
+        UninterruptibleSleep(100ms);
+    }
+}
+
+static std::vector<ScriptHistoryEntry>
+GetFullHistory(const ScriptHashIndex &index, const CScript &script,
+               size_t page_size) {
+    std::vector<ScriptHistoryEntry> history;
+    int from_height = 0;
+    uint32_t from_position = 0;
+    bool more = true;
+    while (more) {
+        std::vector<ScriptHistoryEntry> page;
+        BOOST_REQUIRE(index.LookupHistory(ComputeScriptHash(script),
+                                          from_height, from_position,
+                                          page_size, page, more));
+        BOOST_REQUIRE(page.size() <= page_size);
+        BOOST_REQUIRE(!more || page.size() == page_size);
+        if (more) {
+            from_height = page.back().height;
+            from_position = page.back().tx_position + 1;
+        }
+        history.insert(history.end(), page.begin(), page.end());
+    }
+    return history;
+}
+
+BOOST_AUTO_TEST_CASE(scripthash_test) {
+    // Electrum documents this script hash for the P2PKH script of
+    // 1A1zP1eP5QGefi2DMPTfTL5SLmv7DivfNa.
+    const std::vector<uint8_t> script_bytes =
+        ParseHex("76a91462e907b15cbf27d5425399ebf6f0fb50ebb88f1888ac");
+    const CScript script(script_bytes.begin(), script_bytes.end());
+    BOOST_CHECK_EQUAL(
+        ComputeScriptHash(script).GetHex(),
+        "8b01df4e368ea28f8dc0423bcf7a4923e3a12d307c875e47a0cfbf90b5c39161");
+}
+
+BOOST_FIXTURE_TEST_CASE(scripthashindex_history, TestChain100Setup) {
+    ScriptHashIndex index(1 << 20, true);
+
+    // The index returns nothing before it is started.
+    const CScript coinbase_script =
+        CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    std::vector<ScriptHistoryEntry> entries;
+    bool more;
+    BOOST_CHECK(index.LookupHistory(ComputeScriptHash(coinbase_script), 0, 0,
+                                    10, entries, more));
+    BOOST_CHECK(entries.empty());
+    BOOST_CHECK(!more);
+
+    index.Start(m_node.chainman->ActiveChainstate());
+    WaitForIndexSync(index);
+
+    // All the coinbases of the chain but the genesis pay to the coinbase key.
+    std::vector<ScriptHistoryEntry> history =
+        GetFullHistory(index, coinbase_script, 1000);
+    BOOST_CHECK_EQUAL(history.size(), 100U);
+    for (size_t i = 0; i < history.size(); ++i) {
+        BOOST_CHECK_EQUAL(history[i].height, int(i) + 1);
+        BOOST_CHECK_EQUAL(history[i].tx_position, 0U);
+        BOOST_CHECK(history[i].txid == m_coinbase_txns[i]->GetId());
+        BOOST_CHECK(history[i].funded_outputs == std::vector<uint32_t>{0});
+        BOOST_CHECK(history[i].spent_inputs.empty());
+    }
+
+    // Paging returns the same history.
+    for (size_t page_size : {1, 7, 50, 99, 100}) {
+        std::vector<ScriptHistoryEntry> paged =
+            GetFullHistory(index, coinbase_script, page_size);
+        BOOST_REQUIRE_EQUAL(paged.size(), history.size());
+        for (size_t i = 0; i < paged.size(); ++i) {
+            BOOST_CHECK(paged[i].txid == history[i].txid);
+        }
+    }
+
+    // The cursor skips the beginning of the history.
+    BOOST_CHECK(index.LookupHistory(ComputeScriptHash(coinbase_script), 42, 0,
+                                    1000, entries, more));
+    BOOST_CHECK_EQUAL(entries.size(), 59U);
+    BOOST_CHECK_EQUAL(entries.front().height, 42);
+    BOOST_CHECK(!more);
+    BOOST_CHECK(index.LookupHistory(ComputeScriptHash(coinbase_script), 42, 1,
+                                    1000, entries, more));
+    BOOST_CHECK_EQUAL(entries.size(), 58U);
+    BOOST_CHECK_EQUAL(entries.front().height, 43);
+
+    // Mine a coinbase that anyone can spend and let it mature.
+    const CScript anyone_script = CScript() << OP_1;
+    const CBlock anyone_block = CreateAndProcessBlock({}, anyone_script);
+    mineBlocks(COINBASE_MATURITY);
+
+    // Spend it to two outputs of a new script and one of the coinbase script.
+    CKey key;
+    key.MakeNewKey(true);
+    const CScript dest_script =
+        GetScriptForDestination(PKHash(key.GetPubKey()));
+
+    CMutableTransaction spend;
+    spend.nVersion = 1;
+    spend.vin.resize(1);
+    spend.vin[0].prevout = COutPoint(anyone_block.vtx[0]->GetId(), 0);
+    spend.vout.resize(3);
+    spend.vout[0].nValue = 11 * CENT;
+    spend.vout[0].scriptPubKey = dest_script;
+    spend.vout[1].nValue = 11 * CENT;
+    spend.vout[1].scriptPubKey = coinbase_script;
+    spend.vout[2].nValue = 11 * CENT;
+    spend.vout[2].scriptPubKey = dest_script;
+
+    CreateAndProcessBlock({spend}, dest_script);
+    WaitForIndexSync(index);
+    const int spend_height = 102 + COINBASE_MATURITY;
+
+    // The anyone can spend coin was funded then spent.
+    history = GetFullHistory(index, anyone_script, 1000);
+    BOOST_REQUIRE_EQUAL(history.size(), 2U);
+    BOOST_CHECK_EQUAL(history[0].height, 101);
+    BOOST_CHECK(history[0].txid == anyone_block.vtx[0]->GetId());
+    BOOST_CHECK(history[0].funded_outputs == std::vector<uint32_t>{0});
+    BOOST_CHECK(history[0].spent_inputs.empty());
+    BOOST_CHECK_EQUAL(history[1].height, spend_height);
+    BOOST_CHECK_EQUAL(history[1].tx_position, 1U);
+    BOOST_CHECK(history[1].txid == spend.GetId());
+    BOOST_CHECK(history[1].funded_outputs.empty());
+    BOOST_CHECK(history[1].spent_inputs == std::vector<uint32_t>{0});
+
+    // The coinbase script got the matured coinbases and the spend.
+    history = GetFullHistory(index, coinbase_script, 1000);
+    BOOST_REQUIRE_EQUAL(history.size(), 201U);
+    BOOST_CHECK_EQUAL(history.back().height, spend_height);
+    BOOST_CHECK(history.back().txid == spend.GetId());
+    BOOST_CHECK(history.back().funded_outputs == std::vector<uint32_t>{1});
+
+    // The new script is funded by both the coinbase and the spend.
+    history = GetFullHistory(index, dest_script, 1000);
+    BOOST_REQUIRE_EQUAL(history.size(), 2U);
+    BOOST_CHECK_EQUAL(history[0].height, spend_height);
+    BOOST_CHECK_EQUAL(history[0].tx_position, 0U);
+    BOOST_CHECK(history[0].funded_outputs == std::vector<uint32_t>{0});
+    BOOST_CHECK_EQUAL(history[1].tx_position, 1U);
+    BOOST_CHECK(history[1].txid == spend.GetId());
+    BOOST_CHECK((history[1].funded_outputs == std::vector<uint32_t>{0, 2}));
+    BOOST_CHECK(history[1].spent_inputs.empty());
+
+    // Reorg the spend away, the index forgets about it.
+    {
+        BlockValidationState state;
+        CBlockIndex *tip =
+            WITH_LOCK(cs_main, return m_node.chainman->ActiveTip());
+        BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(
+            GetConfig(), state, tip));
+    }
+    CKey other_key;
+    other_key.MakeNewKey(true);
+    const CScript other_script =
+        GetScriptForDestination(PKHash(other_key.GetPubKey()));
+    CreateAndProcessBlock({}, other_script);
+    WaitForIndexSync(index);
+
+    BOOST_CHECK(GetFullHistory(index, dest_script, 1000).empty());
+    BOOST_CHECK_EQUAL(GetFullHistory(index, anyone_script, 1000).size(), 1U);
+    BOOST_CHECK_EQUAL(GetFullHistory(index, coinbase_script, 1000).size(),
+                      200U);
+    history = GetFullHistory(index, other_script, 1000);
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].height, spend_height);
+
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,7 +7,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <utility>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(shortidprocessor_tests)
 
@@ -130,4 +132,51 @@ BOOST_AUTO_TEST_CASE(processing_items) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(matching_batches) {
+    using TestItemShortIdProcessor =
+        ShortIdProcessor<PrefilledTestItem, PrefilledTestItemAdapter,
+                         TestItemCompare>;
+
+    // Items 0 and 5 are prefilled, the others have shortid 10 * index.
+    const std::vector<PrefilledTestItem> prefilledItems{0, 5};
+    const std::vector<uint64_t> shortids{10, 20, 30, 40, 60};
+    TestItemShortIdProcessor p(prefilledItems, shortids, 10);
+    BOOST_CHECK_EQUAL(p.getShortIdCount(), 5);
+
+    size_t built = 0;
+    auto getItem = [&](const std::vector<uint64_t> &batch) {
+        return [&](size_t i) {
+            built++;
+            return std::make_shared<uint32_t>(batch[i] / 10);
+        };
+    };
+
+    // Only the matching items are built, and the count accounts for them.
+    size_t matched = 0;
+    const std::vector<uint64_t> batch1{10, 15, 30, 25};
+    BOOST_CHECK(!p.matchKnownItemsLazy(batch1.data(), batch1.size(), matched,
+                                       getItem(batch1)));
+    BOOST_CHECK_EQUAL(matched, 2);
+    BOOST_CHECK_EQUAL(built, 2);
+    BOOST_CHECK_EQUAL(*p.getItem(1), 1);
+    BOOST_CHECK_EQUAL(*p.getItem(3), 3);
+
+    // The matching stops as soon as all the shortids are matched.
+    const std::vector<uint64_t> batch2{20, 40, 60, 10, 70};
+    BOOST_CHECK(p.matchKnownItemsLazy(batch2.data(), batch2.size(), matched,
+                                      getItem(batch2)));
+    BOOST_CHECK_EQUAL(matched, 5);
+    BOOST_CHECK_EQUAL(built, 5);
+    for (uint32_t i = 0; i < 7; i++) {
+        BOOST_CHECK_EQUAL(*p.getItem(i), i);
+    }
+
+    // An empty batch matches nothing.
+    const std::vector<uint64_t> emptyBatch;
+    BOOST_CHECK(!p.matchKnownItemsLazy(emptyBatch.data(), 0, matched,
+                                       getItem(emptyBatch)));
+    BOOST_CHECK_EQUAL(matched, 5);
+    BOOST_CHECK_EQUAL(built, 5);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+// Copyright (c) 2021 The Bitcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <config.h>
+#include <consensus/consensus.h>
+#include <consensus/validation.h>
+#include <index/spentindex.h>
+#include <rpc/blockchain.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+BOOST_AUTO_TEST_SUITE(spentindex_tests)
+
+static void WaitForIndexSync(SpentIndex &index) {
+    const auto timeout = GetTime<std::chrono::seconds>() + 120s;
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(timeout > GetTime<std::chrono::milliseconds>());
+        UninterruptibleSleep(100ms);
+    }
+}
+
+/** Spend an outpoint paying to OP_1, with enough outputs to be valid. */
+static CMutableTransaction CreateSpend(const COutPoint &outpoint,
+                                       Amount value) {
+    CMutableTransaction tx;
+    tx.nVersion = 1;
+    tx.vin.emplace_back(outpoint);
+    tx.vout.emplace_back(value, CScript() << OP_1);
+    // Pad the transaction to the minimum transaction size.
+    tx.vout.emplace_back(Amount::zero(), CScript() << OP_RETURN
+                                                   << std::vector<uint8_t>(
+                                                          40, 0x42));
+    return tx;
+}
+
+BOOST_FIXTURE_TEST_CASE(spentindex_initial_sync, TestChain100Setup) {
+    SpentIndex index(1 << 20, true);
+
+    // Mine a coinbase that anyone can spend and let it mature.
+    const CScript anyone_script = CScript() << OP_1;
+    const CBlock anyone_block = CreateAndProcessBlock({}, anyone_script);
+    mineBlocks(COINBASE_MATURITY);
+    const COutPoint anyone_outpoint(anyone_block.vtx[0]->GetId(), 0);
+
+    const CMutableTransaction spend = CreateSpend(anyone_outpoint, 10 * COIN);
+    CreateAndProcessBlock({spend}, anyone_script);
+    const int spend_height = 102 + COINBASE_MATURITY;
+
+    // The index does not know about the spend before it is started.
+    SpendingInput spender;
+    BOOST_CHECK(!index.FindSpender(anyone_outpoint, spender));
+
+    index.Start(m_node.chainman->ActiveChainstate());
+    WaitForIndexSync(index);
+
+    BOOST_CHECK(index.FindSpender(anyone_outpoint, spender));
+    BOOST_CHECK(spender.txid == spend.GetId());
+    BOOST_CHECK_EQUAL(spender.input_index, 0U);
+    BOOST_CHECK_EQUAL(spender.height, spend_height);
+
+    // Unspent outpoints and coinbase inputs are not indexed.
+    BOOST_CHECK(!index.FindSpender(COutPoint(spend.GetId(), 0), spender));
+    BOOST_CHECK(!index.FindSpender(COutPoint(spend.GetId(), 1), spender));
+    BOOST_CHECK(!index.FindSpender(COutPoint(), spender));
+
+    // Spend the first output of the spend in a new block.
+    const CMutableTransaction spend2 =
+        CreateSpend(COutPoint(spend.GetId(), 0), 4 * COIN);
+    CreateAndProcessBlock({spend2}, anyone_script);
+    WaitForIndexSync(index);
+
+    BOOST_CHECK(index.FindSpender(COutPoint(spend.GetId(), 0), spender));
+    BOOST_CHECK(spender.txid == spend2.GetId());
+    BOOST_CHECK_EQUAL(spender.height, spend_height + 1);
+
+    // Reorg both spends away and spend the outpoint in another transaction,
+    // the index only knows about the new spender.
+    for (int i = 0; i < 2; ++i) {
+        BlockValidationState state;
+        CBlockIndex *tip =
+            WITH_LOCK(cs_main, return m_node.chainman->ActiveTip());
+        BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(
+            GetConfig(), state, tip));
+    }
+    const CMutableTransaction other_spend =
+        CreateSpend(anyone_outpoint, 5 * COIN);
+    CreateAndProcessBlock({}, anyone_script);
+    CreateAndProcessBlock({other_spend}, anyone_script);
+    WaitForIndexSync(index);
+
+    BOOST_CHECK(index.FindSpender(anyone_outpoint, spender));
+    BOOST_CHECK(spender.txid == other_spend.GetId());
+    BOOST_CHECK_EQUAL(spender.height, spend_height + 1);
+    BOOST_CHECK(!index.FindSpender(COutPoint(spend.GetId(), 0), spender));
+
+    index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(spentindex_mempool_overlay, TestChain100Setup) {
+    g_spent_index = std::make_unique<SpentIndex>(1 << 20, true);
+
+    const CScript anyone_script = CScript() << OP_1;
+    const CBlock anyone_block = CreateAndProcessBlock({}, anyone_script);
+    mineBlocks(COINBASE_MATURITY);
+    const COutPoint anyone_outpoint(anyone_block.vtx[0]->GetId(), 0);
+
+    g_spent_index->Start(m_node.chainman->ActiveChainstate());
+    WaitForIndexSync(*g_spent_index);
+
+    // Unspent.
+    BOOST_CHECK(
+        SpendingInputToJSON(m_node.mempool.get(), anyone_outpoint).isNull());
+
+    // Spent in the mempool, at the second input.
+    CMutableTransaction unconfirmed;
+    unconfirmed.nVersion = 1;
+    unconfirmed.vin.emplace_back(COutPoint(TxId(InsecureRand256()), 0));
+    unconfirmed.vin.emplace_back(anyone_outpoint);
+    unconfirmed.vout.emplace_back(10 * COIN, anyone_script);
+    {
+        LOCK2(cs_main, m_node.mempool->cs);
+        TestMemPoolEntryHelper entry;
+        m_node.mempool->addUnchecked(entry.FromTx(unconfirmed));
+    }
+    UniValue spender =
+        SpendingInputToJSON(m_node.mempool.get(), anyone_outpoint);
+    BOOST_CHECK_EQUAL(find_value(spender, "txid").get_str(),
+                      unconfirmed.GetId().GetHex());
+    BOOST_CHECK_EQUAL(find_value(spender, "vin").get_int(), 1);
+    BOOST_CHECK(!find_value(spender, "confirmed").get_bool());
+    BOOST_CHECK(find_value(spender, "height").isNull());
+
+    // The mempool is not looked at when not given.
+    BOOST_CHECK(SpendingInputToJSON(nullptr, anyone_outpoint).isNull());
+
+    // Once a conflicting spend is confirmed, the spender comes from the index.
+    const CMutableTransaction confirmed =
+        CreateSpend(anyone_outpoint, 5 * COIN);
+    CreateAndProcessBlock({confirmed}, anyone_script);
+    WaitForIndexSync(*g_spent_index);
+
+    spender = SpendingInputToJSON(m_node.mempool.get(), anyone_outpoint);
+    BOOST_CHECK_EQUAL(find_value(spender, "txid").get_str(),
+                      confirmed.GetId().GetHex());
+    BOOST_CHECK_EQUAL(find_value(spender, "vin").get_int(), 0);
+    BOOST_CHECK(find_value(spender, "confirmed").get_bool());
+    BOOST_CHECK_EQUAL(find_value(spender, "height").get_int(),
+                      102 + COINBASE_MATURITY);
+
+    g_spent_index->Stop();
+    g_spent_index.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
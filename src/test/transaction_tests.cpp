@@ -277,6 +277,52 @@ BOOST_AUTO_TEST_CASE(basic_transaction_tests) {
                         "Transaction with duplicate txins should be invalid.");
 }
 
+BOOST_AUTO_TEST_CASE(duplicate_inputs) {
+    auto check = [](const CMutableTransaction &mtx,
+                    const std::string &reason) {
+        TxValidationState state;
+        bool valid = CheckRegularTransaction(CTransaction(mtx), state);
+        BOOST_CHECK_EQUAL(valid, reason.empty());
+        BOOST_CHECK_EQUAL(state.GetRejectReason(), reason);
+    };
+
+    // Enough inputs to be hashed by all the batch implementations.
+    CMutableTransaction mtx;
+    mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    for (uint32_t i = 0; i < 100; i++) {
+        mtx.vin.emplace_back(COutPoint(TxId(InsecureRand256()), i % 3));
+    }
+    // Same txid, different index.
+    mtx.vin.emplace_back(COutPoint(mtx.vin[7].prevout.GetTxId(), 1000));
+    check(mtx, "");
+
+    // A duplicate anywhere is found.
+    for (size_t i : {size_t(0), size_t(1), size_t(57), mtx.vin.size() - 1}) {
+        for (size_t j : {size_t(0), size_t(42), mtx.vin.size()}) {
+            CMutableTransaction dup = mtx;
+            dup.vin.insert(dup.vin.begin() + j, mtx.vin[i]);
+            check(dup, "bad-txns-inputs-duplicate");
+        }
+    }
+
+    // The first error in the order of the inputs is reported.
+    CMutableTransaction nullFirst = mtx;
+    nullFirst.vin[50].prevout = COutPoint();
+    nullFirst.vin[80] = nullFirst.vin[70];
+    check(nullFirst, "bad-txns-prevout-null");
+
+    CMutableTransaction dupFirst = mtx;
+    dupFirst.vin[60] = dupFirst.vin[10];
+    dupFirst.vin[80].prevout = COutPoint();
+    check(dupFirst, "bad-txns-inputs-duplicate");
+
+    // Null prevouts are duplicates of each other, but the null is reported.
+    CMutableTransaction twoNulls = mtx;
+    twoNulls.vin[30].prevout = COutPoint();
+    twoNulls.vin[20].prevout = COutPoint();
+    check(twoNulls, "bad-txns-prevout-null");
+}
+
 BOOST_AUTO_TEST_CASE(test_Get) {
     FillableSigningProvider keystore;
     CCoinsView coinsDummy;
@@ -930,4 +976,40 @@ BOOST_AUTO_TEST_CASE(tx_getvalueout) {
     BOOST_CHECK_THROW(overflow_sum_tx.GetValueOut(), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(make_transaction_refs) {
+    // Enough transactions to be processed in several batches.
+    std::vector<CMutableTransaction> txs(150);
+    for (size_t i = 0; i < txs.size(); i++) {
+        CMutableTransaction &mtx = txs[i];
+        mtx.nVersion = InsecureRand32();
+        mtx.nLockTime = InsecureRand32();
+        mtx.vin.resize(InsecureRandRange(10));
+        for (CTxIn &in : mtx.vin) {
+            in.prevout = COutPoint(TxId(InsecureRand256()), InsecureRand32());
+            in.scriptSig = CScript() << g_insecure_rand_ctx.randbytes(
+                               InsecureRandRange(150));
+        }
+        mtx.vout.resize(InsecureRandRange(10));
+        for (CTxOut &out : mtx.vout) {
+            out.nValue = int64_t(InsecureRand32()) * SATOSHI;
+            out.scriptPubKey = CScript() << OP_RETURN << i;
+        }
+    }
+
+    const std::vector<CMutableTransaction> copy = txs;
+    const std::vector<CTransactionRef> refs =
+        MakeTransactionRefs(std::move(txs));
+    BOOST_CHECK_EQUAL(refs.size(), copy.size());
+    for (size_t i = 0; i < copy.size(); i++) {
+        const CTransaction expected(copy[i]);
+        BOOST_CHECK_EQUAL(refs[i]->GetId(), expected.GetId());
+        BOOST_CHECK(refs[i]->vin == expected.vin);
+        BOOST_CHECK(refs[i]->vout == expected.vout);
+        BOOST_CHECK_EQUAL(refs[i]->nVersion, expected.nVersion);
+        BOOST_CHECK_EQUAL(refs[i]->nLockTime, expected.nLockTime);
+    }
+
+    BOOST_CHECK(MakeTransactionRefs({}).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
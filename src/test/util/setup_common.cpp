@@ -337,7 +337,8 @@ TestMemPoolEntryHelper::FromTx(const CMutableTransaction &tx) const {
 CTxMemPoolEntry
 TestMemPoolEntryHelper::FromTx(const CTransactionRef &tx) const {
     return CTxMemPoolEntry(tx, nFee, nTime, nHeight, spendsCoinbase,
-                           nSigOpCount, LockPoints());
+                           nSigOpCount, LockPoints(),
+                           PrecomputedTransactionData(*tx));
 }
 
 /**
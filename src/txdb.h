@@ -42,6 +42,10 @@ static constexpr int64_t MAX_BLOCK_DB_CACHE_MB = 2;
 static constexpr int64_t MAX_TX_INDEX_CACHE_MB = 1024;
 //! Max memory allocated to all block filter index caches combined in MiB.
 static constexpr int64_t MAX_FILTER_INDEX_CACHE_MB = 1024;
+//! Max memory allocated to the script hash index cache in MiB.
+static constexpr int64_t MAX_SCRIPT_HASH_INDEX_CACHE_MB = 1024;
+//! Max memory allocated to the spent index cache in MiB.
+static constexpr int64_t MAX_SPENT_INDEX_CACHE_MB = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static constexpr int64_t MAX_COINS_DB_CACHE_MB = 8;
 
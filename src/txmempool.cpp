@@ -28,11 +28,12 @@
 CTxMemPoolEntry::CTxMemPoolEntry(const CTransactionRef &_tx, const Amount _nFee,
                                  int64_t _nTime, unsigned int _entryHeight,
                                  bool _spendsCoinbase, int64_t _sigOpsCount,
-                                 LockPoints lp)
+                                 LockPoints lp,
+                                 const PrecomputedTransactionData &_txdata)
     : tx(_tx), nFee(_nFee), nTxSize(tx->GetTotalSize()),
       nUsageSize(RecursiveDynamicUsage(tx)), nTime(_nTime),
       entryHeight(_entryHeight), spendsCoinbase(_spendsCoinbase),
-      sigOpCount(_sigOpsCount), lockPoints(lp) {
+      sigOpCount(_sigOpsCount), lockPoints(lp), txdata(_txdata) {
     nCountWithDescendants = 1;
     nSizeWithDescendants = GetTxSize();
     nSigOpCountWithDescendants = sigOpCount;
@@ -486,6 +487,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason) {
 
     /* add logging because unchecked */
     RemoveUnbroadcastTx(it->GetTx().GetId(), true);
+    m_avalanche_finalized_txids.erase(it->GetTx().GetId());
 
     if (vTxHashes.size() > 1) {
         vTxHashes[it->vTxHashesIdx] = std::move(vTxHashes.back());
@@ -686,6 +688,7 @@ void CTxMemPool::_clear() {
     mapTx.clear();
     mapNextTx.clear();
     vTxHashes.clear();
+    m_avalanche_finalized_txids.clear();
     totalTxSize = 0;
     cachedInnerUsage = 0;
     lastRollingFeeUpdate = GetTime();
@@ -947,6 +950,18 @@ CTransactionRef CTxMemPool::get(const TxId &txid) const {
     return i->GetSharedTx();
 }
 
+bool CTxMemPool::GetPrecomputedTxData(
+    const TxId &txid, PrecomputedTransactionData &txdata) const {
+    LOCK(cs);
+    indexed_transaction_set::const_iterator i = mapTx.find(txid);
+    if (i == mapTx.end()) {
+        return false;
+    }
+
+    txdata = i->GetPrecomputedTxData();
+    return true;
+}
+
 TxMempoolInfo CTxMemPool::info(const TxId &txid) const {
     LOCK(cs);
     indexed_transaction_set::const_iterator i = mapTx.find(txid);
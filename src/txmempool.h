@@ -113,6 +113,9 @@ private:
     Amount feeDelta;
     //! Track the height and time at which tx was final
     LockPoints lockPoints;
+    //! Sighash midstates, so they are not computed again when the transaction
+    //! is mined
+    const PrecomputedTransactionData txdata;
 
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
@@ -135,7 +138,8 @@ private:
 public:
     CTxMemPoolEntry(const CTransactionRef &_tx, const Amount _nFee,
                     int64_t _nTime, unsigned int _entryHeight,
-                    bool spendsCoinbase, int64_t _nSigOpCount, LockPoints lp);
+                    bool spendsCoinbase, int64_t _nSigOpCount, LockPoints lp,
+                    const PrecomputedTransactionData &_txdata);
 
     const CTransaction &GetTx() const { return *this->tx; }
     CTransactionRef GetSharedTx() const { return this->tx; }
@@ -149,6 +153,9 @@ public:
     Amount GetModifiedFee() const { return nFee + feeDelta; }
     size_t DynamicMemoryUsage() const { return nUsageSize; }
     const LockPoints &GetLockPoints() const { return lockPoints; }
+    const PrecomputedTransactionData &GetPrecomputedTxData() const {
+        return txdata;
+    }
 
     // Adjusts the descendant state.
     void UpdateDescendantState(int64_t modifySize, Amount modifyFee,
@@ -604,6 +611,12 @@ private:
      */
     std::set<TxId> m_unbroadcast_txids GUARDED_BY(cs);
 
+    /**
+     * Transactions finalized by the avalanche pre-consensus. They are included
+     * in the block templates ahead of the other transactions.
+     */
+    std::set<TxId> m_avalanche_finalized_txids GUARDED_BY(cs);
+
 public:
     indirectmap<COutPoint, const CTransaction *> mapNextTx GUARDED_BY(cs);
     std::map<TxId, Amount> mapDeltas GUARDED_BY(cs);
@@ -799,6 +812,13 @@ public:
 
     CTransactionRef get(const TxId &txid) const;
     TxMempoolInfo info(const TxId &txid) const;
+    /**
+     * Copy the sighash midstates of a transaction computed when it was
+     * accepted, if it is in the mempool. They only depend on the transaction,
+     * which is fully committed to by its id.
+     */
+    bool GetPrecomputedTxData(const TxId &txid,
+                              PrecomputedTransactionData &txdata) const;
     std::vector<TxMempoolInfo> infoAll() const;
 
     CFeeRate estimateFee() const;
@@ -830,6 +850,28 @@ public:
         return (m_unbroadcast_txids.count(txid) != 0);
     }
 
+    /** Marks a transaction as finalized by the avalanche pre-consensus */
+    void SetAvalancheFinalized(const TxId &txid) {
+        LOCK(cs);
+        if (exists(txid)) {
+            m_avalanche_finalized_txids.insert(txid);
+        }
+    }
+
+    /** Returns whether a txid was finalized by the avalanche pre-consensus */
+    bool IsAvalancheFinalized(const TxId &txid) const
+        EXCLUSIVE_LOCKS_REQUIRED(cs) {
+        AssertLockHeld(cs);
+        return m_avalanche_finalized_txids.count(txid) != 0;
+    }
+
+    /** Returns the transactions finalized by the avalanche pre-consensus */
+    const std::set<TxId> &GetAvalancheFinalizedTxs() const
+        EXCLUSIVE_LOCKS_REQUIRED(cs) {
+        AssertLockHeld(cs);
+        return m_avalanche_finalized_txids;
+    }
+
     /** Guards this internal counter for external reporting */
     uint64_t GetAndIncrementSequence() const EXCLUSIVE_LOCKS_REQUIRED(cs) {
         return m_sequence_number++;
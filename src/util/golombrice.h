@@ -5,9 +5,13 @@
 #ifndef BITCOIN_UTIL_GOLOMBRICE_H
 #define BITCOIN_UTIL_GOLOMBRICE_H
 
+#include <crypto/common.h>
+#include <span.h>
 #include <streams.h>
 
 #include <cstdint>
+#include <ios>
+#include <vector>
 
 template <typename OStream>
 static void GolombRiceEncode(BitStreamWriter<OStream> &bitwriter, uint8_t P,
@@ -40,4 +44,149 @@ static uint64_t GolombRiceDecode(BitStreamReader<IStream> &bitreader,
     return (q << P) + r;
 }
 
+/**
+ * Golomb-Rice encoder producing the same bit stream as GolombRiceEncode, but
+ * buffering the output in a 64-bit word rather than one byte at a time.
+ */
+class GolombRiceEncoder {
+private:
+    std::vector<uint8_t> &m_out;
+
+    /// Bits waiting to be written, starting from the most significant one.
+    uint64_t m_buffer{0};
+    /// Number of bits in m_buffer.
+    int m_bits{0};
+
+    void Write(uint64_t data, int nbits) {
+        if (nbits == 0) {
+            return;
+        }
+        if (nbits < 64) {
+            data &= (uint64_t(1) << nbits) - 1;
+        }
+
+        const int free = 64 - m_bits;
+        if (nbits < free) {
+            m_buffer |= data << (free - nbits);
+            m_bits += nbits;
+            return;
+        }
+
+        const int remaining = nbits - free;
+        m_buffer |= data >> remaining;
+        uint8_t word[8];
+        WriteBE64(word, m_buffer);
+        m_out.insert(m_out.end(), word, word + 8);
+        m_buffer = remaining ? data << (64 - remaining) : 0;
+        m_bits = remaining;
+    }
+
+public:
+    /** The encoded data is appended to out. */
+    explicit GolombRiceEncoder(std::vector<uint8_t> &out) : m_out(out) {}
+
+    ~GolombRiceEncoder() { Flush(); }
+
+    void Encode(uint8_t P, uint64_t x) {
+        // Write quotient as unary-encoded: q 1's followed by one 0.
+        uint64_t q = x >> P;
+        while (q >= 64) {
+            Write(~uint64_t(0), 64);
+            q -= 64;
+        }
+        // Append the terminating 0 to the remaining 1's so the quotient only
+        // takes a single write.
+        Write(~uint64_t(0) << 1, q + 1);
+
+        // Write the remainder in P bits.
+        Write(x, P);
+    }
+
+    /** Write any buffered bits, padding with 0's to the next byte boundary. */
+    void Flush() {
+        for (int shift = 56; m_bits > 0; shift -= 8, m_bits -= 8) {
+            m_out.push_back(static_cast<uint8_t>(m_buffer >> shift));
+        }
+        m_buffer = 0;
+        m_bits = 0;
+    }
+};
+
+/**
+ * Golomb-Rice decoder reading the bit stream produced by GolombRiceEncode.
+ * It decodes the unary part of the code by counting leading ones in a 64-bit
+ * word rather than reading one bit at a time.
+ */
+class GolombRiceDecoder {
+private:
+    Span<const uint8_t> m_data;
+    /// Next byte of m_data to be loaded into m_buffer.
+    size_t m_pos{0};
+
+    /// Bits loaded but not consumed yet, starting from the most significant
+    /// one.
+    uint64_t m_buffer{0};
+    /// Number of bits in m_buffer.
+    int m_bits{0};
+
+    void Refill() {
+        while (m_bits <= 56 && m_pos < m_data.size()) {
+            m_buffer |= uint64_t(m_data[m_pos++]) << (56 - m_bits);
+            m_bits += 8;
+        }
+    }
+
+    void Consume(int nbits) {
+        m_buffer = nbits < 64 ? m_buffer << nbits : 0;
+        m_bits -= nbits;
+    }
+
+    uint64_t Read(int nbits) {
+        uint64_t data = 0;
+        while (nbits > 0) {
+            Refill();
+            if (m_bits == 0) {
+                throw std::ios_base::failure(
+                    "GolombRiceDecoder::Read(): end of data");
+            }
+            const int bits = std::min(nbits, m_bits);
+            data = (bits < 64 ? data << bits : 0) | (m_buffer >> (64 - bits));
+            Consume(bits);
+            nbits -= bits;
+        }
+        return data;
+    }
+
+public:
+    explicit GolombRiceDecoder(Span<const uint8_t> data) : m_data(data) {}
+
+    uint64_t Decode(uint8_t P) {
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q = 0;
+        while (true) {
+            Refill();
+            if (m_bits == 0) {
+                throw std::ios_base::failure(
+                    "GolombRiceDecoder::Decode(): end of data");
+            }
+            const int ones = 64 - CountBits(~m_buffer);
+            if (ones < m_bits) {
+                q += ones;
+                Consume(ones + 1);
+                break;
+            }
+            q += m_bits;
+            Consume(m_bits);
+        }
+
+        return (q << P) + Read(P);
+    }
+
+    /**
+     * Number of bytes of the input the decoded codes span, the last one
+     * possibly being padding.
+     */
+    size_t GetBytesRead() const { return m_pos - m_bits / 8; }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
@@ -388,6 +388,11 @@ private:
         // ConsensusScriptChecks
         const uint32_t m_next_block_script_verify_flags;
         int m_sig_checks_standard;
+
+        // The sighash midstates, shared by the script checks and stored in the
+        // mempool entry so they are not computed again when the transaction
+        // is mined.
+        PrecomputedTransactionData m_precomputed_txdata;
     };
 
     // Run the policy checks on a given transaction, excluding any script
@@ -402,8 +407,7 @@ private:
     // result in the scriptcache. This should be done after
     // PolicyScriptChecks(). This requires that all inputs either be in our
     // utxo set or in the mempool.
-    bool ConsensusScriptChecks(const ATMPArgs &args, Workspace &ws,
-                               PrecomputedTransactionData &txdata)
+    bool ConsensusScriptChecks(const ATMPArgs &args, Workspace &ws)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
 
     // Try to add the transaction to the mempool, removing any conflicts first.
@@ -587,19 +591,25 @@ bool MemPoolAccept::PreChecks(ATMPArgs &args, Workspace &ws) {
             strprintf("%d < %d", nModifiedFees, ::minRelayTxFee.GetFee(nSize)));
     }
 
+    // Only compute the precomputed transaction data if we need to verify
+    // scripts (ie, other policy checks pass). We perform the inexpensive
+    // checks first and avoid hashing and signature verification unless those
+    // checks pass, to mitigate CPU exhaustion denial-of-service attacks.
+    ws.m_precomputed_txdata = PrecomputedTransactionData(tx);
+
     // Validate input scripts against standard script flags.
     const uint32_t scriptVerifyFlags =
         ws.m_next_block_script_verify_flags | STANDARD_SCRIPT_VERIFY_FLAGS;
-    PrecomputedTransactionData txdata(tx);
     if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false,
-                           txdata, ws.m_sig_checks_standard)) {
+                           ws.m_precomputed_txdata, ws.m_sig_checks_standard)) {
         // State filled in by CheckInputScripts
         return false;
     }
 
     entry.reset(new CTxMemPoolEntry(
         ptx, ws.m_base_fees, nAcceptTime, m_active_chainstate.m_chain.Height(),
-        fSpendsCoinbase, ws.m_sig_checks_standard, lp));
+        fSpendsCoinbase, ws.m_sig_checks_standard, lp,
+        ws.m_precomputed_txdata));
 
     unsigned int nVirtualSize = entry->GetTxVirtualSize();
 
@@ -626,8 +636,8 @@ bool MemPoolAccept::PreChecks(ATMPArgs &args, Workspace &ws) {
     return true;
 }
 
-bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs &args, Workspace &ws,
-                                          PrecomputedTransactionData &txdata) {
+bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs &args,
+                                          Workspace &ws) {
     const CTransaction &tx = *ws.m_ptx;
     const TxId &txid = tx.GetId();
     TxValidationState &state = ws.m_state;
@@ -646,7 +656,8 @@ bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs &args, Workspace &ws,
     int nSigChecksConsensus;
     if (!CheckInputsFromMempoolAndCache(
             tx, state, m_view, m_pool, ws.m_next_block_script_verify_flags,
-            txdata, nSigChecksConsensus, m_active_chainstate.CoinsTip())) {
+            ws.m_precomputed_txdata, nSigChecksConsensus,
+            m_active_chainstate.CoinsTip())) {
         // This can occur under some circumstances, if the node receives an
         // unrequested tx which is invalid due to new consensus rules not
         // being activated yet (during IBD).
@@ -709,13 +720,7 @@ MemPoolAccept::AcceptSingleTransaction(const CTransactionRef &ptx,
         return MempoolAcceptResult(ws.m_state);
     }
 
-    // Only compute the precomputed transaction data if we need to verify
-    // scripts (ie, other policy checks pass). We perform the inexpensive
-    // checks first and avoid hashing and signature verification unless those
-    // checks pass, to mitigate CPU exhaustion denial-of-service attacks.
-    PrecomputedTransactionData txdata(*ptx);
-
-    if (!ConsensusScriptChecks(args, ws, txdata)) {
+    if (!ConsensusScriptChecks(args, ws)) {
         return MempoolAcceptResult(ws.m_state);
     }
 
@@ -1895,19 +1900,27 @@ bool CChainState::ConnectBlock(const CBlock &block, BlockValidationState &state,
         // deferred into vChecks).
         int nSigChecksRet;
         TxValidationState tx_state;
-        if (fScriptChecks &&
-            !CheckInputScripts(tx, tx_state, view, flags, fCacheResults,
-                               fCacheResults, PrecomputedTransactionData(tx),
-                               nSigChecksRet, nSigChecksTxLimiters[txIndex],
-                               &nSigChecksBlockLimiter, &vChecks)) {
-            // Any transaction validation failure in ConnectBlock is a block
-            // consensus failure
-            state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
-                          tx_state.GetRejectReason(),
-                          tx_state.GetDebugMessage());
-            return error(
-                "ConnectBlock(): CheckInputScripts on %s failed with %s",
-                tx.GetId().ToString(), state.ToString());
+        if (fScriptChecks) {
+            // The sighash midstates of the transactions from our mempool were
+            // computed when they were accepted, don't hash them again.
+            PrecomputedTransactionData txdata;
+            if (!m_mempool.GetPrecomputedTxData(tx.GetId(), txdata)) {
+                txdata = PrecomputedTransactionData(tx);
+            }
+
+            if (!CheckInputScripts(tx, tx_state, view, flags, fCacheResults,
+                                   fCacheResults, txdata, nSigChecksRet,
+                                   nSigChecksTxLimiters[txIndex],
+                                   &nSigChecksBlockLimiter, &vChecks)) {
+                // Any transaction validation failure in ConnectBlock is a
+                // block consensus failure
+                state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
+                              tx_state.GetRejectReason(),
+                              tx_state.GetDebugMessage());
+                return error(
+                    "ConnectBlock(): CheckInputScripts on %s failed with %s",
+                    tx.GetId().ToString(), state.ToString());
+            }
         }
 
         control.Add(vChecks);
@@ -53,7 +53,8 @@ class AvalancheTest(BitcoinTestFramework):
         self.num_nodes = 1
         self.extra_args = [['-enableavalanche=1',
                             '-avaproofstakeutxoconfirmations=3',
-                            '-enableavalanchepeerdiscovery=1']]
+                            '-enableavalanchepeerdiscovery=1',
+                            '-persistavapeers=0']]
         self.supports_cli = False
 
     def run_test(self):
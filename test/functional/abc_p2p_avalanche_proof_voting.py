@@ -41,7 +41,7 @@ class AvalancheProofVotingTest(BitcoinTestFramework):
             ['-enableavalanche=1',
              '-enableavalancheproofreplacement=1',
              '-avaproofstakeutxoconfirmations=2',
-                f'-avalancheconflictingproofcooldown={self.conflicting_proof_cooldown}', f'-avalanchepeerreplacementcooldown={self.peer_replacement_cooldown}', '-avacooldown=0', '-avastalevotethreshold=140', '-avastalevotefactor=1'],
+                f'-avalancheconflictingproofcooldown={self.conflicting_proof_cooldown}', f'-avalanchepeerreplacementcooldown={self.peer_replacement_cooldown}', '-avacooldown=0', '-avastalevotethreshold=140', '-avastalevotefactor=1', '-persistavapeers=0'],
         ]
         self.supports_cli = False
 
@@ -321,7 +321,8 @@ class AvalancheProofVotingTest(BitcoinTestFramework):
                                          '-avaproofstakeutxoconfirmations=2',
                                          '-avacooldown=0',
                                          '-avalancheconflictingproofcooldown=0',
-                                         '-whitelist=noban@127.0.0.1', ])
+                                         '-whitelist=noban@127.0.0.1',
+                                         '-persistavapeers=0', ])
 
         self.get_quorum(node)
 
@@ -496,6 +497,7 @@ class AvalancheProofVotingTest(BitcoinTestFramework):
             '-avaproofstakeutxoconfirmations=2',
             '-avalancheconflictingproofcooldown=0',
             '-avacooldown=0',
+            '-persistavapeers=0',
         ])
 
         self.quorum = self.get_quorum(node)
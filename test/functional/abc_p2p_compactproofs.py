@@ -57,6 +57,7 @@ class CompactProofsTest(BitcoinTestFramework):
             '-avaproofstakeutxoconfirmations=1',
             '-avacooldown=0',
             '-enableavalanchepeerdiscovery=1',
+            '-persistavapeers=0',
         ]] * self.num_nodes
 
     def setup_network(self):
@@ -87,7 +87,8 @@ class AvaAddrTest(BitcoinTestFramework):
         self.extra_args = [['-enableavalanche=1',
                             '-enableavalanchepeerdiscovery=1',
                             '-avaproofstakeutxoconfirmations=1',
-                            '-avacooldown=0', '-whitelist=noban@127.0.0.1']]
+                            '-avacooldown=0', '-whitelist=noban@127.0.0.1',
+                            '-persistavapeers=0']]
 
     def check_all_peers_received_getavaaddr_once(self, avapeers):
         def received_all_getavaaddr(avapeers):
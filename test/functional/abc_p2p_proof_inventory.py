@@ -51,6 +51,7 @@ class ProofInventoryTest(BitcoinTestFramework):
             '-avaproofstakeutxoconfirmations=2',
             '-avacooldown=0',
             '-whitelist=noban@127.0.0.1',
+            '-persistavapeers=0',
         ]] * self.num_nodes
 
     def generate_proof(self, node, mature=True):
@@ -129,7 +130,7 @@ class ProofInventoryTest(BitcoinTestFramework):
         _, bad_proof = self.generate_proof(node)
         bad_proof.stakes = []
 
-        self.restart_node(0, ['-enableavalanche=1'])
+        self.restart_node(0, ['-enableavalanche=1', '-persistavapeers=0'])
 
         peer = node.add_p2p_connection(P2PInterface())
 
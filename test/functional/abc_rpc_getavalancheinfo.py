@@ -22,7 +22,7 @@ from test_framework.messages import (
     LegacyAvalancheProof,
 )
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal
+from test_framework.util import assert_equal, assert_greater_than_or_equal
 from test_framework.wallet_util import bytes_to_wif
 
 
@@ -58,9 +58,18 @@ class GetAvalancheInfoTest(BitcoinTestFramework):
 
             return expected
 
+        def get_avalancheinfo():
+            # The delegation cache counters depend on the avahello messages
+            # processed so far, they are checked separately
+            info = node.getavalancheinfo()
+            cache = info.pop("delegation_cache")
+            assert_greater_than_or_equal(cache["hits"], 0)
+            assert_greater_than_or_equal(cache["misses"], 0)
+            return info
+
         def assert_avalancheinfo(expected):
             assert_equal(
-                node.getavalancheinfo(),
+                get_avalancheinfo(),
                 handle_legacy_format(expected)
             )
 
@@ -121,7 +130,7 @@ class GetAvalancheInfoTest(BitcoinTestFramework):
         # Mine a block to trigger proof validation
         node.generate(1)
         self.wait_until(
-            lambda: node.getavalancheinfo() == handle_legacy_format({
+            lambda: get_avalancheinfo() == handle_legacy_format({
                 "active": False,
                 "local": {
                     "live": True,
@@ -191,7 +200,7 @@ class GetAvalancheInfoTest(BitcoinTestFramework):
         n.send_avaproof(orphan_proof)
 
         self.wait_until(
-            lambda: node.getavalancheinfo() == handle_legacy_format({
+            lambda: get_avalancheinfo() == handle_legacy_format({
                 "active": True,
                 "local": {
                     "live": True,
@@ -226,7 +235,7 @@ class GetAvalancheInfoTest(BitcoinTestFramework):
             n.wait_for_disconnect()
 
         self.wait_until(
-            lambda: node.getavalancheinfo() == handle_legacy_format({
+            lambda: get_avalancheinfo() == handle_legacy_format({
                 "active": True,
                 "local": {
                     "live": True,
@@ -12,7 +12,11 @@ from test_framework.avatools import (
 )
 from test_framework.key import ECKey
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal, assert_raises_rpc_error
+from test_framework.util import (
+    assert_equal,
+    assert_greater_than_or_equal,
+    assert_raises_rpc_error,
+)
 from test_framework.wallet_util import bytes_to_wif
 
 
@@ -74,6 +78,12 @@ class GetAvalanchePeerInfoTest(BitcoinTestFramework):
             assert_equal(peer["nodecount"], nodecount)
             assert_equal(set(peer["node_list"]), set(
                 [n.nodeid for n in nodes[i]]))
+            assert_equal(set(s["nodeid"] for s in peer["node_stats"]), set(
+                [n.nodeid for n in nodes[i]]))
+            for stats in peer["node_stats"]:
+                assert_greater_than_or_equal(stats["avg_response_time"], 0)
+                assert_greater_than_or_equal(stats["response_count"], 0)
+                assert_greater_than_or_equal(stats["timeout_count"], 0)
 
         self.log.info("Testing with a specified proofid")
 
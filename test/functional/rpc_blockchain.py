@@ -63,6 +63,7 @@ class BlockchainTest(BitcoinTestFramework):
         self._test_getblockheader()
         self._test_getdifficulty()
         self._test_getnetworkhashps()
+        self._test_getvalidationcacheinfo()
         self._test_stopatheight()
         self._test_waitforblockheight()
         if self.is_wallet_compiled():
@@ -353,6 +354,16 @@ class BlockchainTest(BitcoinTestFramework):
         # This should be 2 hashes every 10 minutes or 1/300
         assert abs(hashes_per_second * 300 - 1) < 0.0001
 
+    def _test_getvalidationcacheinfo(self):
+        self.log.info("Test getvalidationcacheinfo")
+        info = self.nodes[0].getvalidationcacheinfo()
+        for cache in ['signature_cache', 'script_cache']:
+            assert_equal(sorted(info[cache].keys()),
+                         ['evictions', 'hits', 'misses'])
+            for value in info[cache].values():
+                assert isinstance(value, int)
+                assert_greater_than_or_equal(value, 0)
+
     def _test_stopatheight(self):
         assert_equal(self.nodes[0].getblockcount(), 200)
         self.nodes[0].generatetoaddress(